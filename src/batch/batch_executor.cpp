@@ -0,0 +1,243 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "batch_executor.h"
+#include "headless_runner.h"
+
+#include <scgms/lang/dstrings.h>
+
+CBatch_Executor::CBatch_Executor(std::vector<TBatch_Job> jobs, const size_t thread_count)
+	: mJobs(std::move(jobs)), mPool(thread_count), mProgress(mJobs.size()), mRunners(mJobs.size(), nullptr) {
+	//
+}
+
+CBatch_Executor::~CBatch_Executor() {
+	Cancel();
+
+	for (auto& result : mResults) {
+		if (result.valid())
+			result.wait();
+	}
+}
+
+std::vector<TBatch_Job> CBatch_Executor::Expand_Jobs(const std::vector<filesystem::path>& setups, const std::vector<int64_t>& subject_ids,
+	const std::vector<int64_t>& segment_ids, const filesystem::path& output_root) {
+
+	std::vector<TBatch_Job> jobs;
+
+	// empty override list means "keep what the setup says"
+	std::vector<std::optional<int64_t>> subjects{ subject_ids.begin(), subject_ids.end() };
+	if (subjects.empty())
+		subjects.push_back(std::nullopt);
+
+	std::vector<std::optional<int64_t>> segments{ segment_ids.begin(), segment_ids.end() };
+	if (segments.empty())
+		segments.push_back(std::nullopt);
+
+	for (size_t i = 0; i < setups.size(); i++) {
+		for (const auto& subject : subjects) {
+			for (const auto& segment : segments) {
+				TBatch_Job job;
+				job.setup_path = setups[i];
+				job.subject_id = subject;
+				job.segment_id = segment;
+
+				// index prefix keeps the directories distinct even for setups of the same name
+				std::wstring dir_name = std::to_wstring(i) + L"_" + setups[i].stem().wstring();
+				if (subject)
+					dir_name += L"_subject_" + std::to_wstring(*subject);
+				if (segment)
+					dir_name += L"_segment_" + std::to_wstring(*segment);
+
+				job.output_dir = output_root / dir_name;
+
+				jobs.push_back(std::move(job));
+			}
+		}
+	}
+
+	return jobs;
+}
+
+HRESULT CBatch_Executor::Apply_Overrides(scgms::SPersistent_Filter_Chain_Configuration& configuration, const TBatch_Job& job, refcnt::Swstr_list errors) {
+	if (!job.subject_id && !job.segment_id)
+		return S_OK;
+
+	HRESULT rc = S_OK;
+	bool segment_applied = false;
+
+	configuration.for_each([&job, &rc, &segment_applied](scgms::SFilter_Configuration_Link link) {
+		link.for_each([&job, &rc, &segment_applied](scgms::SFilter_Parameter parameter) {
+			if (rc != S_OK)
+				return;
+
+			if (job.subject_id && parameter.type() == scgms::NParameter_Type::ptSubject_Id)
+				rc = parameter->Set_Int64(*job.subject_id);
+			else if (job.segment_id && parameter.type() == scgms::NParameter_Type::ptInt64_Array) {
+				// other integer arrays of the chain are not segment selections, so only the input filter's one is overridden
+				const std::wstring name{ parameter.configuration_name() };	//converts from wchar_t*!
+				if (name == rsTime_Segment_ID) {
+					rc = parameter.set_int_array(std::vector<int64_t>{ *job.segment_id });
+					segment_applied = true;
+				}
+			}
+		});
+	});
+
+	if (rc != S_OK)
+		errors.push(L"Cannot apply subject or segment override to " + job.setup_path.wstring());
+	else if (job.segment_id && !segment_applied) {
+		// running the whole input instead of the requested segment would silently produce wrong results
+		errors.push(L"No filter of " + job.setup_path.wstring() + L" selects time segments, cannot apply segment override");
+		rc = E_INVALIDARG;
+	}
+
+	return rc;
+}
+
+void CBatch_Executor::Start() {
+	for (size_t i = 0; i < mJobs.size(); i++)
+		mResults.push_back(mPool.Submit([this, i]() { Run_Job(i); }));
+}
+
+void CBatch_Executor::Run_Job(const size_t index) {
+	const TBatch_Job& job = mJobs[index];
+
+	if (mCancel_Requested) {
+		std::unique_lock<std::mutex> lck(mProgress_Mtx);
+		mProgress[index].state = NBatch_Job_State::Cancelled;
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lck(mProgress_Mtx);
+		mProgress[index].state = NBatch_Job_State::Running;
+	}
+
+	refcnt::Swstr_list errors;
+	// every job loads its own configuration, so the chains share no filter instance at all
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	HRESULT rc = CHeadless_Runner::Load_Experimental_Setup(job.setup_path, configuration, errors);
+	if (rc == S_OK)
+		rc = Apply_Overrides(configuration, job, errors);
+
+	size_t event_count = 0;
+	double device_time = 0.0;
+
+	if (rc == S_OK) {
+		CHeadless_Runner runner{ configuration.get(), job.output_dir };
+
+		{
+			std::unique_lock<std::mutex> lck(mProgress_Mtx);
+			mRunners[index] = &runner;
+		}
+
+		// cancel might have come while the configuration was being loaded
+		if (mCancel_Requested)
+			runner.Cancel();
+
+		rc = runner.Run(errors);
+
+		{
+			std::unique_lock<std::mutex> lck(mProgress_Mtx);
+			mRunners[index] = nullptr;
+		}
+
+		event_count = runner.Get_Event_Count();
+		device_time = runner.Get_Device_Time();
+	}
+
+	std::wstring message;
+	errors.for_each([&message](auto str) {
+		if (!message.empty())
+			message += L"; ";
+		message += str;
+	});
+
+	std::unique_lock<std::mutex> lck(mProgress_Mtx);
+	auto& progress = mProgress[index];
+	progress.event_count = event_count;
+	progress.device_time = device_time;
+	progress.message = message;
+	if (rc == S_OK)
+		progress.state = NBatch_Job_State::Succeeded;
+	else if (rc == E_ABORT)
+		progress.state = NBatch_Job_State::Cancelled;
+	else
+		progress.state = NBatch_Job_State::Failed;
+}
+
+void CBatch_Executor::Cancel() {
+	mCancel_Requested = true;
+
+	std::unique_lock<std::mutex> lck(mProgress_Mtx);
+	for (auto runner : mRunners) {
+		if (runner)
+			runner->Cancel();
+	}
+}
+
+bool CBatch_Executor::Is_Finished() const {
+	std::unique_lock<std::mutex> lck(mProgress_Mtx);
+	for (const auto& progress : mProgress) {
+		if (progress.state == NBatch_Job_State::Queued || progress.state == NBatch_Job_State::Running)
+			return false;
+	}
+
+	return true;
+}
+
+size_t CBatch_Executor::Thread_Count() const {
+	return mPool.Thread_Count();
+}
+
+const std::vector<TBatch_Job>& CBatch_Executor::Get_Jobs() const {
+	return mJobs;
+}
+
+std::vector<TBatch_Job_Progress> CBatch_Executor::Get_Progress() const {
+	std::unique_lock<std::mutex> lck(mProgress_Mtx);
+
+	std::vector<TBatch_Job_Progress> result = mProgress;
+	for (size_t i = 0; i < mRunners.size(); i++) {
+		if (mRunners[i]) {
+			result[i].event_count = mRunners[i]->Get_Event_Count();
+			result[i].device_time = mRunners[i]->Get_Device_Time();
+		}
+	}
+
+	return result;
+}
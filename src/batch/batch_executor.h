@@ -0,0 +1,116 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/FilesystemLib.h>
+
+#include "../utils/thread_pool.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+class CHeadless_Runner;
+
+/*
+ * Single run of a batch - one experimental setup, optionally with a subject or a time segment forced into the configuration
+ */
+struct TBatch_Job {
+	filesystem::path setup_path;
+	std::optional<int64_t> subject_id;
+	std::optional<int64_t> segment_id;
+	filesystem::path output_dir;
+};
+
+enum class NBatch_Job_State {
+	Queued,
+	Running,
+	Succeeded,
+	Failed,
+	Cancelled
+};
+
+struct TBatch_Job_Progress {
+	NBatch_Job_State state = NBatch_Job_State::Queued;
+	size_t event_count = 0;
+	double device_time = 0.0;
+	std::wstring message;
+};
+
+/*
+ * Runs a set of independent filter chains concurrently, one chain per pool thread
+ */
+class CBatch_Executor {
+	protected:
+		const std::vector<TBatch_Job> mJobs;
+		CThread_Pool mPool;
+		std::vector<std::future<void>> mResults;
+
+		// guards mProgress and mRunners
+		mutable std::mutex mProgress_Mtx;
+		std::vector<TBatch_Job_Progress> mProgress;
+		// runner of each job while it is running, nullptr otherwise
+		std::vector<CHeadless_Runner*> mRunners;
+
+		std::atomic<bool> mCancel_Requested{ false };
+
+		void Run_Job(const size_t index);
+		static HRESULT Apply_Overrides(scgms::SPersistent_Filter_Chain_Configuration& configuration, const TBatch_Job& job, refcnt::Swstr_list errors);
+
+	public:
+		// thread_count of zero uses one thread per core
+		CBatch_Executor(std::vector<TBatch_Job> jobs, const size_t thread_count = 0);
+		virtual ~CBatch_Executor();
+
+		// builds job list: every setup as is, or the only setup once per each subject and/or segment ID
+		static std::vector<TBatch_Job> Expand_Jobs(const std::vector<filesystem::path>& setups, const std::vector<int64_t>& subject_ids,
+			const std::vector<int64_t>& segment_ids, const filesystem::path& output_root);
+
+		void Start();
+		void Cancel();
+		bool Is_Finished() const;
+		size_t Thread_Count() const;
+
+		const std::vector<TBatch_Job>& Get_Jobs() const;
+		// snapshot of progress of all the jobs, including live counters of running ones
+		std::vector<TBatch_Job_Progress> Get_Progress() const;
+};
@@ -0,0 +1,242 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "chain_objective.h"
+#include "configuration_utils.h"
+#include "headless_runner.h"
+#include "../utils/thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+
+// fitness of a candidate the chain could not be evaluated with, worse than any real one
+constexpr double Failed_Evaluation_Fitness = std::numeric_limits<double>::max();
+
+namespace {
+	// dedicated pool, as the solver threads block on the evaluations, which replay whole chains - no short task belongs here
+	CThread_Pool& Evaluation_Pool() {
+		static CThread_Pool pool;
+		return pool;
+	}
+}
+
+CChain_Objective::CChain_Objective(scgms::SFilter_Chain_Configuration configuration, std::vector<size_t> filter_indices, std::vector<std::wstring> parameter_names, CFitness_Cache& cache)
+	: mConfiguration(configuration), mFilter_Indices(std::move(filter_indices)), mParameter_Names(std::move(parameter_names)),
+	mCache(cache), mProblem_Hash(CFitness_Cache::Hash_Problem(mParameter_Names)) {
+	//
+}
+
+HRESULT CChain_Objective::Read_Parameters() {
+	mParameter_Sizes.clear();
+	mLower_Bound.clear();
+	mUpper_Bound.clear();
+	mCurrent.clear();
+
+	for (size_t i = 0; i < mFilter_Indices.size(); i++) {
+		scgms::SFilter_Parameter parameter = Find_Filter_Parameter(mConfiguration, mFilter_Indices[i], mParameter_Names[i].c_str());
+		if (!parameter)
+			return E_INVALIDARG;
+
+		HRESULT rc;
+		const std::vector<double> values = parameter.as_double_array(rc);
+		if (rc != S_OK)
+			return rc;
+		if (values.size() % 3 != 0)
+			return E_INVALIDARG;
+
+		// lower bounds, current values and upper bounds, one third each
+		const size_t count = values.size() / 3;
+		mParameter_Sizes.push_back(count);
+		mLower_Bound.insert(mLower_Bound.end(), values.begin(), values.begin() + count);
+		mCurrent.insert(mCurrent.end(), values.begin() + count, values.begin() + 2 * count);
+		mUpper_Bound.insert(mUpper_Bound.end(), values.begin() + 2 * count, values.end());
+	}
+
+	return S_OK;
+}
+
+HRESULT CChain_Objective::Write_Parameters(scgms::SFilter_Chain_Configuration configuration, const double* solution) const {
+	size_t offset = 0;
+
+	for (size_t i = 0; i < mFilter_Indices.size(); i++) {
+		scgms::SFilter_Parameter parameter = Find_Filter_Parameter(configuration, mFilter_Indices[i], mParameter_Names[i].c_str());
+		if (!parameter)
+			return E_INVALIDARG;
+
+		const size_t count = mParameter_Sizes[i];
+		std::vector<double> values;
+		values.insert(values.end(), mLower_Bound.begin() + offset, mLower_Bound.begin() + offset + count);
+		values.insert(values.end(), solution + offset, solution + offset + count);
+		values.insert(values.end(), mUpper_Bound.begin() + offset, mUpper_Bound.begin() + offset + count);
+
+		const HRESULT rc = parameter.set_double_array(values);
+		if (rc != S_OK)
+			return rc;
+
+		offset += count;
+	}
+
+	return S_OK;
+}
+
+HRESULT CChain_Objective::Replay(const double* solution, std::vector<double>& metrics, refcnt::Swstr_list errors) const {
+	metrics.clear();
+
+	// every replay runs on its own copy, as the solver evaluates the candidates concurrently
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	HRESULT rc = Clone_Configuration(mConfiguration, configuration);
+	if (rc == S_OK)
+		rc = Write_Parameters(configuration, solution);
+	if (rc != S_OK)
+		return rc;
+
+	// no output directory - the runner stores nothing, it just keeps the error metrics
+	CHeadless_Runner runner{ configuration.get(), filesystem::path{} };
+	if (mProgress)
+		runner.Set_Cancel_Flag(&mProgress->cancelled);
+	rc = runner.Run(errors);
+	if (rc != S_OK)
+		return rc;
+
+	metrics = runner.Get_Metrics();
+
+	return metrics.empty() ? E_FAIL : S_OK;
+}
+
+HRESULT CChain_Objective::Evaluate(const double* solution, solver::TFitness& fitness) const {
+	const CFitness_Cache::TKey key = CFitness_Cache::Make_Key(mProblem_Hash, solution, mLower_Bound.data(), mUpper_Bound.data(), mCurrent.size());
+	if (mCache.Lookup(key, fitness))
+		return S_OK;
+
+	fitness = solver::Nan_Fitness;
+	for (size_t i = 0; i < mObjectives_Count; i++)
+		fitness[i] = Failed_Evaluation_Fitness;
+
+	// a candidate the chain fails with is just a bad one, the errors of the individual evaluations are not reported
+	std::vector<double> metrics;
+	const HRESULT rc = Replay(solution, metrics, refcnt::Swstr_list{});
+	for (size_t i = 0; i < std::min(metrics.size(), mObjectives_Count); i++) {
+		// a filter with no metric keeps the failed fitness, NaN would mislead the solver
+		if (std::isfinite(metrics[i]))
+			fitness[i] = metrics[i];
+	}
+
+	// a failed evaluation would fail again, so it is memoized as well; only a cancelled one is not
+	if (rc != E_ABORT)
+		mCache.Store(key, fitness);
+
+	return rc;
+}
+
+BOOL IfaceCalling CChain_Objective::Objective(const void* data, const size_t solution_count, const double* solutions, double* const fitnesses) {
+	CChain_Objective* objective = static_cast<CChain_Objective*>(const_cast<void*>(data));
+	const size_t problem_size = objective->mCurrent.size();
+	objective->mEvaluations += solution_count;
+
+	// every candidate looks into the cache and replays its own copy of the chain, so they are evaluated side by side;
+	// the caller is a solver thread, never a worker of the pool, so it may just wait
+	auto& pool = Evaluation_Pool();
+	std::vector<std::future<void>> done;
+	done.reserve(solution_count);
+	for (size_t i = 0; i < solution_count; i++) {
+		done.push_back(pool.Submit([objective, solutions, fitnesses, problem_size, i]() {
+			solver::TFitness fitness;
+			objective->Evaluate(solutions + i * problem_size, fitness);
+			std::copy(fitness.begin(), fitness.end(), fitnesses + i * solver::Maximum_Objectives_Count);
+		}));
+	}
+
+	for (auto& evaluated : done)
+		evaluated.wait();
+
+	return TRUE;
+}
+
+HRESULT CChain_Objective::Optimize(const GUID& solver_id, const size_t population_size, const size_t max_generations, const double** hints, const size_t hint_count,
+	solver::TSolver_Progress& progress, refcnt::Swstr_list errors) {
+
+	HRESULT rc = Read_Parameters();
+	if (rc != S_OK) {
+		errors.push(L"Cannot read the parameters to optimize");
+		return rc;
+	}
+
+	mProgress = &progress;
+
+	// the current values tell how many objectives the chain has, and their fitness goes to the cache right away
+	std::vector<double> metrics;
+	rc = Replay(mCurrent.data(), metrics, errors);
+	if (rc != S_OK) {
+		mProgress = nullptr;
+		if (rc != E_ABORT)
+			errors.push(L"Cannot evaluate the chain with the current parameters");
+		return rc;
+	}
+
+	mObjectives_Count = std::min(metrics.size(), solver::Maximum_Objectives_Count);
+
+	solver::TFitness current_fitness = solver::Nan_Fitness;
+	std::copy(metrics.begin(), metrics.begin() + mObjectives_Count, current_fitness.begin());
+	mCache.Store(CFitness_Cache::Make_Key(mProblem_Hash, mCurrent.data(), mLower_Bound.data(), mUpper_Bound.data(), mCurrent.size()), current_fitness);
+
+	std::vector<const double*> all_hints{ hints, hints + hint_count };
+	all_hints.push_back(mCurrent.data());
+
+	std::vector<double> solution = mCurrent;
+
+	solver::TSolver_Setup setup{
+		mCurrent.size(), mObjectives_Count,
+		mLower_Bound.data(), mUpper_Bound.data(),
+		all_hints.data(), all_hints.size(),
+		solution.data(),
+		this, CChain_Objective::Objective,
+		max_generations, population_size,
+		std::numeric_limits<double>::min()
+	};
+
+	rc = scgms::Solve_Generic(&solver_id, &setup, &progress);
+	mProgress = nullptr;
+	if (rc == S_OK)
+		rc = Write_Parameters(mConfiguration, solution.data());
+
+	return rc;
+}
+
+size_t CChain_Objective::Evaluations() const {
+	return mEvaluations;
+}
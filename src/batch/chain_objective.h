@@ -0,0 +1,86 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/SolverLib.h>
+
+#include "../utils/fitness_cache.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+/*
+ * Objective of parameter optimization evaluated by the desktop itself, so that evaluations can be memoized
+ * Every evaluation not found in the fitness cache replays a copy of the chain headless with the candidate parameters;
+ * the objectives are the metrics configured on the signal error filters, in the order they appear in the chain - the same ones scgms::Optimize_Parameters uses
+ */
+class CChain_Objective {
+	protected:
+		scgms::SFilter_Chain_Configuration mConfiguration;
+		const std::vector<size_t> mFilter_Indices;
+		const std::vector<std::wstring> mParameter_Names;
+		CFitness_Cache& mCache;
+		const uint64_t mProblem_Hash;
+
+		// the solution vector is the concatenation of the current values (the middle third) of all the parameters
+		std::vector<size_t> mParameter_Sizes;
+		std::vector<double> mLower_Bound, mUpper_Bound, mCurrent;
+		size_t mObjectives_Count = 1;
+		// candidates the solver asked to evaluate, whether they were found in the cache or not
+		std::atomic<size_t> mEvaluations{ 0 };
+		// progress of the running optimization; its cancel flag cancels the replays in flight as well
+		const solver::TSolver_Progress* mProgress = nullptr;
+
+		HRESULT Read_Parameters();
+		HRESULT Write_Parameters(scgms::SFilter_Chain_Configuration configuration, const double* solution) const;
+		// runs a copy of the chain with given solution; the configured metric of every signal error filter
+		HRESULT Replay(const double* solution, std::vector<double>& metrics, refcnt::Swstr_list errors) const;
+		// fitness from the cache, or from a replay; may run for more candidates at once
+		HRESULT Evaluate(const double* solution, solver::TFitness& fitness) const;
+		static BOOL IfaceCalling Objective(const void* data, const size_t solution_count, const double* solutions, double* const fitnesses);
+
+	public:
+		CChain_Objective(scgms::SFilter_Chain_Configuration configuration, std::vector<size_t> filter_indices, std::vector<std::wstring> parameter_names, CFitness_Cache& cache);
+
+		// the same contract as scgms::Optimize_Parameters - the best solution found is written to the configuration
+		HRESULT Optimize(const GUID& solver_id, const size_t population_size, const size_t max_generations, const double** hints, const size_t hint_count,
+			solver::TSolver_Progress& progress, refcnt::Swstr_list errors);
+
+		size_t Evaluations() const;
+};
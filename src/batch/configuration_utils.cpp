@@ -0,0 +1,89 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "configuration_utils.h"
+
+HRESULT Clone_Configuration(scgms::SFilter_Chain_Configuration source, scgms::SPersistent_Filter_Chain_Configuration& clone) {
+	clone = scgms::SPersistent_Filter_Chain_Configuration{};
+	if (!clone)
+		return E_FAIL;
+
+	HRESULT rc = S_OK;
+	source.for_each([&clone, &rc](scgms::SFilter_Configuration_Link link) {
+		if (rc != S_OK)
+			return;
+
+		scgms::SFilter_Configuration_Link cloned_link = clone.Add_Link(link.descriptor().id);
+		if (!cloned_link) {
+			rc = E_FAIL;
+			return;
+		}
+
+		// the new link may come with default parameters; replace them with deep copies of the configured ones
+		while (cloned_link->empty() != S_OK)
+			cloned_link->remove(0);
+
+		link.for_each([&cloned_link, &rc](scgms::SFilter_Parameter parameter) {
+			if (rc != S_OK)
+				return;
+
+			scgms::IFilter_Parameter* copy = nullptr;
+			rc = parameter->Clone(&copy);
+			// the link takes over the reference of the copy
+			if (rc == S_OK)
+				rc = cloned_link->add(&copy, &copy + 1);
+		});
+	});
+
+	return rc;
+}
+
+scgms::SFilter_Parameter Find_Filter_Parameter(scgms::SFilter_Chain_Configuration configuration, const size_t filter_index, const wchar_t* name) {
+	scgms::SFilter_Parameter result;
+
+	size_t index = 0;
+	configuration.for_each([&](scgms::SFilter_Configuration_Link link) {
+		if (index++ != filter_index)
+			return;
+
+		link.for_each([&](scgms::SFilter_Parameter parameter) {
+			if (!result && parameter.configuration_name() == name)
+				result = parameter;
+		});
+	});
+
+	return result;
+}
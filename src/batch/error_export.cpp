@@ -0,0 +1,235 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "error_export.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace {
+	constexpr char Columnar_Magic[8] = { 'S', 'C', 'G', 'M', 'S', 'E', 'R', 'R' };
+	constexpr uint32_t Columnar_Version = 1;
+	constexpr uint32_t Block_Marker = 0x4B4C4245;	// "EBLK"
+
+	// flush threshold of the CSV buffer
+	constexpr size_t CSV_Buffer_Size = 1 << 20;
+
+	void Append_Number(std::string& out, const double value) {
+		// non-finite values are left empty, as the errors tab displays them
+		if (!std::isfinite(value))
+			return;
+
+		char buffer[32];
+		const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		out.append(buffer, result.ptr);
+	}
+
+	void Append_Integer(std::string& out, const uint64_t value) {
+		char buffer[24];
+		const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		out.append(buffer, result.ptr);
+	}
+
+	void Append_Field(std::string& out, const std::string& value) {
+		// quote only when needed, so that common values stay plain
+		if (value.find_first_of(";\"\n") == std::string::npos) {
+			out += value;
+			return;
+		}
+
+		out += '"';
+		for (const char c : value) {
+			if (c == '"')
+				out += '"';
+			out += c;
+		}
+		out += '"';
+	}
+
+	template <typename T>
+	void Put(std::string& out, const T value) {
+		static_assert(std::is_trivially_copyable<T>::value, "only plain values can be stored");
+		// the format is little-endian, which is the native order of all the supported platforms
+		out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void Put_String(std::string& out, const std::string& value) {
+		Put<uint32_t>(out, static_cast<uint32_t>(value.size()));
+		out += value;
+	}
+
+	// true if the file starts with the header of the columnar format of this version
+	bool Has_Columnar_Header(const filesystem::path& path) {
+		std::ifstream fs(path, std::ios::binary);
+		char magic[sizeof(Columnar_Magic)];
+		uint32_t version = 0;
+		if (!fs.read(magic, sizeof(magic)) || !fs.read(reinterpret_cast<char*>(&version), sizeof(version)))
+			return false;
+
+		return std::memcmp(magic, Columnar_Magic, sizeof(Columnar_Magic)) == 0 && version == Columnar_Version;
+	}
+
+	// numeric columns of TSignal_Stats, in the order they are stored
+	constexpr size_t Scalar_Column_Count = 6;
+
+	std::array<double, Scalar_Column_Count> Scalar_Columns(const scgms::TSignal_Stats& stats) {
+		return { stats.avg, stats.stddev, stats.exc_kurtosis, stats.skewness, stats.sum, static_cast<double>(stats.count) };
+	}
+}
+
+double Relative_Error_Range(const scgms::TSignal_Stats& rel_error, const double threshold) {
+	if (rel_error.count == 0)
+		return std::numeric_limits<double>::quiet_NaN();
+
+	const auto& ecdf = rel_error.ecdf;
+	const auto found = std::lower_bound(std::begin(ecdf), std::end(ecdf), threshold);
+	if (found == std::end(ecdf))
+		return 1.0;	//100% relative
+
+	return 0.01 * static_cast<double>(std::distance(std::begin(ecdf), found));
+}
+
+bool CError_Export::Write_CSV(const filesystem::path& path, const std::vector<TError_Record>& records) {
+	std::ofstream fs(path, std::ios::binary);
+	if (!fs.is_open())
+		return false;
+
+	std::string buffer;
+	buffer.reserve(CSV_Buffer_Size + 4096);
+	buffer = "run;description;segment;type;average;stddev;exc_kurtosis;skewness;sum;count;min;p25;median;p75;p95;p99;max;r5;r10;r25;r50\n";
+
+	for (const auto& record : records) {
+		const auto& stats = record.stats;
+
+		Append_Field(buffer, record.run);
+		buffer += ';';
+		Append_Field(buffer, record.description);
+		buffer += ';';
+		if (record.segment_id != scgms::All_Segments_Id)
+			Append_Integer(buffer, record.segment_id);
+		buffer += ';';
+		buffer += record.relative ? "relative" : "absolute";
+
+		for (const double value : Scalar_Columns(stats)) {
+			buffer += ';';
+			Append_Number(buffer, value);
+		}
+
+		for (const auto ecdf_index : { scgms::NECDF::min_value, scgms::NECDF::p25, scgms::NECDF::median, scgms::NECDF::p75,
+			scgms::NECDF::p95, scgms::NECDF::p99, scgms::NECDF::max_value }) {
+			buffer += ';';
+			Append_Number(buffer, stats.ecdf[ecdf_index]);
+		}
+
+		// the ranges are defined for relative errors only, so they stay empty in absolute records
+		for (const double threshold : { 0.05, 0.1, 0.25, 0.5 }) {
+			buffer += ';';
+			if (record.relative)
+				Append_Number(buffer, Relative_Error_Range(stats, threshold));
+		}
+
+		buffer += '\n';
+
+		if (buffer.size() >= CSV_Buffer_Size) {
+			fs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	}
+
+	fs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	fs.close();
+
+	return !fs.fail();
+}
+
+bool CError_Export::Append_Columnar(const filesystem::path& path, const std::vector<TError_Record>& records) {
+	std::error_code ec;
+	const bool exists = filesystem::exists(path, ec) && filesystem::file_size(path, ec) > 0;
+
+	std::string block;
+
+	if (!exists) {
+		block.append(Columnar_Magic, sizeof(Columnar_Magic));
+		Put<uint32_t>(block, Columnar_Version);
+	}
+	else if (!Has_Columnar_Header(path)) {
+		// appending blocks to another file (or another version of the format) would just corrupt it
+		return false;
+	}
+
+	const uint32_t row_count = static_cast<uint32_t>(records.size());
+	const uint32_t ecdf_count = records.empty() ? 0 : static_cast<uint32_t>(std::size(records.front().stats.ecdf));
+
+	Put<uint32_t>(block, Block_Marker);
+	Put<uint32_t>(block, row_count);
+	Put<uint32_t>(block, static_cast<uint32_t>(Scalar_Column_Count));
+	Put<uint32_t>(block, ecdf_count);
+
+	for (const auto& record : records)
+		Put_String(block, record.run);
+	for (const auto& record : records)
+		Put_String(block, record.description);
+	for (const auto& record : records)
+		Put<uint64_t>(block, record.segment_id);
+	for (const auto& record : records)
+		Put<uint8_t>(block, record.relative ? 1 : 0);
+
+	for (size_t column = 0; column < Scalar_Column_Count; column++) {
+		for (const auto& record : records)
+			Put<double>(block, Scalar_Columns(record.stats)[column]);
+	}
+
+	for (uint32_t column = 0; column < ecdf_count; column++) {
+		for (const auto& record : records)
+			Put<double>(block, record.stats.ecdf[column]);
+	}
+
+	std::ofstream fs(path, std::ios::binary | std::ios::app);
+	if (!fs.is_open())
+		return false;
+
+	fs.write(block.data(), static_cast<std::streamsize>(block.size()));
+	fs.close();
+
+	return !fs.fail();
+}
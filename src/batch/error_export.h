@@ -0,0 +1,74 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/FilesystemLib.h>
+
+#include <string>
+#include <vector>
+
+/*
+ * Error statistics of one signal, in one segment (or all of them) of one run
+ */
+struct TError_Record {
+	// identification of the run the statistics come from (e.g.; experimental setup and time)
+	std::string run;
+	std::string description;
+	uint64_t segment_id = scgms::All_Segments_Id;
+	bool relative = false;
+	scgms::TSignal_Stats stats;
+};
+
+// fraction of the ECDF points (0..1) whose relative error stays below threshold, as the "Range" columns of the errors tab show it;
+// NaN for stats with no values
+double Relative_Error_Range(const scgms::TSignal_Stats& rel_error, const double threshold);
+
+/*
+ * Writes error statistics straight from TSignal_Stats, without formatting them through a table model
+ *
+ * CSV is written through a large buffer with locale-independent, round-trip number formatting.
+ * The columnar format is a sequence of blocks, each appended by one call: a header, then every column stored
+ * contiguously (strings length-prefixed UTF-8, numbers as little-endian doubles/integers). Appending needs
+ * no rewrite of the existing blocks, so one file can collect the statistics of any number of runs.
+ */
+class CError_Export {
+	public:
+		static bool Write_CSV(const filesystem::path& path, const std::vector<TError_Record>& records);
+		// creates the file if it does not exist yet; fails if an existing file is not a columnar file of this version
+		static bool Append_Columnar(const filesystem::path& path, const std::vector<TError_Record>& records);
+};
@@ -0,0 +1,444 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "headless_runner.h"
+#include "error_export.h"
+
+#include <scgms/rtl/qdb_connector.h>
+#include <scgms/utils/string_utils.h>
+#include <scgms/lang/dstrings.h>
+
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <array>
+#include <iterator>
+#include <limits>
+
+// how often [ms] the log is pulled from the log filter while the chain runs
+constexpr size_t Headless_Log_Pull_Interval = 500;
+// default time without any event, after which a chain that failed or stopped without shutting down is given up
+constexpr std::chrono::minutes Headless_Default_Inactivity_Timeout{ 5 };
+// time the chain gets to shut down after the cancel, before it is terminated without waiting
+constexpr std::chrono::seconds Headless_Cancel_Grace_Period{ 10 };
+// file names of stored drawings by type, same as the drawing tabs offer when saving
+static const std::array<const char*, static_cast<size_t>(scgms::TDrawing_Image_Type::count)> Headless_Filename_For_Type = { {
+	dsSave_Image_Default_Filename_Graph,
+	dsSave_Image_Default_Filename_Day,
+	dsSave_Image_Default_Filename_Parkes,
+	dsSave_Image_Default_Filename_Clark,
+	dsSave_Image_Default_Filename_AGP,
+	dsSave_Image_Default_Filename_ECDF,
+	dsSave_Image_Default_Filename_Profile_Glucose,
+	dsSave_Image_Default_Filename_Profile_Carbs,
+	dsSave_Image_Default_Filename_Profile_Insulin
+} };
+
+// dimensions of drawing_v2 plots stored in headless mode
+constexpr int Headless_Drawing_Width = 1920;
+constexpr int Headless_Drawing_Height = 1080;
+
+CHeadless_Terminal_Filter::CHeadless_Terminal_Filter(CHeadless_Runner& runner) : mRunner(runner) {
+	//
+}
+
+HRESULT IfaceCalling CHeadless_Terminal_Filter::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description) {
+	return S_OK;
+}
+
+HRESULT IfaceCalling CHeadless_Terminal_Filter::Execute(scgms::IDevice_Event* event) {
+	if (!event)
+		return E_INVALIDARG;
+
+	scgms::TDevice_Event* raw_event;
+	HRESULT rc = event->Raw(&raw_event);
+	if (rc != S_OK) {
+		event->Release();
+		return rc;
+	}
+
+	mRunner.mEvent_Count++;
+	if (raw_event->device_time > mRunner.mDevice_Time.load())
+		mRunner.mDevice_Time = raw_event->device_time;
+
+	if (raw_event->event_code == scgms::NDevice_Event_Code::Shut_Down)
+		mRunner.On_Shut_Down();
+
+	event->Release();
+
+	return S_OK;
+}
+
+CHeadless_Runner::CHeadless_Runner(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> configuration, const filesystem::path& output_dir)
+	: mConfiguration(configuration), mOutput_Dir(output_dir), mInactivity_Timeout(Headless_Default_Inactivity_Timeout) {
+	//
+}
+
+CHeadless_Runner::~CHeadless_Runner() {
+	if (mFilter_Executor)
+		mFilter_Executor->Terminate(TRUE);
+}
+
+HRESULT CHeadless_Runner::Load_Experimental_Setup(const filesystem::path& file_path, scgms::SPersistent_Filter_Chain_Configuration& configuration, refcnt::Swstr_list errors) {
+	configuration = scgms::SPersistent_Filter_Chain_Configuration{};
+	if (!configuration)
+		return E_FAIL;
+
+	return configuration->Load_From_File(file_path.wstring().c_str(), errors.get());
+}
+
+HRESULT IfaceCalling CHeadless_Runner::On_Filter_Configured(scgms::IFilter *filter, const void* data) {
+	CHeadless_Runner* runner = static_cast<CHeadless_Runner*>(const_cast<void*>(data));
+
+	Setup_Filter_DB_Access(filter, nullptr);
+
+	if (scgms::SDrawing_Filter_Inspection insp = scgms::SDrawing_Filter_Inspection{ scgms::SFilter{filter} })
+		runner->mDrawing_Filter_Inspection = insp;
+
+	if (scgms::SDrawing_Filter_Inspection_v2 insp = scgms::SDrawing_Filter_Inspection_v2{ scgms::SFilter{filter} })
+		runner->mDrawing_Filter_Inspection_v2.push_back(insp);
+
+	if (scgms::SLog_Filter_Inspection insp = scgms::SLog_Filter_Inspection{ scgms::SFilter{filter} })
+		runner->mLog_Filter_Inspection = insp;
+
+	if (scgms::SSignal_Error_Inspection insp = scgms::SSignal_Error_Inspection{ scgms::SFilter{filter} })
+		runner->mSignal_Error_Inspections.push_back(insp);
+
+	return S_OK;
+}
+
+void CHeadless_Runner::On_Shut_Down() {
+	std::unique_lock<std::mutex> lck(mShut_Down_Mtx);
+	mShut_Down_Received = true;
+	mShut_Down_Cv.notify_all();
+}
+
+void CHeadless_Runner::Cancel() {
+	std::unique_lock<std::mutex> lck(mShut_Down_Mtx);
+	mCancel_Requested = true;
+	mShut_Down_Cv.notify_all();
+}
+
+void CHeadless_Runner::Set_Inactivity_Timeout(const std::chrono::milliseconds timeout) {
+	mInactivity_Timeout = timeout;
+}
+
+void CHeadless_Runner::Set_Cancel_Flag(const BOOL* cancelled) {
+	mCancel_Flag = cancelled;
+}
+
+size_t CHeadless_Runner::Get_Event_Count() const {
+	return mEvent_Count;
+}
+
+double CHeadless_Runner::Get_Device_Time() const {
+	return mDevice_Time;
+}
+
+const std::vector<std::pair<scgms::TSignal_Stats, scgms::TSignal_Stats>>& CHeadless_Runner::Get_Error_Stats() const {
+	return mError_Stats;
+}
+
+const std::vector<double>& CHeadless_Runner::Get_Metrics() const {
+	return mMetrics;
+}
+
+HRESULT CHeadless_Runner::Run(refcnt::Swstr_list errors) {
+	if (!mOutput_Dir.empty()) {
+		std::error_code ec;
+		filesystem::create_directories(mOutput_Dir, ec);
+		if (ec) {
+			errors.push(L"Cannot create output directory " + mOutput_Dir.wstring());
+			return E_FAIL;
+		}
+
+		mLog_File.open(mOutput_Dir / "log.txt");
+	}
+
+	mTerminal_Filter = std::make_unique<CHeadless_Terminal_Filter>(*this);
+
+	// the very same wiring as the simulation window uses, just without any widgets
+	mFilter_Executor = scgms::SFilter_Executor{ mConfiguration, CHeadless_Runner::On_Filter_Configured, this, errors, mTerminal_Filter.get() };
+	if (!mFilter_Executor)
+		return E_FAIL;
+
+	bool cancelled = false;
+	// set if the chain did not shut down in time, i.e.; it failed or stopped - it is not waited for then
+	bool dead = false;
+	{
+		auto last_activity = std::chrono::steady_clock::now();
+		size_t last_event_count = mEvent_Count;
+		std::chrono::steady_clock::time_point cancel_time;
+
+		std::unique_lock<std::mutex> lck(mShut_Down_Mtx);
+		while (!mShut_Down_Received) {
+			if ((mCancel_Requested || (mCancel_Flag && *mCancel_Flag)) && !cancelled) {
+				cancelled = true;
+				cancel_time = std::chrono::steady_clock::now();
+
+				lck.unlock();
+				scgms::UDevice_Event evt{ scgms::NDevice_Event_Code::Shut_Down };
+				// the chain does not take events anymore, so no shut down would ever come
+				dead = !Succeeded(mFilter_Executor.Execute(std::move(evt)));
+				lck.lock();
+				if (dead)
+					break;
+				continue;
+			}
+
+			mShut_Down_Cv.wait_for(lck, std::chrono::milliseconds(Headless_Log_Pull_Interval));
+			if (mShut_Down_Received)
+				break;
+
+			const auto now = std::chrono::steady_clock::now();
+			if (mEvent_Count != last_event_count) {
+				last_event_count = mEvent_Count;
+				last_activity = now;
+			}
+
+			if (cancelled && (now - cancel_time > Headless_Cancel_Grace_Period)) {
+				errors.push(L"The chain did not shut down after it was cancelled.");
+				dead = true;
+				break;
+			}
+
+			if ((mInactivity_Timeout.count() > 0) && (now - last_activity > mInactivity_Timeout)) {
+				errors.push(L"The chain passed no event for " + std::to_wstring(std::chrono::duration_cast<std::chrono::seconds>(mInactivity_Timeout).count())
+					+ L" s and did not shut down; it has probably failed or stopped.");
+				dead = true;
+				break;
+			}
+
+			// keep the log filter's queue short during long runs
+			lck.unlock();
+			Store_Log_Lines();
+			lck.lock();
+		}
+	}
+
+	// chain has shut down, but the filters are still alive, so collect their outputs before terminating
+	Store_Log_Lines();
+	if (!cancelled && !dead) {
+		Calculate_Error_Metrics();
+		if (!mOutput_Dir.empty()) {
+			Store_Drawings();
+			Store_Error_Metrics();
+		}
+	}
+
+	// a dead chain might never finish its shut down, so it is not waited for
+	mFilter_Executor->Terminate(dead ? FALSE : TRUE);
+	mFilter_Executor = scgms::SFilter_Executor{};
+	mTerminal_Filter.reset();
+
+	mLog_File.close();
+
+	if (cancelled)
+		return E_ABORT;
+	return dead ? E_FAIL : S_OK;
+}
+
+void CHeadless_Runner::Store_Log_Lines() {
+	if (!mLog_Filter_Inspection || !mLog_File.is_open())
+		return;
+
+	std::shared_ptr<refcnt::wstr_list> lines;
+	while (mLog_Filter_Inspection.pop(lines)) {
+		refcnt::wstr_container **begin, **end;
+		if (lines && lines->get(&begin, &end) == S_OK) {
+			for (auto iter = begin; iter != end; iter++)
+				mLog_File << Narrow_WChar(refcnt::WChar_Container_To_WString(*iter).c_str()) << '\n';
+		}
+	}
+
+	mLog_File.flush();
+}
+
+void CHeadless_Runner::Store_Drawings() {
+
+	auto store_svg = [this](const std::string& name, refcnt::IVector_Container<char>* svg) {
+		std::ofstream fs(mOutput_Dir / name, std::ios::binary);
+		fs << refcnt::Char_Container_To_String(svg);
+	};
+
+	if (mDrawing_Filter_Inspection) {
+		auto svg = refcnt::Create_Container_shared<char>(nullptr, nullptr);
+		// empty selections - draw all segments and signals
+		auto segment_ids = refcnt::Create_Container_shared<uint64_t>(nullptr, nullptr);
+		auto signal_ids = refcnt::Create_Container_shared<GUID>(nullptr, nullptr);
+
+		for (size_t type = 0; type < static_cast<size_t>(scgms::TDrawing_Image_Type::count); type++) {
+			if (mDrawing_Filter_Inspection->Draw(static_cast<scgms::TDrawing_Image_Type>(type), scgms::TDiagnosis::NotSpecified, svg.get(), segment_ids.get(), signal_ids.get()) == S_OK)
+				store_svg(Headless_Filename_For_Type[type], svg.get());
+		}
+
+		if (mDrawing_Filter_Inspection->Draw(scgms::TDrawing_Image_Type::Parkes, scgms::TDiagnosis::Type2, svg.get(), segment_ids.get(), signal_ids.get()) == S_OK)
+			store_svg(std::string{ "type2_" } + Headless_Filename_For_Type[static_cast<size_t>(scgms::TDrawing_Image_Type::Parkes)], svg.get());
+	}
+
+	for (size_t i = 0; i < mDrawing_Filter_Inspection_v2.size(); i++) {
+		auto& insp = mDrawing_Filter_Inspection_v2[i];
+
+		auto caps = refcnt::Create_Container_shared<scgms::TPlot_Descriptor>(nullptr, nullptr);
+		if (insp->Get_Capabilities(caps.get()) != S_OK || caps->empty() == S_OK)
+			continue;
+
+		scgms::TDraw_Options opts;
+		opts.width = Headless_Drawing_Width;
+		opts.height = Headless_Drawing_Height;
+		opts.in_signals = nullptr;
+		opts.reference_signals = nullptr;
+		opts.signal_count = 0;
+		opts.segments = nullptr;
+		opts.segment_count = 0;
+
+		size_t j = 0;
+		for (auto view = caps.begin(); view != caps.end(); view++, j++) {
+			auto svg = refcnt::Create_Container_shared<char>(nullptr, nullptr);
+			if (insp->Draw(&view->id, svg.get(), &opts) == S_OK)
+				store_svg("drawing_v2_" + std::to_string(i) + "_" + std::to_string(j) + ".svg", svg.get());
+		}
+	}
+}
+
+void CHeadless_Runner::Calculate_Error_Metrics() {
+	mError_Stats.clear();
+	mMetrics.clear();
+
+	constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+	// a filter that fails still gets its (NaN) entry, so that the index of an entry is always the position of its filter
+	for (auto& insp : mSignal_Error_Inspections) {
+		std::pair<scgms::TSignal_Stats, scgms::TSignal_Stats> stats;
+		if (insp->Calculate_Signal_Error(scgms::All_Segments_Id, &stats.first, &stats.second) != S_OK) {
+			for (auto* failed : { &stats.first, &stats.second }) {
+				failed->count = 0;
+				failed->avg = failed->stddev = failed->exc_kurtosis = failed->skewness = failed->sum = nan;
+				std::fill(std::begin(failed->ecdf), std::end(failed->ecdf), nan);
+			}
+		}
+		mError_Stats.push_back(stats);
+
+		// not deferred - the filter calculates its configured metric right away, while the chain is still alive
+		double metric = nan;
+		if (insp->Promise_Metric(scgms::All_Segments_Id, &metric, FALSE) != S_OK)
+			metric = nan;
+		mMetrics.push_back(metric);
+	}
+}
+
+void CHeadless_Runner::Store_Error_Metrics() {
+	if (mSignal_Error_Inspections.empty())
+		return;
+
+	const std::string run = Narrow_WChar(mOutput_Dir.filename().wstring().c_str());
+	std::vector<TError_Record> records;
+
+	for (auto& insp : mSignal_Error_Inspections) {
+		wchar_t *tmp_desc;
+		const std::string description = Narrow_WChar(insp->Get_Description(&tmp_desc) == S_OK ? tmp_desc : dsSignal_Unknown);
+
+		TError_Record abs_record{ run, description, scgms::All_Segments_Id, false };
+		TError_Record rel_record{ run, description, scgms::All_Segments_Id, true };
+		if (insp->Calculate_Signal_Error(scgms::All_Segments_Id, &abs_record.stats, &rel_record.stats) == S_OK) {
+			records.push_back(std::move(abs_record));
+			records.push_back(std::move(rel_record));
+		}
+	}
+
+	CError_Export::Write_CSV(mOutput_Dir / "errors.csv", records);
+}
+
+int Headless_Main(const std::vector<std::wstring>& arguments) {
+	// expected arguments: <config.ini> [--output <directory>] [--timeout <seconds>]
+	auto usage = []() {
+		std::wcerr << L"Usage: scgms-desktop --headless <config.ini> [--output <directory>] [--timeout <seconds>]" << std::endl;
+		std::wcerr << L"       scgms-desktop --headless --benchmark <config.ini> [options]" << std::endl;
+		return 2;
+	};
+
+	if (arguments.empty())
+		return usage();
+
+	const filesystem::path config_path = arguments[0];
+	filesystem::path output_dir = config_path.parent_path() / (config_path.stem().wstring() + L"_results");
+	std::chrono::milliseconds inactivity_timeout = Headless_Default_Inactivity_Timeout;
+
+	// every option takes a value; a typo must not silently run with the defaults
+	for (size_t i = 1; i < arguments.size(); i += 2) {
+		if (i + 1 >= arguments.size()) {
+			std::wcerr << L"Missing value of " << arguments[i] << std::endl;
+			return usage();
+		}
+
+		if (arguments[i] == L"--output")
+			output_dir = arguments[i + 1];
+		else if (arguments[i] == L"--timeout") {
+			bool ok = false;
+			const double seconds = str_2_dbl(arguments[i + 1].c_str(), ok);
+			if (!ok || seconds < 0.0) {
+				std::wcerr << L"Invalid value of " << arguments[i] << L": " << arguments[i + 1] << std::endl;
+				return 2;
+			}
+			inactivity_timeout = std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000.0));
+		}
+		else {
+			std::wcerr << L"Unknown option: " << arguments[i] << std::endl;
+			return usage();
+		}
+	}
+
+	refcnt::Swstr_list errors;
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	HRESULT rc = CHeadless_Runner::Load_Experimental_Setup(config_path, configuration, errors);
+
+	if (rc == S_OK) {
+		CHeadless_Runner runner{ configuration.get(), output_dir };
+		runner.Set_Inactivity_Timeout(inactivity_timeout);
+		rc = runner.Run(errors);
+	}
+
+	errors.for_each([](auto str) {
+		std::wcerr << str << std::endl;
+	});
+
+	if (rc != S_OK) {
+		std::wcerr << L"Headless run of " << config_path.wstring() << L" failed: 0x" << std::hex << rc << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
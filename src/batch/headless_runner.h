@@ -0,0 +1,150 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/UILib.h>
+#include <scgms/rtl/FilesystemLib.h>
+#include <scgms/rtl/referencedImpl.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <utility>
+
+class CHeadless_Runner;
+
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance
+
+/*
+ * Terminal filter of a headless chain - counts events and reports the shut down
+ */
+class CHeadless_Terminal_Filter : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced
+{
+	protected:
+		CHeadless_Runner& mRunner;
+
+	public:
+		CHeadless_Terminal_Filter(CHeadless_Runner& runner);
+
+		HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description) override;
+		HRESULT IfaceCalling Execute(scgms::IDevice_Event* event) override;
+};
+
+#pragma warning( pop )
+
+/*
+ * Runs an experimental setup without any GUI until the chain shuts down, then stores log, error metrics and drawings to a directory
+ * With an empty output directory, nothing is stored and the error metrics are just kept for Get_Error_Stats
+ */
+class CHeadless_Runner {
+	friend class CHeadless_Terminal_Filter;
+
+	protected:
+		refcnt::SReferenced<scgms::IFilter_Chain_Configuration> mConfiguration;
+		const filesystem::path mOutput_Dir;
+
+		scgms::SFilter_Executor mFilter_Executor;
+		std::unique_ptr<CHeadless_Terminal_Filter> mTerminal_Filter;
+
+		// inspection interfaces of filters gathered during chain configuration
+		scgms::SDrawing_Filter_Inspection mDrawing_Filter_Inspection;
+		std::vector<scgms::SDrawing_Filter_Inspection_v2> mDrawing_Filter_Inspection_v2;
+		scgms::SLog_Filter_Inspection mLog_Filter_Inspection;
+		std::vector<scgms::SSignal_Error_Inspection> mSignal_Error_Inspections;
+
+		std::mutex mShut_Down_Mtx;
+		std::condition_variable mShut_Down_Cv;
+		bool mShut_Down_Received = false;
+		std::atomic<bool> mCancel_Requested{ false };
+		// external cancel request, e.g.; of a solver replaying the chain; polled during the run
+		const BOOL* mCancel_Flag = nullptr;
+
+		// the run fails, if the chain passes no event to the terminal filter for this long; zero waits forever
+		std::chrono::milliseconds mInactivity_Timeout;
+
+		// progress of the run, updated by terminal filter
+		std::atomic<size_t> mEvent_Count{ 0 };
+		std::atomic<double> mDevice_Time{ 0.0 };
+
+		std::ofstream mLog_File;
+
+		// absolute and relative error of every signal error filter, in the order the filters were configured; NaN stats for a filter that failed
+		std::vector<std::pair<scgms::TSignal_Stats, scgms::TSignal_Stats>> mError_Stats;
+		// metric configured on every signal error filter, in the same order; NaN for a filter that failed
+		std::vector<double> mMetrics;
+
+		static HRESULT IfaceCalling On_Filter_Configured(scgms::IFilter *filter, const void* data);
+
+		void On_Shut_Down();
+
+		void Store_Log_Lines();
+		void Store_Drawings();
+		void Calculate_Error_Metrics();
+		void Store_Error_Metrics();
+
+	public:
+		CHeadless_Runner(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> configuration, const filesystem::path& output_dir);
+		virtual ~CHeadless_Runner();
+
+		// loads experimental setup from given INI file
+		static HRESULT Load_Experimental_Setup(const filesystem::path& file_path, scgms::SPersistent_Filter_Chain_Configuration& configuration, refcnt::Swstr_list errors);
+
+		// executes the chain and blocks until it shuts down (or the run is cancelled); stores outputs on success
+		HRESULT Run(refcnt::Swstr_list errors);
+		// requests the running chain to shut down; may be called from any thread
+		void Cancel();
+		// sets the time without any event, after which the chain is considered dead; call before Run
+		void Set_Inactivity_Timeout(const std::chrono::milliseconds timeout);
+		// the run gets cancelled, once the flag turns non-zero; the flag has to outlive the run, call before Run
+		void Set_Cancel_Flag(const BOOL* cancelled);
+
+		size_t Get_Event_Count() const;
+		double Get_Device_Time() const;
+		// absolute and relative error statistics of all the signal error filters, valid after a successful run
+		const std::vector<std::pair<scgms::TSignal_Stats, scgms::TSignal_Stats>>& Get_Error_Stats() const;
+		// the metrics the signal error filters are configured with, as the solvers of the SDK use them; valid after a successful run
+		const std::vector<double>& Get_Metrics() const;
+};
+
+// entry point of the headless batch-run mode; arguments are the application arguments following the mode switch
+int Headless_Main(const std::vector<std::wstring>& arguments);
@@ -0,0 +1,286 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "parameter_sweep.h"
+#include "headless_runner.h"
+#include "configuration_utils.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <locale>
+#include <memory>
+#include <numeric>
+#include <random>
+
+CParameter_Sweep::CParameter_Sweep(scgms::SFilter_Chain_Configuration configuration, const size_t filter_index, const std::wstring& parameter_name,
+	std::vector<double> lower_bounds, std::vector<double> defaults, std::vector<double> upper_bounds, std::vector<size_t> swept, const size_t thread_count)
+	: mConfiguration(configuration), mFilter_Index(filter_index), mParameter_Name(parameter_name),
+	mLower_Bounds(std::move(lower_bounds)), mDefaults(std::move(defaults)), mUpper_Bounds(std::move(upper_bounds)), mSwept(std::move(swept)),
+	mPool(thread_count) {
+	//
+}
+
+CParameter_Sweep::~CParameter_Sweep() {
+	Cancel();
+
+	for (auto& result : mResults) {
+		if (result.valid())
+			result.wait();
+	}
+}
+
+CParameter_Sweep::TPoint_Generator CParameter_Sweep::Latin_Hypercube(const std::vector<double>& lower_bounds, const std::vector<double>& upper_bounds, const size_t sample_count) {
+	std::mt19937_64 generator{ std::random_device{}() };
+
+	// independent permutation of the strata per dimension; the positions within the strata are drawn per point
+	auto strata = std::make_shared<std::vector<std::vector<size_t>>>(lower_bounds.size(), std::vector<size_t>(sample_count));
+	for (auto& permutation : *strata) {
+		std::iota(permutation.begin(), permutation.end(), 0);
+		std::shuffle(permutation.begin(), permutation.end(), generator);
+	}
+
+	const uint64_t seed = generator();
+
+	return [lower_bounds, upper_bounds, sample_count, strata, seed](const size_t index) {
+		std::seed_seq point_seed{ seed, static_cast<uint64_t>(index) };
+		std::mt19937_64 point_generator{ point_seed };
+		std::uniform_real_distribution<double> within_stratum{ 0.0, 1.0 };
+
+		std::vector<double> point(lower_bounds.size());
+		for (size_t dim = 0; dim < point.size(); dim++) {
+			const double range = upper_bounds[dim] - lower_bounds[dim];
+			point[dim] = lower_bounds[dim] + range * (static_cast<double>((*strata)[dim][index]) + within_stratum(point_generator)) / static_cast<double>(sample_count);
+		}
+
+		return point;
+	};
+}
+
+CParameter_Sweep::TPoint_Generator CParameter_Sweep::Grid(const std::vector<double>& lower_bounds, const std::vector<double>& upper_bounds, const size_t points_per_axis) {
+	return [lower_bounds, upper_bounds, points_per_axis](const size_t index) {
+		// the index is the odometer over the steps of all the dimensions
+		size_t remaining = index;
+		std::vector<double> point(lower_bounds.size());
+		for (size_t dim = 0; dim < point.size(); dim++) {
+			const size_t step = remaining % points_per_axis;
+			remaining /= points_per_axis;
+
+			// a single point per axis lies in the middle of the range
+			if (points_per_axis == 1)
+				point[dim] = 0.5 * (lower_bounds[dim] + upper_bounds[dim]);
+			else
+				point[dim] = lower_bounds[dim] + (upper_bounds[dim] - lower_bounds[dim]) * static_cast<double>(step) / static_cast<double>(points_per_axis - 1);
+		}
+
+		return point;
+	};
+}
+
+size_t CParameter_Sweep::Grid_Point_Count(const size_t dimensions, const size_t points_per_axis) {
+	if (dimensions == 0 || points_per_axis == 0)
+		return 0;
+
+	size_t count = 1;
+	for (size_t dim = 0; dim < dimensions; dim++) {
+		if (count > std::numeric_limits<size_t>::max() / points_per_axis)
+			return std::numeric_limits<size_t>::max();
+		count *= points_per_axis;
+	}
+
+	return count;
+}
+
+bool CParameter_Sweep::Start(const size_t point_count, TPoint_Generator generator) {
+	if (point_count > Max_Point_Count)
+		return false;
+
+	mGenerator = std::move(generator);
+	{
+		std::unique_lock<std::mutex> lck(mPoints_Mtx);
+		mPoints.assign(point_count, TSweep_Point{});
+		mRunners.assign(point_count, nullptr);
+	}
+
+	// one long-running worker per pool thread, instead of a task per point
+	const size_t workers = std::min(mPool.Thread_Count(), point_count);
+	mRunning_Workers = workers;
+	for (size_t i = 0; i < workers; i++)
+		mResults.push_back(mPool.Submit([this]() { Run_Worker(); }));
+
+	return true;
+}
+
+void CParameter_Sweep::Run_Worker() {
+	const size_t point_count = Point_Count();
+
+	for (size_t index = mNext_Point++; index < point_count && !mCancel_Requested; index = mNext_Point++)
+		Evaluate(index);
+
+	mRunning_Workers--;
+}
+
+void CParameter_Sweep::Evaluate(const size_t index) {
+	const std::vector<double> values = mGenerator(index);
+	{
+		std::unique_lock<std::mutex> lck(mPoints_Mtx);
+		mPoints[index].values = values;
+	}
+
+	// lower bounds, defaults with the swept values placed in, upper bounds
+	std::vector<double> parameter_values;
+	parameter_values.insert(parameter_values.end(), mLower_Bounds.begin(), mLower_Bounds.end());
+	parameter_values.insert(parameter_values.end(), mDefaults.begin(), mDefaults.end());
+	parameter_values.insert(parameter_values.end(), mUpper_Bounds.begin(), mUpper_Bounds.end());
+	for (size_t i = 0; i < mSwept.size(); i++)
+		parameter_values[mDefaults.size() + mSwept[i]] = values[i];
+
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	HRESULT rc = Clone_Configuration(mConfiguration, configuration);
+	if (rc == S_OK) {
+		scgms::SFilter_Parameter parameter = Find_Filter_Parameter(configuration, mFilter_Index, mParameter_Name.c_str());
+		rc = parameter ? parameter.set_double_array(parameter_values) : E_INVALIDARG;
+	}
+
+	std::vector<double> metric;
+
+	if (rc == S_OK) {
+		// no output directory - the runner stores nothing, it just keeps the error metrics
+		CHeadless_Runner runner{ configuration.get(), filesystem::path{} };
+
+		{
+			std::unique_lock<std::mutex> lck(mPoints_Mtx);
+			mRunners[index] = &runner;
+		}
+
+		// cancel might have come while the configuration was being prepared
+		if (mCancel_Requested)
+			runner.Cancel();
+
+		refcnt::Swstr_list errors;
+		rc = runner.Run(errors);
+
+		{
+			std::unique_lock<std::mutex> lck(mPoints_Mtx);
+			mRunners[index] = nullptr;
+		}
+
+		if (rc == S_OK)
+			metric = runner.Get_Metrics();
+	}
+
+	std::unique_lock<std::mutex> lck(mPoints_Mtx);
+	mPoints[index].metric = std::move(metric);
+	mPoints[index].result = rc;
+	mFinished_Count++;
+}
+
+void CParameter_Sweep::Cancel() {
+	mCancel_Requested = true;
+
+	std::unique_lock<std::mutex> lck(mPoints_Mtx);
+	for (auto runner : mRunners) {
+		if (runner)
+			runner->Cancel();
+	}
+}
+
+size_t CParameter_Sweep::Point_Count() const {
+	std::unique_lock<std::mutex> lck(mPoints_Mtx);
+	return mPoints.size();
+}
+
+size_t CParameter_Sweep::Finished_Count() const {
+	return mFinished_Count;
+}
+
+bool CParameter_Sweep::Is_Finished() const {
+	return mRunning_Workers == 0;
+}
+
+std::vector<TSweep_Point> CParameter_Sweep::Get_Points() const {
+	std::vector<TSweep_Point> points;
+
+	std::unique_lock<std::mutex> lck(mPoints_Mtx);
+	for (const auto& point : mPoints) {
+		if (!point.values.empty())
+			points.push_back(point);
+	}
+
+	return points;
+}
+
+bool CParameter_Sweep::Write_CSV(const filesystem::path& path, const std::vector<std::wstring>& swept_names) const {
+	const auto points = Get_Points();
+
+	std::ofstream fs(path, std::ios::binary);
+	if (!fs.is_open())
+		return false;
+
+	fs.imbue(std::locale::classic());
+	fs << std::setprecision(17);
+
+	size_t metric_count = 0;
+	for (const auto& point : points)
+		metric_count = std::max(metric_count, point.metric.size());
+
+	for (size_t i = 0; i < swept_names.size(); i++)
+		fs << (i > 0 ? ";" : "") << Narrow_WChar(swept_names[i].c_str());
+	for (size_t i = 0; i < metric_count; i++)
+		fs << ";metric_" << (i + 1);
+	fs << '\n';
+
+	for (const auto& point : points) {
+		if (point.result != S_OK)
+			continue;
+
+		for (size_t i = 0; i < point.values.size(); i++)
+			fs << (i > 0 ? ";" : "") << point.values[i];
+		for (size_t i = 0; i < metric_count; i++) {
+			fs << ';';
+			// non-finite values are left empty, as the error export does
+			if (i < point.metric.size() && std::isfinite(point.metric[i]))
+				fs << point.metric[i];
+		}
+		fs << '\n';
+	}
+
+	return fs.good();
+}
@@ -0,0 +1,140 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/FilesystemLib.h>
+
+#include "../utils/thread_pool.h"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class CHeadless_Runner;
+
+enum class NSweep_Design {
+	Latin_Hypercube,
+	Grid
+};
+
+/*
+ * Single evaluated parameter vector of a sweep
+ */
+struct TSweep_Point {
+	// values of the swept parameters, in the order of the swept indices; empty until the evaluation gets to the point
+	std::vector<double> values;
+	// metric configured on every signal error filter of the chain; empty until evaluated, or if the evaluation failed
+	std::vector<double> metric;
+	// S_FALSE while not evaluated yet
+	HRESULT result = S_FALSE;
+};
+
+/*
+ * Sensitivity sweep of model parameters - replays the chain for many parameter vectors, concurrently, one chain per pool thread
+ *
+ * Parameters not being swept keep their default values; every evaluation runs on its own copy of the configuration.
+ * The vectors are generated only as the pool threads get to them, so a design is never held in memory as a whole.
+ */
+class CParameter_Sweep {
+	public:
+		// vector of given index of a design; called concurrently by the pool threads
+		using TPoint_Generator = std::function<std::vector<double>(const size_t index)>;
+
+		// a sweep never evaluates more points than this, whatever the design
+		static constexpr size_t Max_Point_Count = 100000;
+
+	protected:
+		scgms::SFilter_Chain_Configuration mConfiguration;
+		const size_t mFilter_Index;
+		const std::wstring mParameter_Name;
+		const std::vector<double> mLower_Bounds, mDefaults, mUpper_Bounds;
+		// indices of the swept parameters within the bounds
+		const std::vector<size_t> mSwept;
+
+		CThread_Pool mPool;
+		std::vector<std::future<void>> mResults;
+
+		TPoint_Generator mGenerator;
+		// index of the next point to evaluate; every pool thread takes the points one by one
+		std::atomic<size_t> mNext_Point{ 0 };
+		std::atomic<size_t> mRunning_Workers{ 0 };
+
+		// guards mPoints and mRunners
+		mutable std::mutex mPoints_Mtx;
+		std::vector<TSweep_Point> mPoints;
+		// runner of each point while it is running, nullptr otherwise
+		std::vector<CHeadless_Runner*> mRunners;
+
+		std::atomic<size_t> mFinished_Count{ 0 };
+		std::atomic<bool> mCancel_Requested{ false };
+
+		void Run_Worker();
+		void Evaluate(const size_t index);
+
+	public:
+		// thread_count of zero uses one thread per core
+		CParameter_Sweep(scgms::SFilter_Chain_Configuration configuration, const size_t filter_index, const std::wstring& parameter_name,
+			std::vector<double> lower_bounds, std::vector<double> defaults, std::vector<double> upper_bounds, std::vector<size_t> swept,
+			const size_t thread_count = 0);
+		virtual ~CParameter_Sweep();
+
+		// sample_count vectors, each of the sample_count strata of every dimension is hit exactly once
+		static TPoint_Generator Latin_Hypercube(const std::vector<double>& lower_bounds, const std::vector<double>& upper_bounds, const size_t sample_count);
+		// all the combinations of points_per_axis evenly spaced values of every dimension, the first dimension changing the fastest
+		static TPoint_Generator Grid(const std::vector<double>& lower_bounds, const std::vector<double>& upper_bounds, const size_t points_per_axis);
+		// number of the points of a grid; saturates at the maximum of size_t
+		static size_t Grid_Point_Count(const size_t dimensions, const size_t points_per_axis);
+
+		// evaluates point_count vectors of the swept parameters; false, if there are more of them than Max_Point_Count
+		bool Start(const size_t point_count, TPoint_Generator generator);
+		void Cancel();
+
+		size_t Point_Count() const;
+		size_t Finished_Count() const;
+		// true once all the pool threads stopped taking points, i.e.; all the points are evaluated or the sweep was cancelled
+		bool Is_Finished() const;
+
+		// the points the evaluation got to so far
+		std::vector<TSweep_Point> Get_Points() const;
+
+		// one row per point - the swept values, then the metric of every signal error filter
+		bool Write_CSV(const filesystem::path& path, const std::vector<std::wstring>& swept_names) const;
+};
@@ -0,0 +1,467 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "solver_benchmark.h"
+#include "configuration_utils.h"
+#include "headless_runner.h"
+
+#include <scgms/rtl/qdb_connector.h>
+#include <scgms/utils/string_utils.h>
+#include <scgms/utils/math_utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cwchar>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <locale>
+
+// how often the best metric of the running solver is sampled
+constexpr std::chrono::milliseconds Benchmark_Sample_Interval{ 100 };
+// a solver reaches the target quality when its first objective gets within this relative distance of the best one of all the solvers
+constexpr double Benchmark_Target_Tolerance = 0.01;
+
+namespace {
+	bool Is_Metric_Changed(const solver::TFitness& current, const solver::TFitness& last) {
+		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++) {
+			if (Is_Any_NaN(current[i]))
+				continue;
+			if (Is_Any_NaN(last[i]) || last[i] != current[i])
+				return true;
+		}
+
+		return false;
+	}
+
+	void Write_Metric(std::ofstream& fs, const solver::TFitness& metric) {
+		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++) {
+			fs << ';';
+			// non-finite values are left empty, as the error export does
+			if (std::isfinite(metric[i]))
+				fs << metric[i];
+		}
+	}
+
+	void Write_Metric_Header(std::ofstream& fs) {
+		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++)
+			fs << ";best_metric_" << (i + 1);
+	}
+
+	std::vector<std::wstring> Split(const std::wstring& str, const wchar_t delimiter) {
+		std::vector<std::wstring> result;
+
+		size_t begin = 0;
+		while (begin <= str.size()) {
+			const size_t end = std::min(str.find(delimiter, begin), str.size());
+			if (end > begin)
+				result.push_back(str.substr(begin, end - begin));
+			begin = end + 1;
+		}
+
+		return result;
+	}
+
+	bool Parse_Size(const std::wstring& str, size_t& value) {
+		wchar_t* end = nullptr;
+		const unsigned long long parsed = std::wcstoull(str.c_str(), &end, 10);
+		if (str.empty() || end != str.c_str() + str.size())
+			return false;
+
+		value = static_cast<size_t>(parsed);
+		return true;
+	}
+}
+
+double TSolver_Benchmark_Result::Evaluations_Per_Second() const {
+	return wall_time_ms > 0.0 ? 1000.0 * static_cast<double>(evaluations) / wall_time_ms : std::numeric_limits<double>::quiet_NaN();
+}
+
+CSolver_Benchmark::CSolver_Benchmark(scgms::SFilter_Chain_Configuration configuration, std::vector<size_t> filter_indices, std::vector<std::wstring> parameter_names,
+	const size_t population_size, const size_t max_generations)
+	: mConfiguration(configuration), mFilter_Indices(std::move(filter_indices)), mParameter_Names(std::move(parameter_names)),
+	mPopulation_Size(population_size), mMax_Generations(max_generations) {
+	//
+}
+
+HRESULT CSolver_Benchmark::Run(const std::vector<GUID>& solvers, refcnt::Swstr_list errors) {
+	const auto descriptors = scgms::get_solver_descriptor_list();
+
+	{
+		std::unique_lock<std::mutex> lck(mResults_Mtx);
+		mResults.clear();
+		for (const auto& id : solvers) {
+			TSolver_Benchmark_Result result;
+			result.solver_id = id;
+
+			const auto descriptor = std::find_if(descriptors.begin(), descriptors.end(), [&id](const auto& desc) { return desc.id == id; });
+			result.description = descriptor != descriptors.end() ? std::wstring{ descriptor->description } : GUID_To_WString(id);
+
+			mResults.push_back(std::move(result));
+		}
+	}
+
+	bool succeeded = false;
+	for (size_t i = 0; i < solvers.size() && !mCancel_Requested; i++) {
+		mCurrent_Solver = i;
+		if (Run_Solver(i, errors) == S_OK)
+			succeeded = true;
+	}
+
+	if (mCancel_Requested)
+		return E_ABORT;
+
+	return succeeded ? S_OK : E_FAIL;
+}
+
+HRESULT CSolver_Benchmark::Run_Solver(const size_t index, refcnt::Swstr_list errors) {
+	GUID solver_id;
+	{
+		std::unique_lock<std::mutex> lck(mResults_Mtx);
+		solver_id = mResults[index].solver_id;
+	}
+
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	HRESULT rc = Clone_Configuration(mConfiguration, configuration);
+
+	// the solvers run exactly as the optimization dialog runs them; every evaluation builds the chain anew,
+	// so the evaluations are the creations of the chain's filters, one per link
+	size_t link_count = 0;
+	if (rc == S_OK)
+		configuration.for_each([&link_count](scgms::SFilter_Configuration_Link) { link_count++; });
+
+	std::vector<const wchar_t*> parameter_names;
+	for (const auto& name : mParameter_Names)
+		parameter_names.push_back(name.c_str());
+
+	mProgress = solver::Null_Solver_Progress;
+	mCreated_Filters = 0;
+
+	TSolver_Benchmark_Result result;
+	solver::TFitness last_metric = solver::Nan_Fitness;
+	size_t generations = 0;
+
+	const auto started = std::chrono::steady_clock::now();
+	auto elapsed_ms = [&started]() {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+	};
+
+	auto sample = [&]() {
+		generations = std::max(generations, mProgress.current_progress);
+		const solver::TFitness metric = mProgress.best_metric;
+		if (Is_Metric_Changed(metric, last_metric)) {
+			result.trace.push_back({ elapsed_ms(), mProgress.current_progress, metric });
+			last_metric = metric;
+		}
+	};
+
+	if (rc == S_OK) {
+		// the solver blocks, so it runs aside while its progress is being sampled
+		auto done = std::async(std::launch::async, [&]() {
+			return scgms::Optimize_Parameters(configuration, mFilter_Indices.data(), parameter_names.data(), mFilter_Indices.size(),
+				On_Filter_Created, this,
+				solver_id,
+				mPopulation_Size,
+				mMax_Generations,
+				nullptr, 0,
+				mProgress,
+				errors);
+		});
+
+		while (done.wait_for(Benchmark_Sample_Interval) == std::future_status::timeout) {
+			if (mCancel_Requested)
+				mProgress.cancelled = TRUE;
+			sample();
+		}
+
+		rc = done.get();
+		sample();
+	}
+
+	result.wall_time_ms = elapsed_ms();
+	result.trace.push_back({ result.wall_time_ms, generations, mProgress.best_metric });
+
+	std::unique_lock<std::mutex> lck(mResults_Mtx);
+	auto& stored = mResults[index];
+	stored.result = rc;
+	stored.wall_time_ms = result.wall_time_ms;
+	stored.evaluations = link_count > 0 ? mCreated_Filters / link_count : 0;
+	stored.generations = generations;
+	stored.best_metric = mProgress.best_metric;
+	stored.trace = std::move(result.trace);
+
+	return rc;
+}
+
+HRESULT IfaceCalling CSolver_Benchmark::On_Filter_Created(scgms::IFilter *filter, const void* data) {
+	CSolver_Benchmark* benchmark = static_cast<CSolver_Benchmark*>(const_cast<void*>(data));
+	// the solver evaluates its population in parallel
+	benchmark->mCreated_Filters++;
+
+	return Setup_Filter_DB_Access(filter, nullptr);
+}
+
+void CSolver_Benchmark::Cancel() {
+	mCancel_Requested = true;
+	mProgress.cancelled = TRUE;
+}
+
+size_t CSolver_Benchmark::Current_Solver() const {
+	return mCurrent_Solver;
+}
+
+double CSolver_Benchmark::Current_Progress() const {
+	const size_t max_progress = mProgress.max_progress;
+	if (max_progress == 0)
+		return 0.0;
+
+	return std::min(1.0, static_cast<double>(mProgress.current_progress) / static_cast<double>(max_progress));
+}
+
+std::vector<TSolver_Benchmark_Result> CSolver_Benchmark::Get_Results() const {
+	std::unique_lock<std::mutex> lck(mResults_Mtx);
+	return mResults;
+}
+
+bool CSolver_Benchmark::Write_Report(const filesystem::path& path) const {
+	const auto results = Get_Results();
+
+	// target quality is relative to the best first objective any of the solvers reached
+	double best_objective = std::numeric_limits<double>::quiet_NaN();
+	for (const auto& result : results) {
+		if (result.result == S_OK && !Is_Any_NaN(result.best_metric[0]) && (Is_Any_NaN(best_objective) || result.best_metric[0] < best_objective))
+			best_objective = result.best_metric[0];
+	}
+	const double target = best_objective + std::abs(best_objective) * Benchmark_Target_Tolerance;
+
+	std::ofstream summary(path, std::ios::binary);
+	if (!summary.is_open())
+		return false;
+
+	summary.imbue(std::locale::classic());
+	summary << std::setprecision(17);
+
+	summary << "solver_id;solver;result;wall_time_ms;evaluations;evaluations_per_s;generations;time_to_target_ms";
+	Write_Metric_Header(summary);
+	summary << '\n';
+
+	for (const auto& result : results) {
+		// the first moment the solver got close enough to the best result, i.e.; how much it costs to get a comparable quality
+		double time_to_target = std::numeric_limits<double>::quiet_NaN();
+		for (const auto& sample : result.trace) {
+			if (!Is_Any_NaN(sample.best_metric[0]) && sample.best_metric[0] <= target) {
+				time_to_target = sample.elapsed_ms;
+				break;
+			}
+		}
+
+		summary << Narrow_WChar(GUID_To_WString(result.solver_id).c_str()) << ';'
+			<< Narrow_WChar(result.description.c_str()) << ';'
+			<< "0x" << std::hex << static_cast<uint32_t>(result.result) << std::dec << ';'
+			<< result.wall_time_ms << ';'
+			<< result.evaluations << ';';
+
+		const double evaluations_per_s = result.Evaluations_Per_Second();
+		if (std::isfinite(evaluations_per_s))
+			summary << evaluations_per_s;
+		summary << ';' << result.generations << ';';
+		if (std::isfinite(time_to_target))
+			summary << time_to_target;
+
+		Write_Metric(summary, result.best_metric);
+		summary << '\n';
+	}
+
+	filesystem::path trace_path = path;
+	trace_path.replace_filename(path.stem().wstring() + L"_trace" + path.extension().wstring());
+
+	std::ofstream trace(trace_path, std::ios::binary);
+	if (!trace.is_open())
+		return false;
+
+	trace.imbue(std::locale::classic());
+	trace << std::setprecision(17);
+
+	trace << "solver;elapsed_ms;generation";
+	Write_Metric_Header(trace);
+	trace << '\n';
+
+	for (const auto& result : results) {
+		const std::string solver = Narrow_WChar(result.description.c_str());
+		for (const auto& sample : result.trace) {
+			trace << solver << ';' << sample.elapsed_ms << ';' << sample.generation;
+			Write_Metric(trace, sample.best_metric);
+			trace << '\n';
+		}
+	}
+
+	return summary.good() && trace.good();
+}
+
+int Benchmark_Main(const std::vector<std::wstring>& arguments) {
+	// expected arguments: <config.ini> [--solvers all|<guid>,...] [--parameters <filter index>:<name>,...] [--population <n>] [--generations <n>] [--output <report.csv>]
+	auto usage = []() {
+		std::wcerr << L"Usage: scgms-desktop --headless --benchmark <config.ini> [--solvers all|<guid>,...] [--parameters <filter index>:<name>,...] "
+			L"[--population <n>] [--generations <n>] [--output <report.csv>]" << std::endl;
+		return 2;
+	};
+
+	if (arguments.empty())
+		return usage();
+
+	const filesystem::path config_path = arguments[0];
+	filesystem::path report_path = config_path.parent_path() / (config_path.stem().wstring() + L"_benchmark.csv");
+	std::wstring solvers_arg = L"all";
+	std::wstring parameters_arg;
+	// the same defaults as the optimization dialog offers
+	size_t population_size = 100;
+	size_t max_generations = 10000;
+
+	// every option takes a value; a typo must not silently run with the defaults
+	for (size_t i = 1; i < arguments.size(); i += 2) {
+		if (i + 1 >= arguments.size()) {
+			std::wcerr << L"Missing value of " << arguments[i] << std::endl;
+			return usage();
+		}
+
+		bool ok = true;
+		if (arguments[i] == L"--output")
+			report_path = arguments[i + 1];
+		else if (arguments[i] == L"--solvers")
+			solvers_arg = arguments[i + 1];
+		else if (arguments[i] == L"--parameters")
+			parameters_arg = arguments[i + 1];
+		else if (arguments[i] == L"--population")
+			ok = Parse_Size(arguments[i + 1], population_size);
+		else if (arguments[i] == L"--generations")
+			ok = Parse_Size(arguments[i + 1], max_generations);
+		else {
+			std::wcerr << L"Unknown option: " << arguments[i] << std::endl;
+			return usage();
+		}
+
+		if (!ok) {
+			std::wcerr << L"Invalid value of " << arguments[i] << L": " << arguments[i + 1] << std::endl;
+			return 2;
+		}
+	}
+
+	std::vector<GUID> solvers;
+	if (solvers_arg == L"all") {
+		for (const auto& descriptor : scgms::get_solver_descriptor_list())
+			solvers.push_back(descriptor.id);
+	}
+	else {
+		for (const auto& str : Split(solvers_arg, L',')) {
+			bool ok = false;
+			const GUID id = WString_To_GUID(str, ok);
+			if (!ok) {
+				std::wcerr << L"Invalid solver id: " << str << std::endl;
+				return 2;
+			}
+			solvers.push_back(id);
+		}
+	}
+
+	refcnt::Swstr_list errors;
+	scgms::SPersistent_Filter_Chain_Configuration configuration;
+	HRESULT rc = CHeadless_Runner::Load_Experimental_Setup(config_path, configuration, errors);
+
+	std::vector<size_t> filter_indices;
+	std::vector<std::wstring> parameter_names;
+
+	if (rc == S_OK) {
+		if (parameters_arg.empty()) {
+			// no explicit selection - all the parameters the optimization dialog would offer
+			size_t filter_index = 0;
+			configuration.for_each([&](scgms::SFilter_Configuration_Link link) {
+				link.for_each([&](scgms::SFilter_Parameter parameter) {
+					if (parameter.type() == scgms::NParameter_Type::ptDouble_Array) {
+						filter_indices.push_back(filter_index);
+						parameter_names.push_back(parameter.configuration_name());
+					}
+				});
+				filter_index++;
+			});
+		}
+		else {
+			for (const auto& str : Split(parameters_arg, L',')) {
+				const size_t delimiter = str.find(L':');
+				size_t filter_index = 0;
+				if (delimiter == std::wstring::npos || !Parse_Size(str.substr(0, delimiter), filter_index)) {
+					std::wcerr << L"Invalid parameters specification: " << str << std::endl;
+					return 2;
+				}
+
+				filter_indices.push_back(filter_index);
+				parameter_names.push_back(str.substr(delimiter + 1));
+			}
+		}
+
+		if (filter_indices.empty() || solvers.empty()) {
+			std::wcerr << L"There is nothing to benchmark - no solver or no parameters to optimize" << std::endl;
+			rc = E_INVALIDARG;
+		}
+	}
+
+	if (rc == S_OK) {
+		CSolver_Benchmark benchmark{ configuration, filter_indices, parameter_names, population_size, max_generations };
+		rc = benchmark.Run(solvers, errors);
+
+		for (const auto& result : benchmark.Get_Results()) {
+			std::wcout << result.description << L": " << result.wall_time_ms << L" ms, " << result.evaluations << L" evaluations, "
+				<< result.Evaluations_Per_Second() << L" evaluations/s, best metric " << result.best_metric[0] << std::endl;
+		}
+
+		if (!benchmark.Write_Report(report_path)) {
+			errors.push(L"Cannot write benchmark report " + report_path.wstring());
+			rc = E_FAIL;
+		}
+	}
+
+	errors.for_each([](auto str) {
+		std::wcerr << str << std::endl;
+	});
+
+	if (rc != S_OK) {
+		std::wcerr << L"Benchmark of " << config_path.wstring() << L" failed: 0x" << std::hex << rc << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/SolverLib.h>
+#include <scgms/rtl/FilesystemLib.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Best metric of a solver at a moment of its benchmark run
+ */
+struct TSolver_Benchmark_Sample {
+	// since the start of the solver, in [ms]
+	double elapsed_ms = 0.0;
+	size_t generation = 0;
+	solver::TFitness best_metric = solver::Nan_Fitness;
+};
+
+/*
+ * Outcome of a single solver of a benchmark
+ */
+struct TSolver_Benchmark_Result {
+	GUID solver_id = Invalid_GUID;
+	std::wstring description;
+	// S_FALSE while the solver did not run yet
+	HRESULT result = S_FALSE;
+
+	double wall_time_ms = 0.0;
+	// objective evaluations, each of them being a run of a filter chain
+	size_t evaluations = 0;
+	size_t generations = 0;
+	solver::TFitness best_metric = solver::Nan_Fitness;
+	// every improvement of the best metric, and the final state
+	std::vector<TSolver_Benchmark_Sample> trace;
+
+	double Evaluations_Per_Second() const;
+};
+
+/*
+ * Runs several solvers, one after another, on the same parameters of the same configuration with the same budget,
+ * so that their throughput and the quality they reach can be compared
+ *
+ * Every solver optimizes its own copy of the configuration, the original one is never modified.
+ */
+class CSolver_Benchmark {
+	protected:
+		scgms::SFilter_Chain_Configuration mConfiguration;
+		const std::vector<size_t> mFilter_Indices;
+		const std::vector<std::wstring> mParameter_Names;
+		const size_t mPopulation_Size;
+		const size_t mMax_Generations;
+
+		// guards mResults
+		mutable std::mutex mResults_Mtx;
+		std::vector<TSolver_Benchmark_Result> mResults;
+
+		// progress of the solver running at the moment; written by the solver
+		solver::TSolver_Progress mProgress = solver::Null_Solver_Progress;
+		std::atomic<size_t> mCurrent_Solver{ 0 };
+		std::atomic<bool> mCancel_Requested{ false };
+		// filters the solver running at the moment had created, in all the chains it evaluated
+		std::atomic<size_t> mCreated_Filters{ 0 };
+
+		HRESULT Run_Solver(const size_t index, refcnt::Swstr_list errors);
+		static HRESULT IfaceCalling On_Filter_Created(scgms::IFilter *filter, const void* data);
+
+	public:
+		CSolver_Benchmark(scgms::SFilter_Chain_Configuration configuration, std::vector<size_t> filter_indices, std::vector<std::wstring> parameter_names,
+			const size_t population_size, const size_t max_generations);
+
+		// runs the solvers one by one and blocks until all of them finish (or the benchmark is cancelled);
+		// S_OK if at least one solver succeeded
+		HRESULT Run(const std::vector<GUID>& solvers, refcnt::Swstr_list errors);
+		// may be called from any thread
+		void Cancel();
+
+		// index of the solver running at the moment and its progress in [0, 1]
+		size_t Current_Solver() const;
+		double Current_Progress() const;
+
+		std::vector<TSolver_Benchmark_Result> Get_Results() const;
+
+		// writes the comparison of the solvers to given CSV file and their metric traces to a "_trace" file next to it
+		bool Write_Report(const filesystem::path& path) const;
+};
+
+// entry point of the headless benchmark mode; arguments are the application arguments following the mode switch
+int Benchmark_Main(const std::vector<std::wstring>& arguments);
@@ -34,6 +34,7 @@
  *    Volume 177, pp. 354-362, 2020
  */
 
+#include <QtCore/QCoreApplication>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QMessageBox>
 
@@ -44,9 +45,36 @@
 #include <scgms/utils/QtUtils.h>
 
 #include "ui/main_window.h"
+#include "batch/headless_runner.h"
+#include "batch/solver_benchmark.h"
+
+#include <iostream>
+#include <cstring>
 
 int MainCalling main(int argc, char *argv[]) {
-    
+
+	// headless batch-run mode - no widgets are created at all, so it can run on machines without a display
+	if (argc > 1 && strcmp(argv[1], "--headless") == 0) {
+		QCoreApplication application(argc, argv);
+		QCoreApplication::setApplicationName(StdWStringToQString(dsGPredict3_App_Name));
+		QCoreApplication::setOrganizationDomain(StdWStringToQString(dsGPredict3_App_Domain));
+
+		if (!scgms::is_scgms_loaded()) {
+			std::wcerr << dsSCGMS_Not_Loaded << std::endl;
+			return 3;
+		}
+
+		std::vector<std::wstring> arguments;
+		const auto app_arguments = QCoreApplication::arguments();
+		for (int i = 2; i < app_arguments.size(); i++)
+			arguments.push_back(app_arguments[i].toStdWString());
+
+		// solver benchmark is the other headless mode
+		if (!arguments.empty() && arguments[0] == L"--benchmark")
+			return Benchmark_Main(std::vector<std::wstring>{ arguments.begin() + 1, arguments.end() });
+
+		return Headless_Main(arguments);
+	}
 
 	QApplication application(argc, argv);
     qGuiApp->setWindowIcon(QIcon(":/app/appicon.png"));
@@ -0,0 +1,346 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "batch_window.h"
+
+#include <scgms/lang/dstrings.h>
+#include <scgms/utils/QtUtils.h>
+#include <scgms/rtl/FilesystemLib.h>
+#include <scgms/rtl/rattime.h>
+
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QGridLayout>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QVBoxLayout>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QMessageBox>
+#include <QtCore/QRegularExpression>
+
+#include <thread>
+
+#ifndef MOC_DIR
+	#include "moc_batch_window.cpp"
+#endif
+
+std::atomic<CBatch_Window*> CBatch_Window::mInstance = nullptr;
+
+// interval [ms] of progress table refresh
+constexpr int Batch_Progress_Update_Interval = 250;
+
+enum class NBatch_Column : int {
+	Setup = 0,
+	Subject,
+	Segment,
+	State,
+	Events,
+	Device_Time,
+	Message,
+	count
+};
+
+CBatch_Window* CBatch_Window::Show_Instance(const std::wstring& current_setup_path, QWidget *owner) {
+
+	if (mInstance) {
+		mInstance.load()->showMaximized();
+		return mInstance;
+	}
+
+	CBatch_Window* tmp = nullptr;
+	bool created = mInstance.compare_exchange_strong(tmp, new CBatch_Window(current_setup_path, owner));
+
+	if (created) {
+		mInstance.load()->showMaximized();
+	}
+
+	return mInstance;
+}
+
+CBatch_Window::CBatch_Window(const std::wstring& current_setup_path, QWidget *owner) : QMdiSubWindow(owner) {
+	Setup_UI();
+
+	if (!current_setup_path.empty()) {
+		lbxSetups->addItem(QString::fromStdWString(current_setup_path));
+		edtOutput_Dir->setText(QString::fromStdWString((filesystem::path{ current_setup_path }.parent_path() / "batch_results").wstring()));
+	}
+}
+
+CBatch_Window::~CBatch_Window() {
+	if (mProgress_Timer)
+		mProgress_Timer->stop();
+
+	// executor cancels the running chains and waits for them
+	mExecutor.reset();
+
+	mInstance = nullptr;
+}
+
+void CBatch_Window::Setup_UI() {
+	setWindowTitle(tr("Batch Run"));
+	setWindowIcon(QIcon(":/app/appicon.png"));
+
+	QWidget* content = new QWidget(this);
+	QVBoxLayout* main_layout = new QVBoxLayout{};
+
+	QWidget* settings = new QWidget(content);
+	{
+		QGridLayout* layout = new QGridLayout{};
+
+		lbxSetups = new QListWidget{ settings };
+		lbxSetups->setSelectionMode(QAbstractItemView::SelectionMode::ExtendedSelection);
+
+		QPushButton* btnAdd_Setups = new QPushButton{ tr(dsAdd) };
+		QPushButton* btnRemove_Setup = new QPushButton{ tr(dsRemove) };
+		QWidget* setup_buttons = new QWidget{ settings };
+		{
+			QVBoxLayout* ly = new QVBoxLayout{};
+			ly->addWidget(btnAdd_Setups);
+			ly->addWidget(btnRemove_Setup);
+			ly->addStretch();
+			setup_buttons->setLayout(ly);
+		}
+
+		edtSubject_Ids = new QLineEdit{ settings };
+		edtSubject_Ids->setPlaceholderText(tr("e.g. 1, 2, 5 (empty keeps the subject of the setup)"));
+		edtSegment_Ids = new QLineEdit{ settings };
+		edtSegment_Ids->setPlaceholderText(tr("e.g. 10, 11, 12 (empty keeps the segments of the setup)"));
+
+		edtOutput_Dir = new QLineEdit{ settings };
+		QPushButton* btnBrowse = new QPushButton{ tr("...") };
+
+		spbThread_Count = new QSpinBox{ settings };
+		const int cores = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+		spbThread_Count->setRange(1, 4 * cores);
+		spbThread_Count->setValue(cores);
+
+		int row = 0;
+		layout->addWidget(new QLabel{ tr("Experimental setups") }, row, 0, Qt::AlignTop);
+		layout->addWidget(lbxSetups, row, 1);
+		layout->addWidget(setup_buttons, row++, 2);
+		layout->addWidget(new QLabel{ tr("Subject IDs") }, row, 0);
+		layout->addWidget(edtSubject_Ids, row++, 1);
+		layout->addWidget(new QLabel{ tr("Time segment IDs") }, row, 0);
+		layout->addWidget(edtSegment_Ids, row++, 1);
+		layout->addWidget(new QLabel{ tr("Output directory") }, row, 0);
+		layout->addWidget(edtOutput_Dir, row, 1);
+		layout->addWidget(btnBrowse, row++, 2);
+		layout->addWidget(new QLabel{ tr("Concurrent chains") }, row, 0);
+		layout->addWidget(spbThread_Count, row++, 1);
+
+		settings->setLayout(layout);
+
+		connect(btnAdd_Setups, SIGNAL(clicked()), this, SLOT(On_Add_Setups()));
+		connect(btnRemove_Setup, SIGNAL(clicked()), this, SLOT(On_Remove_Setup()));
+		connect(btnBrowse, SIGNAL(clicked()), this, SLOT(On_Browse_Output_Dir()));
+	}
+
+	QWidget* buttons = new QWidget(content);
+	{
+		QHBoxLayout* ly = new QHBoxLayout{};
+		ly->setAlignment(Qt::AlignRight);
+
+		btnStart = new QPushButton{ tr(dsStart) };
+		btnCancel = new QPushButton{ tr(dsStop) };
+		btnCancel->setEnabled(false);
+
+		ly->addWidget(btnStart);
+		ly->addWidget(btnCancel);
+		buttons->setLayout(ly);
+
+		connect(btnStart, SIGNAL(clicked()), this, SLOT(On_Start()));
+		connect(btnCancel, SIGNAL(clicked()), this, SLOT(On_Cancel()));
+	}
+
+	tblProgress = new QTableWidget{ content };
+	tblProgress->setColumnCount(static_cast<int>(NBatch_Column::count));
+	tblProgress->setHorizontalHeaderLabels(QStringList{} << tr("Setup") << tr("Subject") << tr("Segment") << tr("State") << tr("Events") << tr("Device time") << tr("Message"));
+	tblProgress->setShowGrid(true);
+	tblProgress->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	tblProgress->setSelectionBehavior(QAbstractItemView::SelectRows);
+	tblProgress->verticalHeader()->hide();
+	tblProgress->horizontalHeader()->setStretchLastSection(true);
+
+	main_layout->addWidget(settings);
+	main_layout->addWidget(buttons);
+	main_layout->addWidget(tblProgress, 1);
+	content->setLayout(main_layout);
+
+	setWidget(content);
+
+	mProgress_Timer = new QTimer(this);
+	mProgress_Timer->setInterval(Batch_Progress_Update_Interval);
+	connect(mProgress_Timer, SIGNAL(timeout()), this, SLOT(On_Update_Progress()));
+
+	// set the window to be freed upon closing
+	setAttribute(Qt::WA_DeleteOnClose, true);
+}
+
+void CBatch_Window::On_Add_Setups() {
+	QString selfilter;
+	const QStringList paths = QFileDialog::getOpenFileNames(this, tr(dsOpen_Experimental_Setup),
+		QString::fromStdWString(Get_Application_Dir().wstring()), tr(dsExperimental_Setup_File_Mask), &selfilter);
+
+	for (const auto& path : paths)
+		lbxSetups->addItem(path);
+
+	if (edtOutput_Dir->text().isEmpty() && !paths.isEmpty())
+		edtOutput_Dir->setText(QString::fromStdWString((filesystem::path{ paths.front().toStdWString() }.parent_path() / "batch_results").wstring()));
+}
+
+void CBatch_Window::On_Remove_Setup() {
+	for (auto item : lbxSetups->selectedItems())
+		delete item;
+}
+
+void CBatch_Window::On_Browse_Output_Dir() {
+	const QString path = QFileDialog::getExistingDirectory(this, tr("Output directory"), edtOutput_Dir->text());
+	if (!path.isEmpty())
+		edtOutput_Dir->setText(path);
+}
+
+static std::vector<int64_t> Parse_Id_List(const QString& text, bool& ok) {
+	std::vector<int64_t> result;
+	ok = true;
+
+	const auto parts = text.split(QRegularExpression("[,;\\s]+"), Qt::SkipEmptyParts);
+	for (const auto& part : parts) {
+		bool part_ok = false;
+		const int64_t id = part.toLongLong(&part_ok);
+		if (!part_ok) {
+			ok = false;
+			return {};
+		}
+		result.push_back(id);
+	}
+
+	return result;
+}
+
+void CBatch_Window::On_Start() {
+	if (mExecutor && !mExecutor->Is_Finished())
+		return;
+
+	std::vector<filesystem::path> setups;
+	for (int i = 0; i < lbxSetups->count(); i++)
+		setups.push_back(lbxSetups->item(i)->text().toStdWString());
+
+	bool subjects_ok, segments_ok;
+	const auto subject_ids = Parse_Id_List(edtSubject_Ids->text(), subjects_ok);
+	const auto segment_ids = Parse_Id_List(edtSegment_Ids->text(), segments_ok);
+
+	if (setups.empty() || !subjects_ok || !segments_ok || edtOutput_Dir->text().isEmpty()) {
+		QMessageBox::warning(this, tr(dsWarning), tr("Select at least one experimental setup and an output directory; IDs must be integer numbers."));
+		return;
+	}
+
+	auto jobs = CBatch_Executor::Expand_Jobs(setups, subject_ids, segment_ids, edtOutput_Dir->text().toStdWString());
+
+	mExecutor.reset();
+	mExecutor = std::make_unique<CBatch_Executor>(std::move(jobs), static_cast<size_t>(spbThread_Count->value()));
+
+	Populate_Progress_Table();
+
+	mExecutor->Start();
+	mProgress_Timer->start();
+	Update_Controls(true);
+}
+
+void CBatch_Window::On_Cancel() {
+	if (mExecutor)
+		mExecutor->Cancel();
+}
+
+void CBatch_Window::Update_Controls(const bool running) {
+	btnStart->setEnabled(!running);
+	btnCancel->setEnabled(running);
+	lbxSetups->setEnabled(!running);
+	edtSubject_Ids->setEnabled(!running);
+	edtSegment_Ids->setEnabled(!running);
+	edtOutput_Dir->setEnabled(!running);
+	spbThread_Count->setEnabled(!running);
+}
+
+void CBatch_Window::Populate_Progress_Table() {
+	const auto& jobs = mExecutor->Get_Jobs();
+
+	tblProgress->setRowCount(static_cast<int>(jobs.size()));
+	for (size_t i = 0; i < jobs.size(); i++) {
+		const int row = static_cast<int>(i);
+		const auto& job = jobs[i];
+
+		for (int col = 0; col < static_cast<int>(NBatch_Column::count); col++)
+			tblProgress->setItem(row, col, new QTableWidgetItem{});
+
+		tblProgress->item(row, static_cast<int>(NBatch_Column::Setup))->setText(QString::fromStdWString(job.setup_path.filename().wstring()));
+		tblProgress->item(row, static_cast<int>(NBatch_Column::Setup))->setToolTip(QString::fromStdWString(job.setup_path.wstring()));
+		tblProgress->item(row, static_cast<int>(NBatch_Column::Subject))->setText(job.subject_id ? QString::number(*job.subject_id) : QString{});
+		tblProgress->item(row, static_cast<int>(NBatch_Column::Segment))->setText(job.segment_id ? QString::number(*job.segment_id) : QString{});
+	}
+
+	On_Update_Progress();
+	tblProgress->resizeColumnsToContents();
+}
+
+void CBatch_Window::On_Update_Progress() {
+	if (!mExecutor)
+		return;
+
+	const auto progress = mExecutor->Get_Progress();
+
+	for (size_t i = 0; i < progress.size(); i++) {
+		const int row = static_cast<int>(i);
+		const auto& prog = progress[i];
+
+		QString state;
+		switch (prog.state) {
+			case NBatch_Job_State::Queued:		state = tr("Queued"); break;
+			case NBatch_Job_State::Running:		state = tr("Running"); break;
+			case NBatch_Job_State::Succeeded:	state = tr("Finished"); break;
+			case NBatch_Job_State::Failed:		state = tr("Failed"); break;
+			case NBatch_Job_State::Cancelled:	state = tr("Cancelled"); break;
+		}
+
+		tblProgress->item(row, static_cast<int>(NBatch_Column::State))->setText(state);
+		tblProgress->item(row, static_cast<int>(NBatch_Column::Events))->setText(QString::number(prog.event_count));
+		tblProgress->item(row, static_cast<int>(NBatch_Column::Device_Time))->setText(prog.device_time > 0.0 ? QString::fromStdWString(Rat_Time_To_Default_WStr(prog.device_time)) : QString{});
+		tblProgress->item(row, static_cast<int>(NBatch_Column::Message))->setText(QString::fromStdWString(prog.message));
+	}
+
+	if (mExecutor->Is_Finished()) {
+		mProgress_Timer->stop();
+		Update_Controls(false);
+	}
+}
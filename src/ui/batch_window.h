@@ -0,0 +1,86 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <QtWidgets/QMdiSubWindow>
+#include <QtWidgets/QListWidget>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QSpinBox>
+#include <QtWidgets/QTableWidget>
+#include <QtCore/QTimer>
+
+#include "../batch/batch_executor.h"
+
+/*
+ * Window for running many experimental setups (or one setup with many subjects/segments) concurrently
+ */
+class CBatch_Window : public QMdiSubWindow {
+	Q_OBJECT
+private:
+	static std::atomic<CBatch_Window*> mInstance;
+protected:
+	std::unique_ptr<CBatch_Executor> mExecutor;
+
+	QListWidget *lbxSetups = nullptr;
+	QLineEdit *edtSubject_Ids = nullptr;
+	QLineEdit *edtSegment_Ids = nullptr;
+	QLineEdit *edtOutput_Dir = nullptr;
+	QSpinBox *spbThread_Count = nullptr;
+	QPushButton *btnStart = nullptr;
+	QPushButton *btnCancel = nullptr;
+	QTableWidget *tblProgress = nullptr;
+	QTimer *mProgress_Timer = nullptr;
+
+	void Setup_UI();
+	void Populate_Progress_Table();
+	void Update_Controls(const bool running);
+protected slots:
+	void On_Add_Setups();
+	void On_Remove_Setup();
+	void On_Browse_Output_Dir();
+	void On_Start();
+	void On_Cancel();
+	void On_Update_Progress();
+public:
+	static CBatch_Window* Show_Instance(const std::wstring& current_setup_path, QWidget *owner);
+	CBatch_Window(const std::wstring& current_setup_path, QWidget *owner);
+	virtual ~CBatch_Window();
+};
@@ -60,8 +60,10 @@
 #include "helpers/filter_config_widgets.h"
 
 
-CFilter_Config_Window::CFilter_Config_Window(scgms::SFilter_Configuration_Link configuration, QWidget *parent) :
-	QDialog(parent), mConfiguration(configuration), mDescription(configuration.descriptor()) {
+CFilter_Config_Window::CFilter_Config_Window(scgms::SFilter_Configuration_Link configuration, QWidget *parent,
+	scgms::SFilter_Chain_Configuration chain_configuration, const size_t filter_index) :
+	QDialog(parent), mConfiguration(configuration), mDescription(configuration.descriptor()),
+	mChain_Configuration(chain_configuration), mFilter_Index(filter_index) {
 
 
 	Setup_UI(configuration);
@@ -170,8 +172,10 @@ void CFilter_Config_Window::Setup_UI(scgms::SFilter_Configuration_Link configura
 						break;
 
 					case scgms::NParameter_Type::ptDouble_Array:
+					{
+						CModel_Bounds_Panel* bounds_panel = nullptr;
 						if (scgms::Has_Flags_All(mDescription.flags, scgms::NFilter_Flags::Encapsulated_Model)) {
-							container = new CModel_Bounds_Panel(parameter, nullptr, mDescription.id, this);
+							bounds_panel = new CModel_Bounds_Panel(parameter, nullptr, mDescription.id, this);
 						}
 						else {
 							// model bounds edit always requires model selection field
@@ -179,9 +183,14 @@ void CFilter_Config_Window::Setup_UI(scgms::SFilter_Configuration_Link configura
 								model_select = create_model_select(parameter, false);
 							}
 
-							container = new CModel_Bounds_Panel(parameter, dynamic_cast<QComboBox*>(model_select), Invalid_GUID, this);
+							bounds_panel = new CModel_Bounds_Panel(parameter, dynamic_cast<QComboBox*>(model_select), Invalid_GUID, this);
 						}
+
+						if (mChain_Configuration)
+							bounds_panel->Enable_Sweep(mChain_Configuration, mFilter_Index);
+						container = bounds_panel;
 						break;
+					}
 
 					case scgms::NParameter_Type::ptSubject_Id:
 						container = new CSelect_Subject_Panel{ mConfiguration, parameter, this };
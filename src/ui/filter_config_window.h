@@ -39,6 +39,7 @@
 #include <scgms/rtl/FilterLib.h>
 #include "helpers/general_container_edit.h"
 
+#include <limits>
 #include <vector>
 
 #include <QtWidgets/QDialog>
@@ -51,6 +52,10 @@ protected:
 
 	std::vector<filter_config_window::CContainer_Edit*> mContainer_Edits;
 
+	// chain containing the configured filter and its index, if known; model bounds panels offer a sensitivity sweep then
+	scgms::SFilter_Chain_Configuration mChain_Configuration;
+	const size_t mFilter_Index;
+
 	void Setup_UI(scgms::SFilter_Configuration_Link configuration);
 	void Commit_Parameters();	//from controls to configuration
 protected slots:
@@ -58,5 +63,6 @@ protected slots:
 	void On_Cancel();
 	void On_Apply();
 public:
-	CFilter_Config_Window(scgms::SFilter_Configuration_Link configuration, QWidget *parent);	
+	CFilter_Config_Window(scgms::SFilter_Configuration_Link configuration, QWidget *parent,
+		scgms::SFilter_Chain_Configuration chain_configuration = {}, const size_t filter_index = std::numeric_limits<size_t>::max());
 };
@@ -41,6 +41,7 @@
 
 #include "filter_config_window.h"
 #include "helpers/FilterListItem.h"
+#include "helpers/descriptor_cache.h"
 #include "simulation_window.h"
 
 #include <QtWidgets/QSplitter>
@@ -128,7 +129,7 @@ void CFilters_Window::Setup_UI() {
 
 	//add the available filters
 	{
-		const auto &filters = scgms::get_filter_descriptor_list();
+		const auto &filters = CDescriptor_Cache::Get_Instance().Filters();
 		for (const auto &filter : filters) {
 			CFilter_List_Item *tmp = new CFilter_List_Item(filter);
 			lbxAvailable_Filters->addItem(tmp);
@@ -140,8 +141,7 @@ void CFilters_Window::Setup_UI() {
 
 	//add the  applied filters
 	mFilter_Chain_Configuration.for_each([this](scgms::SFilter_Configuration_Link link) {
-		CFilter_List_Item *tmp = new CFilter_List_Item(link);
-		tmp->Refresh();
+		CFilter_List_Item *tmp = new CFilter_List_Item(link);	//refreshes itself
 		lbxApplied_Filters->addItem(tmp);
 	});
 
@@ -237,7 +237,7 @@ void CFilters_Window::On_Remove_Filter()
 void CFilters_Window::Configure_Filter(QListWidgetItem *item) {
 	CFilter_List_Item* filter = static_cast<CFilter_List_Item*>(item);
 
-	CFilter_Config_Window *config_wnd = new CFilter_Config_Window( filter->configuration(), nullptr );
+	CFilter_Config_Window *config_wnd = new CFilter_Config_Window( filter->configuration(), nullptr, mFilter_Chain_Configuration, static_cast<size_t>(lbxApplied_Filters->row(item)) );
 	connect(config_wnd, SIGNAL(destroyed()), this, SLOT(On_Filter_Configure_Complete()));
 	config_wnd->show();
 }
@@ -35,6 +35,7 @@
  */
 
 #include "FilterListItem.h"
+#include "descriptor_cache.h"
 #include <scgms/rtl/UILib.h>
 
 #include <QtCore/QObject>
@@ -61,7 +62,7 @@ void CFilter_List_Item::Refresh()
 {
 	QString text = QString::fromWCharArray(mDescriptor.description);
 
-	auto models = scgms::get_model_descriptor_list();
+	const CDescriptor_Cache& descriptors = CDescriptor_Cache::Get_Instance();
 
 	// splitter appending logic - at first, apply " - " to split name from description, then apply ", " to split description items
 	bool splitterAppended = false;
@@ -91,23 +92,11 @@ void CFilter_List_Item::Refresh()
 			switch (cfg.type()) {
 				
 				case scgms::NParameter_Type::ptModel_Produced_Signal_Id: {		// model signal - append signal name
-							bool found = false;
-							for (auto& model : models)
-							{
-								for (size_t i = 0; i < model.number_of_calculated_signals; i++) {
-									HRESULT rc;
-									if (model.calculated_signal_ids[i] == cfg.as_guid(rc))
-										if (rc == S_OK) {
-											appendSplitter();
-											const std::wstring sig_name = mSignal_Descriptors.Get_Name(model.calculated_signal_ids[i]);
-											text += QString::fromWCharArray(sig_name.c_str());  //model.calculated_signal_names[i]);
-											found = true;
-											break;
-										}
-								}
-
-								if (found)
-									break;
+							HRESULT rc;
+							const GUID signal_id = cfg.as_guid(rc);
+							if ((rc == S_OK) && descriptors.Find_Signal_Model(signal_id)) {
+								appendSplitter();
+								text += QString::fromStdWString(descriptors.Signal_Name(signal_id));
 							}
 						};
 					break;
@@ -115,14 +104,12 @@ void CFilter_List_Item::Refresh()
 				
 				case scgms::NParameter_Type::ptSignal_Model_Id:
 				case scgms::NParameter_Type::ptDiscrete_Model_Id: {		// model - append model description
-							for (auto& model : models) {
-								HRESULT rc;
-								if (model.id == cfg.as_guid(rc))
-									if (rc == S_OK) {
-										appendSplitter();
-										text += QString::fromWCharArray(model.description);
-										break;
-									}
+							HRESULT rc;
+							const GUID model_id = cfg.as_guid(rc);
+							const scgms::TModel_Descriptor* model = rc == S_OK ? descriptors.Find_Model(model_id) : nullptr;
+							if (model) {
+								appendSplitter();
+								text += QString::fromWCharArray(model->description);
 							}
 						};
 
@@ -132,7 +119,7 @@ void CFilter_List_Item::Refresh()
 				case scgms::NParameter_Type::ptSignal_Id: {			//masking, mapping and decoupling filters
 							auto get_sig_name = [&](bool& ok) {
 								HRESULT rc;
-								std::wstring sig_name = mSignal_Descriptors.Get_Name(cfg.as_guid(rc));
+								std::wstring sig_name = descriptors.Signal_Name(cfg.as_guid(rc));
 								ok = rc == S_OK;
 								return sig_name;
 							};
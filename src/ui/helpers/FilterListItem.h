@@ -44,7 +44,6 @@
 
 class CFilter_List_Item : public QListWidgetItem {
 	protected:
-		const scgms::CSignal_Description mSignal_Descriptors{};
 		const scgms::TFilter_Descriptor mDescriptor;
 		scgms::SFilter_Configuration_Link mConfiguration;
 	public:
@@ -36,6 +36,8 @@
 
 #include "Model_Bounds_Panel.h"
 #include "general_container_edit.h"
+#include "descriptor_cache.h"
+#include "../parameter_sweep_dialog.h"
 
 #include <scgms/lang/dstrings.h>
 #include <scgms/rtl/UILib.h>
@@ -338,6 +340,11 @@ CModel_Bounds_Panel::CModel_Bounds_Panel(scgms::SFilter_Parameter parameter, QCo
 		connect(btn, SIGNAL(clicked()), this, SLOT(On_Reset_Upper()));
 		reset_layout->addWidget(btn);
 
+		btnSweep = new QPushButton(tr("Sensitivity sweep..."));
+		btnSweep->setVisible(false);
+		connect(btnSweep, SIGNAL(clicked()), this, SLOT(On_Sweep()));
+		reset_layout->addWidget(btnSweep);
+
 		mLayout->addLayout(reset_layout);
 	}
 	
@@ -411,6 +418,32 @@ void CModel_Bounds_Panel::On_Reset_Upper() {
 	Reset_Parameters(mModel->mUpper_Bounds, [](const scgms::TModel_Descriptor& model)->const double* {return model.upper_bound; });
 }
 
+void CModel_Bounds_Panel::Enable_Sweep(scgms::SFilter_Chain_Configuration configuration, const size_t filter_index) {
+	mSweep_Configuration = configuration;
+	mSweep_Filter_Index = filter_index;
+	btnSweep->setVisible(static_cast<bool>(mSweep_Configuration));
+}
+
+void CModel_Bounds_Panel::On_Sweep() {
+	const size_t count = mModel->mDefault_Values.size();
+	if (count == 0)
+		return;
+
+	// names of the parameters in the data order, i.e.; without the segment heading rows
+	std::vector<QString> names(count);
+	for (int row = 0; row < mModel->rowCount(); row++) {
+		auto [non_empty_line, data_idx] = mModel->UI_Idx_To_Data_Idx(row);
+		if (non_empty_line && data_idx < count)
+			names[data_idx] = mModel->headerData(row, Qt::Vertical, Qt::DisplayRole).toString();
+	}
+
+	// sweeps the values currently edited, even if not stored yet
+	CParameter_Sweep_Dialog *dlg = new CParameter_Sweep_Dialog{ mSweep_Configuration, mSweep_Filter_Index, mParameter.configuration_name(),
+		std::move(names), mModel->mLower_Bounds, mModel->mDefault_Values, mModel->mUpper_Bounds, this };
+	dlg->setAttribute(Qt::WA_DeleteOnClose);
+	dlg->exec();
+}
+
 bool CModel_Bounds_Panel::Get_Currently_Selected_Model(scgms::TModel_Descriptor& model) {
 	GUID selectedModelGUID = Invalid_GUID;
 
@@ -422,7 +455,7 @@ bool CModel_Bounds_Panel::Get_Currently_Selected_Model(scgms::TModel_Descriptor&
 	else
 		selectedModelGUID = mFixed_Model;
 
-	return scgms::get_model_descriptor_by_id(selectedModelGUID, model);
+	return CDescriptor_Cache::Get_Instance().Get_Model(selectedModelGUID, model);
 }
 
 void CModel_Bounds_Panel::fetch_parameter() {
@@ -48,6 +48,7 @@
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QLineEdit>
 #include <QtWidgets/QItemDelegate>
+#include <QtWidgets/QPushButton>
 
 #include <QtWidgets/QTableView>
 #include <QtCore/QAbstractTableModel>
@@ -113,6 +114,11 @@ protected:
 	// table model for error metrics
 	CModel_Bounds_Panel_internal::CParameters_Table_Model* mModel;
 
+	// chain and index of the filter the parameter belongs to; the sweep is available only when known
+	scgms::SFilter_Chain_Configuration mSweep_Configuration;
+	size_t mSweep_Filter_Index = 0;
+	QPushButton* btnSweep = nullptr;
+
 	// retrieves currently selected model; returns true on success
 	bool Get_Currently_Selected_Model(scgms::TModel_Descriptor& model);
 
@@ -121,11 +127,15 @@ protected slots:
 	void On_Reset_Lower();
 	void On_Reset_Defaults();
 	void On_Reset_Upper();
+	void On_Sweep();
 
 public:
 		//modelSelector can be nullptr, but fixed_model must be a valid model ID then
 	CModel_Bounds_Panel(scgms::SFilter_Parameter parameter, QComboBox* modelSelector, const GUID &fixed_model, QWidget *parent);
 
+	// enables the sensitivity sweep of the parameters, which replays given chain
+	void Enable_Sweep(scgms::SFilter_Chain_Configuration configuration, const size_t filter_index);
+
 	virtual void fetch_parameter() override;
 	virtual void store_parameter() override;
 };
\ No newline at end of file
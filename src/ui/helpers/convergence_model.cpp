@@ -0,0 +1,278 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "convergence_model.h"
+
+#include <scgms/utils/math_utils.h>
+
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "moc_convergence_model.cpp"
+
+// weight of the newest sample in the smoothed estimates
+constexpr double Convergence_Smoothing = 0.2;
+
+CConvergence_Model::CConvergence_Model(QObject *parent) : QAbstractTableModel(parent), mUsed_Objectives(solver::Maximum_Objectives_Count, false) {
+	//
+}
+
+int CConvergence_Model::rowCount(const QModelIndex &parent) const {
+	return parent.isValid() ? 0 : static_cast<int>(mPoints.size());
+}
+
+int CConvergence_Model::columnCount(const QModelIndex &parent) const {
+	return parent.isValid() ? 0 : static_cast<int>(2 + solver::Maximum_Objectives_Count);
+}
+
+QVariant CConvergence_Model::data(const QModelIndex &index, int role) const {
+	if (role != Qt::DisplayRole || !index.isValid() || static_cast<size_t>(index.row()) >= mPoints.size())
+		return QVariant();
+
+	const auto& point = mPoints[index.row()];
+	switch (index.column()) {
+		case 0: return QVariant::fromValue(static_cast<qulonglong>(point.generation));
+		case 1: return QVariant::fromValue(static_cast<qulonglong>(point.max_generation));
+		default: {
+			const double value = point.fitness[index.column() - 2];
+			return Is_Any_NaN(value) ? QVariant() : QVariant(value);
+		}
+	}
+}
+
+QVariant CConvergence_Model::headerData(int section, Qt::Orientation orientation, int role) const {
+	if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+		return QVariant();
+
+	switch (section) {
+		case 0: return tr("Gen.");
+		case 1: return tr("Max.");
+		default: return QString::number(section - 1);
+	}
+}
+
+void CConvergence_Model::Append(const TConvergence_Point& point) {
+	const int row = static_cast<int>(mPoints.size());
+	beginInsertRows(QModelIndex(), row, row);
+	mPoints.push_back(point);
+	endInsertRows();
+
+	for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++) {
+		if (!mUsed_Objectives[i] && !Is_Any_NaN(point.fitness[i])) {
+			mUsed_Objectives[i] = true;
+			emit On_Objective_Used(static_cast<int>(i));
+		}
+	}
+}
+
+void CConvergence_Model::Clear() {
+	beginResetModel();
+	mPoints.clear();
+	std::fill(mUsed_Objectives.begin(), mUsed_Objectives.end(), false);
+	endResetModel();
+}
+
+const std::vector<TConvergence_Point>& CConvergence_Model::Points() const {
+	return mPoints;
+}
+
+bool CConvergence_Model::Is_Objective_Used(const size_t objective) const {
+	return objective < mUsed_Objectives.size() && mUsed_Objectives[objective];
+}
+
+
+CConvergence_Plot::CConvergence_Plot(const CConvergence_Model* model, QWidget *parent) : QWidget(parent), mModel(model) {
+	setMinimumHeight(120);
+	setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void CConvergence_Plot::Set_Current_Generation(const size_t generation, const size_t max_generation) {
+	mCurrent_Generation = generation;
+	mMax_Generation = max_generation;
+	update();
+}
+
+QSize CConvergence_Plot::sizeHint() const {
+	return QSize{ 300, 200 };
+}
+
+void CConvergence_Plot::paintEvent(QPaintEvent* event) {
+	QPainter painter(this);
+	painter.setRenderHint(QPainter::Antialiasing, true);
+	painter.fillRect(rect(), palette().base());
+
+	const auto& points = mModel->Points();
+
+	const QFontMetrics metrics = painter.fontMetrics();
+	const int text_height = metrics.height();
+	const QRect area = rect().adjusted(metrics.horizontalAdvance(QStringLiteral("0.0000e+00")) + 6, 4, -8, -text_height - 4);
+	if (area.width() < 10 || area.height() < 10)
+		return;
+
+	painter.setPen(palette().color(QPalette::Mid));
+	painter.drawRect(area);
+
+	if (points.empty())
+		return;
+
+	const double generation_min = 0.0;
+	const double generation_max = static_cast<double>(std::max({ mMax_Generation, mCurrent_Generation, points.back().generation, static_cast<size_t>(1) }));
+
+	double value_min = std::numeric_limits<double>::max();
+	double value_max = std::numeric_limits<double>::lowest();
+	for (const auto& point : points) {
+		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++) {
+			if (!Is_Any_NaN(point.fitness[i])) {
+				value_min = std::min(value_min, point.fitness[i]);
+				value_max = std::max(value_max, point.fitness[i]);
+			}
+		}
+	}
+	if (value_min > value_max)
+		return;
+	if (value_max - value_min <= std::numeric_limits<double>::epsilon() * std::max(1.0, std::fabs(value_max)))
+		value_max = value_min + 1.0;
+
+	auto to_x = [&](const double generation) {
+		return area.left() + area.width() * (generation - generation_min) / (generation_max - generation_min);
+	};
+	auto to_y = [&](const double value) {
+		return area.bottom() - area.height() * (value - value_min) / (value_max - value_min);
+	};
+
+	static const std::array<QColor, 6> colors = { {
+		QColor{ 31, 119, 180 }, QColor{ 214, 39, 40 }, QColor{ 44, 160, 44 }, QColor{ 255, 127, 14 }, QColor{ 148, 103, 189 }, QColor{ 140, 86, 75 }
+	} };
+
+	const double end_generation = static_cast<double>(std::max(mCurrent_Generation, points.back().generation));
+
+	for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++) {
+		if (!mModel->Is_Objective_Used(i))
+			continue;
+
+		QPainterPath path;
+		bool started = false;
+		double last_y = 0.0;
+		int last_pixel = std::numeric_limits<int>::min();
+
+		for (const auto& point : points) {
+			const double value = point.fitness[i];
+			if (Is_Any_NaN(value))
+				continue;
+
+			const double x = to_x(static_cast<double>(point.generation));
+			const double y = to_y(value);
+
+			if (!started) {
+				path.moveTo(x, y);
+				started = true;
+			}
+			else {
+				// thousands of improvements share a few hundred pixels; a step within the same pixel column is just a vertical line
+				if (static_cast<int>(x) != last_pixel)
+					path.lineTo(x, last_y);
+				path.lineTo(x, y);
+			}
+
+			last_y = y;
+			last_pixel = static_cast<int>(x);
+		}
+
+		if (started)
+			path.lineTo(to_x(end_generation), last_y);
+
+		painter.setPen(QPen{ colors[i % colors.size()], 1.5 });
+		painter.drawPath(path);
+	}
+
+	painter.setPen(palette().color(QPalette::Text));
+	painter.drawText(QRect{ 0, area.top(), area.left() - 4, text_height }, Qt::AlignRight | Qt::AlignTop, QString::number(value_max, 'g', 5));
+	painter.drawText(QRect{ 0, area.bottom() - text_height, area.left() - 4, text_height }, Qt::AlignRight | Qt::AlignBottom, QString::number(value_min, 'g', 5));
+	painter.drawText(QRect{ area.left(), area.bottom() + 2, area.width(), text_height }, Qt::AlignLeft, QStringLiteral("0"));
+	painter.drawText(QRect{ area.left(), area.bottom() + 2, area.width(), text_height }, Qt::AlignRight, QString::number(static_cast<qulonglong>(generation_max)));
+}
+
+
+void CConvergence_Estimator::Reset() {
+	mValid = false;
+	mGenerations_Per_Ms = 0.0;
+	mImprovement_Per_Generation = 0.0;
+}
+
+void CConvergence_Estimator::Update(const size_t generation, const double fitness, const double time_ms) {
+	if (!mValid) {
+		mValid = true;
+		mLast_Generation = generation;
+		mLast_Time_Ms = time_ms;
+		mLast_Fitness = fitness;
+		return;
+	}
+
+	// time keeps accumulating until the next generation completes
+	if (generation <= mLast_Generation || time_ms <= mLast_Time_Ms)
+		return;
+
+	const double generations = static_cast<double>(generation - mLast_Generation);
+
+	const double speed = generations / (time_ms - mLast_Time_Ms);
+	mGenerations_Per_Ms = mGenerations_Per_Ms > 0.0 ? (1.0 - Convergence_Smoothing) * mGenerations_Per_Ms + Convergence_Smoothing * speed : speed;
+
+	// fitness is minimized; the improvement is relative, so it does not depend on the scale of the metric
+	if (std::isfinite(fitness) && std::isfinite(mLast_Fitness) && mLast_Fitness != 0.0) {
+		const double improvement = (mLast_Fitness - fitness) / std::fabs(mLast_Fitness) / generations;
+		mImprovement_Per_Generation = (1.0 - Convergence_Smoothing) * mImprovement_Per_Generation + Convergence_Smoothing * improvement;
+	}
+
+	mLast_Generation = generation;
+	mLast_Time_Ms = time_ms;
+	mLast_Fitness = fitness;
+}
+
+double CConvergence_Estimator::Remaining_Ms(const size_t max_generation) const {
+	if (!mValid || mGenerations_Per_Ms <= 0.0)
+		return -1.0;
+
+	return max_generation > mLast_Generation ? static_cast<double>(max_generation - mLast_Generation) / mGenerations_Per_Ms : 0.0;
+}
+
+double CConvergence_Estimator::Improvement_Per_Generation() const {
+	return mValid && mGenerations_Per_Ms > 0.0 ? mImprovement_Per_Generation : std::numeric_limits<double>::quiet_NaN();
+}
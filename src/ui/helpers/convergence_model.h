@@ -0,0 +1,126 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/SolverIface.h>
+
+#include <QtCore/QAbstractTableModel>
+#include <QtWidgets/QWidget>
+
+#include <vector>
+
+/*
+ * Best fitness reported by a solver at given generation
+ */
+struct TConvergence_Point {
+	size_t generation;
+	size_t max_generation;
+	solver::TFitness fitness;
+};
+
+/*
+ * Append-only store of solver improvements; the first two columns are the generations, then one column per objective
+ */
+class CConvergence_Model : public QAbstractTableModel {
+	Q_OBJECT
+protected:
+	std::vector<TConvergence_Point> mPoints;
+	// objectives which were ever reported, i.e. are not NaN
+	std::vector<bool> mUsed_Objectives;
+
+public:
+	explicit CConvergence_Model(QObject *parent = nullptr);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+	void Append(const TConvergence_Point& point);
+	void Clear();
+
+	const std::vector<TConvergence_Point>& Points() const;
+	bool Is_Objective_Used(const size_t objective) const;
+
+signals:
+	// an objective got its first valid value, so its column (and line) should be shown
+	void On_Objective_Used(int objective);
+};
+
+/*
+ * Line plot of the best fitness of every used objective over the generations
+ * Fitness is a step function, so every value lasts until the next improvement, the last one up to the current generation
+ */
+class CConvergence_Plot : public QWidget {
+protected:
+	const CConvergence_Model* mModel;
+	size_t mCurrent_Generation = 0;
+	size_t mMax_Generation = 0;
+
+	void paintEvent(QPaintEvent* event) override;
+public:
+	CConvergence_Plot(const CConvergence_Model* model, QWidget *parent = nullptr);
+
+	void Set_Current_Generation(const size_t generation, const size_t max_generation);
+
+	QSize sizeHint() const override;
+};
+
+/*
+ * Estimates the speed of the solver and how fast it still improves, from exponentially smoothed recent samples
+ * rather than from the average since the start, so it follows slowdowns of the later generations
+ */
+class CConvergence_Estimator {
+protected:
+	bool mValid = false;
+	size_t mLast_Generation = 0;
+	double mLast_Time_Ms = 0.0;
+	double mLast_Fitness = 0.0;
+
+	double mGenerations_Per_Ms = 0.0;
+	// relative improvement of the first objective per generation
+	double mImprovement_Per_Generation = 0.0;
+
+public:
+	void Reset();
+	void Update(const size_t generation, const double fitness, const double time_ms);
+
+	// remaining time in [ms] to reach max_generation; negative if unknown
+	double Remaining_Ms(const size_t max_generation) const;
+	// relative improvement of the first objective per generation; NaN if unknown
+	double Improvement_Per_Generation() const;
+};
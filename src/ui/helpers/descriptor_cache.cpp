@@ -0,0 +1,116 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "descriptor_cache.h"
+
+#include <cstdint>
+#include <cstring>
+
+size_t CDescriptor_Cache::TGUID_Hash::operator()(const GUID& id) const {
+	// GUIDs are random enough, so that folding their two halves makes a good hash
+	uint64_t halves[2];
+	static_assert(sizeof(halves) == sizeof(GUID), "GUID is expected to be 16 bytes long");
+	std::memcpy(halves, &id, sizeof(GUID));
+
+	return static_cast<size_t>(halves[0] ^ (halves[1] * 0x9E3779B97F4A7C15ULL));
+}
+
+CDescriptor_Cache::CDescriptor_Cache() : mFilters(scgms::get_filter_descriptor_list()), mModels(scgms::get_model_descriptor_list()) {
+
+	mSignal_Descriptors.for_each([this](const scgms::TSignal_Descriptor& desc) {
+		mSignals.push_back(desc);
+	});
+
+	for (size_t i = 0; i < mFilters.size(); i++)
+		mFilter_Index.emplace(mFilters[i].id, i);
+
+	for (size_t i = 0; i < mModels.size(); i++) {
+		mModel_Index.emplace(mModels[i].id, i);
+
+		// the first model calculating a signal wins, as the original linear searches did
+		for (size_t j = 0; j < mModels[i].number_of_calculated_signals; j++)
+			mSignal_Model_Index.emplace(mModels[i].calculated_signal_ids[j], i);
+	}
+}
+
+const CDescriptor_Cache& CDescriptor_Cache::Get_Instance() {
+	static const CDescriptor_Cache instance;
+	return instance;
+}
+
+const std::vector<scgms::TFilter_Descriptor>& CDescriptor_Cache::Filters() const {
+	return mFilters;
+}
+
+const std::vector<scgms::TModel_Descriptor>& CDescriptor_Cache::Models() const {
+	return mModels;
+}
+
+const std::vector<scgms::TSignal_Descriptor>& CDescriptor_Cache::Signals() const {
+	return mSignals;
+}
+
+const scgms::TFilter_Descriptor* CDescriptor_Cache::Find_Filter(const GUID& id) const {
+	auto itr = mFilter_Index.find(id);
+	return itr != mFilter_Index.end() ? &mFilters[itr->second] : nullptr;
+}
+
+const scgms::TModel_Descriptor* CDescriptor_Cache::Find_Model(const GUID& id) const {
+	auto itr = mModel_Index.find(id);
+	return itr != mModel_Index.end() ? &mModels[itr->second] : nullptr;
+}
+
+const scgms::TModel_Descriptor* CDescriptor_Cache::Find_Signal_Model(const GUID& signal_id) const {
+	auto itr = mSignal_Model_Index.find(signal_id);
+	return itr != mSignal_Model_Index.end() ? &mModels[itr->second] : nullptr;
+}
+
+bool CDescriptor_Cache::Get_Model(const GUID& id, scgms::TModel_Descriptor& model) const {
+	const scgms::TModel_Descriptor* found = Find_Model(id);
+	if (!found)
+		return false;
+
+	model = *found;
+	return true;
+}
+
+std::wstring CDescriptor_Cache::Signal_Name(const GUID& signal_id) const {
+	return mSignal_Descriptors.Get_Name(signal_id);
+}
+
+std::vector<scgms::TModel_Descriptor> CDescriptor_Cache::Model_Descriptor_List() {
+	return Get_Instance().Models();
+}
@@ -0,0 +1,89 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/UILib.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Descriptors of all the loaded filters, models and signals, enumerated just once and indexed by their GUIDs
+ * The filter libraries do not change while the application runs, hence the cache needs no invalidation
+ */
+class CDescriptor_Cache {
+	protected:
+		struct TGUID_Hash {
+			size_t operator()(const GUID& id) const;
+		};
+
+		std::vector<scgms::TFilter_Descriptor> mFilters;
+		std::vector<scgms::TModel_Descriptor> mModels;
+		std::vector<scgms::TSignal_Descriptor> mSignals;
+
+		// indices into the vectors above
+		std::unordered_map<GUID, size_t, TGUID_Hash> mFilter_Index;
+		std::unordered_map<GUID, size_t, TGUID_Hash> mModel_Index;
+		// model calculating the signal
+		std::unordered_map<GUID, size_t, TGUID_Hash> mSignal_Model_Index;
+
+		// enumerates the signals on its construction, so there is a single one shared by all the users of the cache
+		const scgms::CSignal_Description mSignal_Descriptors{};
+
+		CDescriptor_Cache();
+	public:
+		// enumerates the descriptors on the first call; safe to call from any thread
+		static const CDescriptor_Cache& Get_Instance();
+
+		const std::vector<scgms::TFilter_Descriptor>& Filters() const;
+		const std::vector<scgms::TModel_Descriptor>& Models() const;
+		const std::vector<scgms::TSignal_Descriptor>& Signals() const;
+
+		// return nullptr if there is no such descriptor
+		const scgms::TFilter_Descriptor* Find_Filter(const GUID& id) const;
+		const scgms::TModel_Descriptor* Find_Model(const GUID& id) const;
+		const scgms::TModel_Descriptor* Find_Signal_Model(const GUID& signal_id) const;
+
+		// same as scgms::get_model_descriptor_by_id
+		bool Get_Model(const GUID& id, scgms::TModel_Descriptor& model) const;
+		std::wstring Signal_Name(const GUID& signal_id) const;
+
+		// copy of the model list, for the templates taking a descriptor list getter
+		static std::vector<scgms::TModel_Descriptor> Model_Descriptor_List();
+};
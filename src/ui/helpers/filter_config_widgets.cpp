@@ -48,11 +48,12 @@ void CModel_Signal_Select_ComboBox::Refresh_Contents()
 		const GUID selectedModelGUID = *reinterpret_cast<const GUID*>(mModelSelector->currentData().toByteArray().constData());
 
 		// retrieve proper model
-		if (scgms::get_model_descriptor_by_id(selectedModelGUID, model))
+		const CDescriptor_Cache& descriptors = CDescriptor_Cache::Get_Instance();
+		if (descriptors.Get_Model(selectedModelGUID, model))
 		{
 			// add model signals to combobox
 			for (size_t i = 0; i < model.number_of_calculated_signals; i++) {
-				const std::wstring sig_name = mSignal_Descriptors.Get_Name(model.calculated_signal_ids[i]);
+				const std::wstring sig_name = descriptors.Signal_Name(model.calculated_signal_ids[i]);
 				addItem(StdWStringToQString(sig_name), QVariant{ QByteArray(reinterpret_cast<const char*>(&model.calculated_signal_ids[i]), sizeof(GUID)) });
 			}
 		}
@@ -72,10 +73,8 @@ CModel_Signal_Select_ComboBox::CModel_Signal_Select_ComboBox(scgms::SFilter_Para
 
 CAvailable_Signal_Select_ComboBox::CAvailable_Signal_Select_ComboBox(scgms::SFilter_Parameter parameter, QWidget *parent)	: filter_config_window::CGUIDCombo_Container_Edit(parameter, parent) {
 
-	const scgms::CSignal_Description signal_descriptors{};
-	signal_descriptors.for_each([this](const scgms::TSignal_Descriptor& desc) {
+	for (const auto& desc : CDescriptor_Cache::Get_Instance().Signals())
 		addItem(StdWStringToQString(desc.signal_description), QVariant{ QByteArray{reinterpret_cast<const char*>(&desc.id), sizeof(decltype(desc.id))} });
-	});
 
     model()->sort(0);
     setCurrentIndex(0);
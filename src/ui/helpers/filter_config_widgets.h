@@ -45,6 +45,8 @@
 #include <scgms/rtl/UILib.h>
 #include <scgms/utils/QtUtils.h>
 
+#include "descriptor_cache.h"
+
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QComboBox>
 
@@ -76,7 +78,7 @@ public:
 /*
  * Class for discrete/signal model selection; it specializes generic GUID combobox with a filter
  */
-class CModel_Select_ComboBox : public CGUID_Entity_ComboBox<scgms::TModel_Descriptor, scgms::get_model_descriptor_list, bool(*)(const scgms::TModel_Descriptor&)> {
+class CModel_Select_ComboBox : public CGUID_Entity_ComboBox<scgms::TModel_Descriptor, CDescriptor_Cache::Model_Descriptor_List, bool(*)(const scgms::TModel_Descriptor&)> {
 public:
     CModel_Select_ComboBox(scgms::SFilter_Parameter parameter, QWidget* parent, bool discrete)
         : CGUID_Entity_ComboBox(parameter, parent, discrete ? &CModel_Select_ComboBox::Model_Filter_Discrete : &CModel_Select_ComboBox::Model_Filter_Signal) {
@@ -100,7 +102,6 @@ class CModel_Signal_Select_ComboBox : public filter_config_window::CGUIDCombo_Co
 private:
 	// connected model selector combobox
 	const QComboBox *mModelSelector;
-    const scgms::CSignal_Description mSignal_Descriptors{};
 protected:
 	// refreshes combobox contents using model selector value
 	void Refresh_Contents();
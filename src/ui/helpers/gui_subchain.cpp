@@ -42,6 +42,18 @@
 #include <scgms/utils/DebugHelper.h>
 
 #include "../../ui/simulation_window.h"
+#include "../../utils/thread_pool.h"
+
+#include <algorithm>
+#include <future>
+
+namespace {
+	// dedicated pool, so that a slow drawing never delays the error cells queued on the shared pool and vice versa
+	CThread_Pool& Drawing_Pool() {
+		static CThread_Pool pool;
+		return pool;
+	}
+}
 
 CGUI_Filter_Subchain::CGUI_Filter_Subchain() : mChange_Available(false), mRunning(false) {
 
@@ -64,6 +76,14 @@ void CGUI_Filter_Subchain::Start() {
 	if (mRunning) Stop();
 
 	mRunning = true;
+	mAverage_Update_Cost_Ms = 0.0;
+	mEffective_Interval = mUpdate_Interval.load();
+	mLatest_Device_Time = std::numeric_limits<double>::quiet_NaN();
+
+	{
+		std::unique_lock<std::mutex> lck(mUpdater_Tasks_Mtx);
+		mAccepting_Updater_Tasks = true;
+	}
 
 	mUpdater_Thread = std::make_unique<std::thread>(&CGUI_Filter_Subchain::Run_Updater, this);
 }
@@ -71,6 +91,12 @@ void CGUI_Filter_Subchain::Start() {
 void CGUI_Filter_Subchain::Stop(bool update_gui) {
 	if (!mRunning) return;
 
+	// the updater serves the tasks queued so far before it ends; the later ones run in their callers' threads
+	{
+		std::unique_lock<std::mutex> lck(mUpdater_Tasks_Mtx);
+		mAccepting_Updater_Tasks = false;
+	}
+
 	// terminate updater thread
 	{
 		std::unique_lock<std::mutex> lck(mUpdater_Mtx);
@@ -93,29 +119,119 @@ void CGUI_Filter_Subchain::Relase_Filter_Bindings() {
 	mDrawing_Filter_Inspection = scgms::SDrawing_Filter_Inspection{ };
 	mDrawing_Filter_Inspection_v2.clear();
 	mAvailable_Plot_Views.clear();
-	mDrawing_Clock = 0;
+	mDrawing_v2_Clocks.clear();
+	mDirty_Drawings.fill(false);
+	mDirty_Drawings_v2.clear();
 	mLog_Filter_Inspection = scgms::SLog_Filter_Inspection{};
 }
 
 void CGUI_Filter_Subchain::Run_Updater()
 {
+	// since user may asynchronously request update of any component, we need to lock the mutex before updating
+	std::unique_lock<std::mutex> lck(mUpdater_Mtx);
+
+	mChange_Available = true;
+	bool visible_changed = false;
+
+	// the visible drawing changed, or the GUI thread posted a task
+	auto woken = [this, &visible_changed]() {
+		if (mVisible_Drawing_Changed.exchange(false))
+			visible_changed = true;
+		return !mRunning || visible_changed || mUpdater_Task_Posted;
+	};
+
 	while (mRunning) {
 
-		// since user may asynchronously request update of any component, we need to lock the mutex before updating
-		std::unique_lock<std::mutex> lck(mUpdater_Mtx);
+		const auto update_start = std::chrono::steady_clock::now();
 
-		// update if there was a change
-		//if (mChange_Available.exchange(false)) {
-		if (mRedraw_Mode == NRedraw_Mode::Periodic)
-			Update_GUI();
-		//}
+		if (mRedraw_Mode == NRedraw_Mode::Periodic) {
+			Update_GUI(false, mChange_Available.exchange(false));
+			Adapt_Update_Interval();
+		}
+		else if (visible_changed) {
+			// nothing is updated periodically, but the tab the user switched to still needs its drawing, e.g.; after a redraw
+			Update_Drawing(false);
+		}
 
-		// TODO: configurable delay, maybe even during simulation?
-		mUpdater_Cv.wait_for(lck, std::chrono::milliseconds(GUI_Subchain_Default_Drawing_Update));
+		visible_changed = false;
 
+		// do not update sooner than the (possibly prolonged) interval allows; switching the tab is served right away though
+		const auto update_deadline = update_start + std::chrono::milliseconds(mEffective_Interval.load());
+		while (mUpdater_Cv.wait_until(lck, update_deadline, woken) && mRunning && !visible_changed)
+			Serve_Updater_Tasks();
+
+		// then sleep until there is something new; solver progress does not come as events, so it is polled once per interval anyway
+		if (mRunning && !visible_changed) {
+			const auto poll_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(mUpdate_Interval.load());
+			while (mUpdater_Cv.wait_until(lck, poll_deadline, [this, &woken]() { return woken() || mChange_Available; })
+				&& mRunning && !visible_changed && !mChange_Available)
+				Serve_Updater_Tasks();
+		}
+
+		Serve_Updater_Tasks();
+
+		// hidden drawings are rendered lazily, but the filters are about to be released, so render them all now
 		if (!mRunning && mUpdateOnStop)
-			Update_GUI();
+			Update_GUI(true);
 	}
+
+	// tasks posted before the stop are served still with the filters bound
+	Serve_Updater_Tasks();
+}
+
+void CGUI_Filter_Subchain::Post_To_Updater(std::function<void()> task) {
+	bool queued = false;
+	{
+		std::unique_lock<std::mutex> lck(mUpdater_Tasks_Mtx);
+		if (mAccepting_Updater_Tasks) {
+			mUpdater_Tasks.push_back(std::move(task));
+			mUpdater_Task_Posted = true;
+			queued = true;
+		}
+	}
+
+	if (queued)
+		mUpdater_Cv.notify_all();
+	else {
+		// no updater to serve it, hence nobody to wait for
+		std::unique_lock<std::mutex> lck(mUpdater_Mtx);
+		task();
+	}
+}
+
+void CGUI_Filter_Subchain::Serve_Updater_Tasks() {
+	std::vector<std::function<void()>> tasks;
+	{
+		std::unique_lock<std::mutex> lck(mUpdater_Tasks_Mtx);
+		tasks.swap(mUpdater_Tasks);
+		mUpdater_Task_Posted = false;
+	}
+
+	for (auto& task : tasks)
+		task();
+}
+
+void CGUI_Filter_Subchain::Adapt_Update_Interval() {
+	const double cost_ms = std::chrono::duration<double, std::milli>(mStage_Times.Total()).count();
+
+	// smooth out single expensive updates (e.g.; the first render of a large drawing)
+	constexpr double Cost_Smoothing = 0.3;
+	mAverage_Update_Cost_Ms = mAverage_Update_Cost_Ms <= 0.0 ? cost_ms : Cost_Smoothing * cost_ms + (1.0 - Cost_Smoothing) * mAverage_Update_Cost_Ms;
+
+	// an update costing C ms may run at most once per C / budget ms to stay within the budget
+	const double budget = static_cast<double>(std::max(mCPU_Budget.load(), static_cast<size_t>(1))) / 100.0;
+	const size_t required = static_cast<size_t>(mAverage_Update_Cost_Ms / budget);
+
+	mEffective_Interval = std::min(std::max(mUpdate_Interval.load(), required), GUI_Subchain_Max_Drawing_Update);
+}
+
+void CGUI_Filter_Subchain::Notify_New_Data(const double device_time) {
+	mLatest_Device_Time.store(device_time, std::memory_order_relaxed);
+
+	// notified without the updater lock, so the chain never waits for a render in progress; a wake-up lost in a race
+	// just delays the update until the next poll
+	if (!mChange_Available.load(std::memory_order_relaxed) && !mChange_Available.exchange(true))
+		mUpdater_Cv.notify_all();
 }
 
 
@@ -130,6 +246,8 @@ void CGUI_Filter_Subchain::On_Filter_Configured(scgms::IFilter *filter) {
 		{
 			mAvailable_Plot_Views.emplace_back(caps.begin(), caps.end());
 			mDrawing_Filter_Inspection_v2.push_back(insp);
+			mDrawing_v2_Clocks.push_back(0);
+			mDirty_Drawings_v2.emplace_back(mAvailable_Plot_Views.back().size(), false);
 		}
 	}
 		
@@ -141,49 +259,154 @@ void CGUI_Filter_Subchain::On_Filter_Configured(scgms::IFilter *filter) {
 
 void CGUI_Filter_Subchain::Request_Redraw(std::vector<uint64_t>& segmentIds, std::vector<GUID>& signalIds, std::vector<GUID>& referenceSignalIds)
 {
-	std::unique_lock<std::mutex> lck(mUpdater_Mtx);
-
 	// store requested containers and request redraw
-	mDraw_Segment_Ids = refcnt::Create_Container_shared<uint64_t>(segmentIds.data(), segmentIds.data() + segmentIds.size());
-	mDraw_Signal_Ids = refcnt::Create_Container_shared<GUID>(signalIds.data(), signalIds.data() + signalIds.size());
-	mDraw_Reference_Signal_Ids = refcnt::Create_Container_shared<GUID>(referenceSignalIds.data(), referenceSignalIds.data() + referenceSignalIds.size());
+	auto segment_ids = refcnt::Create_Container_shared<uint64_t>(segmentIds.data(), segmentIds.data() + segmentIds.size());
+	auto signal_ids = refcnt::Create_Container_shared<GUID>(signalIds.data(), signalIds.data() + signalIds.size());
+	auto reference_signal_ids = refcnt::Create_Container_shared<GUID>(referenceSignalIds.data(), referenceSignalIds.data() + referenceSignalIds.size());
+
+	// the updater owns the containers while it draws, so it swaps them itself
+	Post_To_Updater([this, segment_ids, signal_ids, reference_signal_ids]() {
+		mDraw_Segment_Ids = segment_ids;
+		mDraw_Signal_Ids = signal_ids;
+		mDraw_Reference_Signal_Ids = reference_signal_ids;
+
+		// selection changed, so every drawing is outdated; the user asked for all of them, so they are generated in parallel
+		Mark_All_Drawings_Dirty();
+		Update_Drawing(true);
+	});
+}
+
+void CGUI_Filter_Subchain::Update_GUI(const bool all_drawings, const bool new_data)
+{
+	auto measure = [](auto&& stage) {
+		const auto start = std::chrono::steady_clock::now();
+		stage();
+		return std::chrono::steady_clock::now() - start;
+	};
+
+	// drawings are cheap to poll, as only the dirty ones get rendered
+	mStage_Times.drawing = measure([this, all_drawings]() { Update_Drawing(all_drawings); });
+	mStage_Times.log = new_data ? measure([this]() { Update_Log(); }) : std::chrono::steady_clock::duration::zero();
+	mStage_Times.errors = new_data ? measure([this]() { Update_Error_Metrics(); }) : std::chrono::steady_clock::duration::zero();
+	mStage_Times.solver = measure([this]() { Hint_Update_Solver_Progress(); });
+}
+
+void CGUI_Filter_Subchain::Collect_Drawing_Changes() {
+	// both New_Data_Available and Logical_Clock report a change just once, so remember it until the drawing gets rendered
 
-	mForceUpdate = true;
+	if (mDrawing_Filter_Inspection && mDrawing_Filter_Inspection->New_Data_Available() == S_OK)
+		mDirty_Drawings.fill(true);
 
-	Update_Drawing();
+	for (size_t i = 0; i < mDrawing_Filter_Inspection_v2.size(); i++) {
+		if (mDrawing_Filter_Inspection_v2[i]->Logical_Clock(&mDrawing_v2_Clocks[i]) == S_OK)
+			std::fill(mDirty_Drawings_v2[i].begin(), mDirty_Drawings_v2[i].end(), true);
+	}
 }
 
-void CGUI_Filter_Subchain::Update_GUI()
-{
-	Update_Drawing();
-	Update_Log();
-	Update_Error_Metrics();
-	Hint_Update_Solver_Progress();
+void CGUI_Filter_Subchain::Mark_All_Drawings_Dirty() {
+	mDirty_Drawings.fill(true);
+	for (auto& views : mDirty_Drawings_v2)
+		std::fill(views.begin(), views.end(), true);
+}
+
+void CGUI_Filter_Subchain::Update_Drawing(const bool all_drawings) {
+
+	Collect_Drawing_Changes();
+
+	if (all_drawings) {
+		std::vector<TDrawing_Target> targets;
+
+		for (size_t type = 0; type < (size_t)scgms::TDrawing_Image_Type::count; type++)
+			targets.push_back({ TDrawing_Target::NKind::Drawing, (scgms::TDrawing_Image_Type)type });
+
+		for (size_t i = 0; i < mDirty_Drawings_v2.size(); i++) {
+			for (size_t j = 0; j < mDirty_Drawings_v2[i].size(); j++)
+				targets.push_back({ TDrawing_Target::NKind::Drawing_v2, scgms::TDrawing_Image_Type::Graph, i, j });
+		}
+
+		// dirty flags are taken here, so that the workers touch no shared state of the subchain
+		targets.erase(std::remove_if(targets.begin(), targets.end(), [this](const auto& target) { return !Take_Dirty(target); }), targets.end());
+
+		// no inspection interface promises that it may draw concurrently, so every inspection draws its targets
+		// in a single task - the tasks run in parallel only across distinct filters
+		std::vector<std::vector<TDrawing_Target>> groups(1 + mDrawing_Filter_Inspection_v2.size());
+		for (const auto& target : targets)
+			groups[target.kind == TDrawing_Target::NKind::Drawing ? 0 : 1 + target.filter_index].push_back(target);
+
+		// every drawing is delivered as soon as it is finished; the whole batch takes as long as the slowest filter
+		auto& pool = Drawing_Pool();
+		std::vector<std::future<void>> results;
+		for (auto& group : groups) {
+			if (group.empty())
+				continue;
+
+			results.push_back(pool.Submit([this, group = std::move(group)]() {
+				for (const auto& target : group)
+					Draw_Target(target);
+			}));
+		}
+
+		for (auto& result : results)
+			result.wait();
+	}
+	else {
+		TDrawing_Target visible;
+		{
+			std::unique_lock<std::mutex> lck(mVisible_Drawing_Mtx);
+			visible = mVisible_Drawing;
+		}
+
+		Render_Drawing(visible);
+	}
+}
+
+void CGUI_Filter_Subchain::Render_Drawing(const TDrawing_Target& target) {
+	if (Take_Dirty(target))
+		Draw_Target(target);
+}
+
+bool CGUI_Filter_Subchain::Take_Dirty(const TDrawing_Target& target) {
+	if (target.kind == TDrawing_Target::NKind::Drawing) {
+		const size_t type_index = static_cast<size_t>(target.type);
+		if (!mDrawing_Filter_Inspection || type_index >= mDirty_Drawings.size() || !mDirty_Drawings[type_index])
+			return false;
+
+		mDirty_Drawings[type_index] = false;
+		return true;
+	}
+	else if (target.kind == TDrawing_Target::NKind::Drawing_v2) {
+		if (target.filter_index >= mDirty_Drawings_v2.size() || target.view_index >= mDirty_Drawings_v2[target.filter_index].size()
+			|| !mDirty_Drawings_v2[target.filter_index][target.view_index])
+			return false;
+
+		mDirty_Drawings_v2[target.filter_index][target.view_index] = false;
+		return true;
+	}
+
+	return false;
 }
 
-void CGUI_Filter_Subchain::Update_Drawing() {
+void CGUI_Filter_Subchain::Draw_Target(const TDrawing_Target& target) {
 
 	CSimulation_Window* const simwin = CSimulation_Window::Get_Instance();
 	if (!simwin)
 		return;
 
-	if (mDrawing_Filter_Inspection && (mForceUpdate || mDrawing_Filter_Inspection->New_Data_Available() == S_OK)) {
-
+	if (target.kind == TDrawing_Target::NKind::Drawing) {
 		auto svg = refcnt::Create_Container_shared<char>(nullptr, nullptr);
 
-		for (size_t type = 0; type < (size_t)scgms::TDrawing_Image_Type::count; type++) {
-			if (mDrawing_Filter_Inspection->Draw((scgms::TDrawing_Image_Type)type, scgms::TDiagnosis::NotSpecified, svg.get(), mDraw_Segment_Ids.get(), mDraw_Signal_Ids.get()) == S_OK) {
-				simwin->Drawing_Callback((scgms::TDrawing_Image_Type)type, scgms::TDiagnosis::NotSpecified, refcnt::Char_Container_To_String(svg.get()));
-			}
+		if (mDrawing_Filter_Inspection->Draw(target.type, scgms::TDiagnosis::NotSpecified, svg.get(), mDraw_Segment_Ids.get(), mDraw_Signal_Ids.get()) == S_OK) {
+			simwin->Drawing_Callback(target.type, scgms::TDiagnosis::NotSpecified, refcnt::Char_Container_To_String(svg.get()));
 		}
 
-		if (mDrawing_Filter_Inspection->Draw(scgms::TDrawing_Image_Type::Parkes, scgms::TDiagnosis::Type2, svg.get(), mDraw_Segment_Ids.get(), mDraw_Signal_Ids.get()) == S_OK) {
-			simwin->Drawing_Callback(scgms::TDrawing_Image_Type::Parkes, scgms::TDiagnosis::Type2, refcnt::Char_Container_To_String(svg.get()));
+		// Parkes' grid tab offers type 2 diagnosis as well
+		if (target.type == scgms::TDrawing_Image_Type::Parkes) {
+			if (mDrawing_Filter_Inspection->Draw(scgms::TDrawing_Image_Type::Parkes, scgms::TDiagnosis::Type2, svg.get(), mDraw_Segment_Ids.get(), mDraw_Signal_Ids.get()) == S_OK) {
+				simwin->Drawing_Callback(scgms::TDrawing_Image_Type::Parkes, scgms::TDiagnosis::Type2, refcnt::Char_Container_To_String(svg.get()));
+			}
 		}
 	}
-
-	if (!mDrawing_Filter_Inspection_v2.empty()) {
-
+	else if (target.kind == TDrawing_Target::NKind::Drawing_v2) {
 		uint64_t *seg_begin, *seg_end;
 		if (!mDraw_Segment_Ids || mDraw_Segment_Ids->get(&seg_begin, &seg_end) != S_OK) {
 			seg_begin = seg_end = nullptr;
@@ -211,31 +434,39 @@ void CGUI_Filter_Subchain::Update_Drawing() {
 		opts.signal_count = std::distance(sig_begin, sig_end);
 		opts.segments = seg_begin;
 		opts.segment_count = std::distance(seg_begin, seg_end);
-		
-		for (size_t i = 0; i < mDrawing_Filter_Inspection_v2.size(); i++)
-		{
-			auto& insp = mDrawing_Filter_Inspection_v2[i];
 
-			if (!mForceUpdate && insp->Logical_Clock(&mDrawing_Clock) != S_OK)
-				continue;
+		simwin->Update_Preferred_Drawing_Dimensions(target.filter_index, target.view_index, opts.width, opts.height);
 
-			for (size_t j = 0; j < mAvailable_Plot_Views[i].size(); j++)
-			{
-				simwin->Update_Preferred_Drawing_Dimensions(i, j, opts.width, opts.height);
-
-				auto svg = refcnt::Create_Container_shared<char>(nullptr, nullptr);
+		auto svg = refcnt::Create_Container_shared<char>(nullptr, nullptr);
 
-				if (insp->Draw(&mAvailable_Plot_Views[i][j].id, svg.get(), &opts) == S_OK)
-				{
-					auto str = refcnt::Char_Container_To_String(svg.get());
+		if (mDrawing_Filter_Inspection_v2[target.filter_index]->Draw(&mAvailable_Plot_Views[target.filter_index][target.view_index].id, svg.get(), &opts) == S_OK)
+		{
+			auto str = refcnt::Char_Container_To_String(svg.get());
 
-					simwin->Drawing_v2_Callback(i, j, str);
-				}
-			}
+			simwin->Drawing_v2_Callback(target.filter_index, target.view_index, str);
 		}
 	}
 }
 
+void CGUI_Filter_Subchain::Set_Visible_Drawing(const TDrawing_Target& target) {
+	{
+		std::unique_lock<std::mutex> lck(mVisible_Drawing_Mtx);
+		mVisible_Drawing = target;
+	}
+
+	// wake the updater, so that a dirty drawing does not wait for the next period
+	mVisible_Drawing_Changed = true;
+	mUpdater_Cv.notify_all();
+}
+
+void CGUI_Filter_Subchain::Request_Render(const TDrawing_Target& target, std::function<void()> on_rendered) {
+	Post_To_Updater([this, target, on_rendered]() {
+		Collect_Drawing_Changes();
+		Render_Drawing(target);
+		on_rendered();
+	});
+}
+
 void CGUI_Filter_Subchain::Update_Log()
 {
 	CSimulation_Window* const simwin = CSimulation_Window::Get_Instance();
@@ -243,16 +474,33 @@ void CGUI_Filter_Subchain::Update_Log()
 	if (!simwin || !mLog_Filter_Inspection)
 		return;
 
+	// everything available goes to the GUI thread as a single batch, converted to QString just once
+	QStringList batch;
+
 	std::shared_ptr<refcnt::wstr_list> lines;
 	while (mLog_Filter_Inspection.pop(lines)) {
-		simwin->Log_Callback(lines);
+		refcnt::wstr_container **begin, **end;
+		if (lines && lines->get(&begin, &end) == S_OK) {
+			batch.reserve(batch.size() + static_cast<int>(std::distance(begin, end)));
+
+			for (auto iter = begin; iter != end; iter++) {
+				wchar_t *str_begin, *str_end;
+				if ((*iter)->get(&str_begin, &str_end) == S_OK)
+					batch.append(QString::fromWCharArray(str_begin, static_cast<int>(std::distance(str_begin, str_end))));
+				else
+					batch.append(QString());
+			}
+		}
 	}
+
+	if (!batch.isEmpty())
+		simwin->Log_Callback(batch);
 }
 
 void CGUI_Filter_Subchain::Update_Error_Metrics() {
 	CSimulation_Window* const simwin = CSimulation_Window::Get_Instance();
 	if (!simwin) return;
-	simwin->Update_Errors();
+	simwin->Update_Errors(mLatest_Device_Time.load(std::memory_order_relaxed));
 }
 
 void CGUI_Filter_Subchain::Hint_Update_Solver_Progress()
@@ -275,6 +523,21 @@ void CGUI_Filter_Subchain::Set_Redraw_Mode(NRedraw_Mode mode)
 	mRedraw_Mode = mode;
 }
 
+void CGUI_Filter_Subchain::Set_Update_Interval(const size_t interval_ms)
+{
+	mUpdate_Interval = std::min(std::max(interval_ms, GUI_Subchain_Min_Drawing_Update), GUI_Subchain_Max_Drawing_Update);
+}
+
+void CGUI_Filter_Subchain::Set_CPU_Budget(const size_t percent)
+{
+	mCPU_Budget = std::min(std::max(percent, static_cast<size_t>(1)), static_cast<size_t>(100));
+}
+
+size_t CGUI_Filter_Subchain::Get_Effective_Update_Interval() const
+{
+	return mEffective_Interval;
+}
+
 std::vector<std::vector<std::wstring>> CGUI_Filter_Subchain::Get_Drawing_v2_Drawings() const
 {
 	std::vector<std::vector<std::wstring>> ret;
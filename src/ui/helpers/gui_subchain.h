@@ -41,25 +41,51 @@
 #include <scgms/rtl/FilterLib.h>
 #include <scgms/rtl/SolverLib.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <thread>
 #include <set>
 #include <mutex>
 #include <vector>
 #include <condition_variable>
+#include <functional>
+#include <limits>
 #include <set>
 
 // default time in [ms] to update drawing
 constexpr size_t GUI_Subchain_Default_Drawing_Update = 500;
+// limits of the update interval in [ms] the user may set
+constexpr size_t GUI_Subchain_Min_Drawing_Update = 50;
+constexpr size_t GUI_Subchain_Max_Drawing_Update = 10000;
+// default share of a single core in [%] the updater may spend on updating the GUI
+constexpr size_t GUI_Subchain_Default_CPU_Budget = 25;
 
 enum class NRedraw_Mode
 {
-	Periodic,		// default - refresh once every GUI_Subchain_Default_Drawing_Update ms
+	Periodic,		// default - refresh on new data, at most once per update interval and within the CPU budget
 	Shut_Down_Only,	// only redraw on shut_down
 
 	count
 };
 
+/*
+ * Identification of a drawing displayed in the simulation window
+ */
+struct TDrawing_Target {
+	enum class NKind {
+		None,			// no drawing visible (e.g.; log or errors tab)
+		Drawing,		// drawing filter image of given type
+		Drawing_v2		// drawing_v2 filter view
+	};
+
+	NKind kind = NKind::None;
+	scgms::TDrawing_Image_Type type = scgms::TDrawing_Image_Type::Graph;
+	size_t filter_index = 0;
+	size_t view_index = 0;
+};
+
 // this is exception from filter decomposition model: this filter is special, in this context it means, it "knows" about several filters
 // typically used by GUI - drawing filter, error metrics filter, log filter
 
@@ -75,9 +101,19 @@ class CGUI_Filter_Subchain {
 		std::vector<scgms::SDrawing_Filter_Inspection_v2> mDrawing_Filter_Inspection_v2;
 		scgms::SLog_Filter_Inspection mLog_Filter_Inspection;
 
-		ULONG mDrawing_Clock = 0;
+		// logical clocks of drawing_v2 filters, to recognize new data
+		std::vector<ULONG> mDrawing_v2_Clocks;
 		std::vector<std::vector<scgms::TPlot_Descriptor>> mAvailable_Plot_Views;
 
+		// drawings with new data not rendered yet; guarded by mUpdater_Mtx
+		std::array<bool, static_cast<size_t>(scgms::TDrawing_Image_Type::count)> mDirty_Drawings{};
+		std::vector<std::vector<bool>> mDirty_Drawings_v2;
+
+		// the drawing the user currently looks at; only this one is rendered periodically
+		std::mutex mVisible_Drawing_Mtx;
+		TDrawing_Target mVisible_Drawing;
+		std::atomic<bool> mVisible_Drawing_Changed{ false };
+
 		int mDrawing_v2_Width = 800;
 		int mDrawing_v2_Height = 600;
 
@@ -95,6 +131,38 @@ class CGUI_Filter_Subchain {
 		// flag to know whether to resume the updating thread
 		std::atomic<bool> mChange_Available;
 
+		// work requested by the GUI thread, served by the updater, so that the GUI never waits for an update in progress
+		std::mutex mUpdater_Tasks_Mtx;
+		std::vector<std::function<void()>> mUpdater_Tasks;
+		// tasks are queued only while the updater runs; otherwise they run right away in the caller's thread
+		bool mAccepting_Updater_Tasks = false;
+		std::atomic<bool> mUpdater_Task_Posted{ false };
+		// runs given task under mUpdater_Mtx - by the updater if it runs, or right away otherwise
+		void Post_To_Updater(std::function<void()> task);
+		// runs the queued tasks; caller holds mUpdater_Mtx
+		void Serve_Updater_Tasks();
+
+		// user-requested update interval in [ms]
+		std::atomic<size_t> mUpdate_Interval{ GUI_Subchain_Default_Drawing_Update };
+		// share of a single core in [%] the updater may consume
+		std::atomic<size_t> mCPU_Budget{ GUI_Subchain_Default_CPU_Budget };
+		// interval in [ms] actually used - the user-requested one, prolonged when updates get too expensive
+		std::atomic<size_t> mEffective_Interval{ GUI_Subchain_Default_Drawing_Update };
+
+		// durations of the individual stages of the last update
+		struct TUpdate_Stage_Times {
+			std::chrono::steady_clock::duration drawing{}, log{}, errors{}, solver{};
+
+			std::chrono::steady_clock::duration Total() const { return drawing + log + errors + solver; }
+		} mStage_Times;
+		// smoothed cost of a single update
+		double mAverage_Update_Cost_Ms = 0.0;
+		// computes mEffective_Interval from mStage_Times
+		void Adapt_Update_Interval();
+
+		// device time of the latest event that reached the end of the chain; NaN until the first one
+		std::atomic<double> mLatest_Device_Time{ std::numeric_limits<double>::quiet_NaN() };
+
 		// set of present signals in chain
 		std::set<GUID> m_presentSignals;
 
@@ -102,8 +170,6 @@ class CGUI_Filter_Subchain {
 		bool mRunning = false;
 		// should the GUI be updated one last time after simulation end?
 		bool mUpdateOnStop = false;
-		// should we update GUI even though filters do not signalize anything new?
-		bool mForceUpdate = false;
 		// was marker received?
 		bool mMarker_Received = false;
 
@@ -114,9 +180,18 @@ class CGUI_Filter_Subchain {
 		std::shared_ptr<refcnt::IVector_Container<GUID>> mDraw_Signal_Ids;
 		std::shared_ptr<refcnt::IVector_Container<GUID>> mDraw_Reference_Signal_Ids;
 
-		void Update_GUI();
-
-		void Update_Drawing();
+		// log and error metrics are refreshed only if new_data is set; drawings and solver progress are polled always
+		void Update_GUI(const bool all_drawings = false, const bool new_data = true);
+
+		// marks drawings with new data as dirty and renders the visible one (or all the dirty ones)
+		void Update_Drawing(const bool all_drawings = false);
+		void Collect_Drawing_Changes();
+		void Mark_All_Drawings_Dirty();
+		void Render_Drawing(const TDrawing_Target& target);
+		// clears dirty flag of the target; returns true if it was set and the target is valid
+		bool Take_Dirty(const TDrawing_Target& target);
+		// generates the drawing and delivers it to the simulation window; safe to run concurrently for targets of distinct filters
+		void Draw_Target(const TDrawing_Target& target);
 		void Update_Log();
 		void Update_Error_Metrics();
 		void Hint_Update_Solver_Progress();
@@ -138,6 +213,18 @@ class CGUI_Filter_Subchain {
 
 		void Set_Preferred_Drawing_Dimensions(const int width, const int height);
 		void Set_Redraw_Mode(NRedraw_Mode mode);
+		void Set_Update_Interval(const size_t interval_ms);
+		void Set_CPU_Budget(const size_t percent);
+		size_t Get_Effective_Update_Interval() const;
+
+		// called by the chain for every event that reached its end; cheap and never blocks the caller
+		void Notify_New_Data(const double device_time);
+
+		// publishes which drawing is visible; a dirty one gets rendered right away
+		void Set_Visible_Drawing(const TDrawing_Target& target);
+		// renders given drawing, if it has data not rendered yet (e.g.; before its tab state is saved), and then calls on_rendered;
+		// does not block the caller - on_rendered is called from the updater thread, or from the caller's one if the updater does not run
+		void Request_Render(const TDrawing_Target& target, std::function<void()> on_rendered);
 
 		std::vector<std::vector<std::wstring>> Get_Drawing_v2_Drawings() const;
 };
@@ -0,0 +1,87 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "solver_progress_channel.h"
+
+#include <cmath>
+
+bool CSolver_Progress_Channel::Publish(const GUID& solver, const size_t progress, const double best_metric, const scgms::TSolver_Status status) {
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	auto itr = mRecords.find(solver);
+	if (itr != mRecords.end()) {
+		const auto& record = itr->second;
+		// metric not available yet is NaN, which never equals itself
+		const bool same_metric = record.best_metric == best_metric || (std::isnan(record.best_metric) && std::isnan(best_metric));
+		if (record.progress == progress && same_metric && record.status == status)
+			return false;
+	}
+
+	TSolver_Progress_Record& record = mRecords[solver];
+	record.solver = solver;
+	record.progress = progress;
+	record.best_metric = best_metric;
+	record.status = status;
+	record.version = mVersion.load(std::memory_order_relaxed) + 1;
+
+	mVersion.store(record.version, std::memory_order_release);
+
+	return true;
+}
+
+std::vector<TSolver_Progress_Record> CSolver_Progress_Channel::Collect(uint64_t& seen_version) const {
+	std::vector<TSolver_Progress_Record> result;
+
+	// nothing has changed - no need to lock
+	if (mVersion.load(std::memory_order_acquire) == seen_version)
+		return result;
+
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	for (const auto& record : mRecords) {
+		if (record.second.version > seen_version)
+			result.push_back(record.second);
+	}
+
+	seen_version = mVersion.load(std::memory_order_relaxed);
+
+	return result;
+}
+
+void CSolver_Progress_Channel::Clear() {
+	std::unique_lock<std::mutex> lck(mMtx);
+	mRecords.clear();
+}
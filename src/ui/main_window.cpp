@@ -38,6 +38,7 @@
 #include "filters_window.h"
 #include "simulation_window.h"
 #include "parameters_optimization_dialog.h"
+#include "batch_window.h"
 
 #include <scgms/lang/dstrings.h>
 #include <scgms/utils/QtUtils.h>
@@ -91,6 +92,7 @@ void CMain_Window::Setup_UI() {
 	QAction* act_filters = new QAction{ tr(dsFilters), this };
 	QAction* act_simulation = new QAction{ tr(dsSimulation), this };
 	QAction* actOptimize_Parameters = new QAction{tr(dsOptimize_Parameters), this};
+	QAction* act_batch = new QAction{ tr("Batch Run"), this };
 
 	QWidget *centralWidget;
 	QVBoxLayout *verticalLayout;
@@ -121,6 +123,7 @@ void CMain_Window::Setup_UI() {
 	menu_Tools->addAction(act_filters);
 	menu_Tools->addAction(act_simulation);
 	menu_Tools->addAction(actOptimize_Parameters);
+	menu_Tools->addAction(act_batch);
 
 	setMenuBar(menuBar);
 	mainToolBar = new QToolBar();
@@ -181,6 +184,7 @@ void CMain_Window::Setup_UI() {
 	connect(act_filters, SIGNAL(triggered()), this, SLOT(On_Filters_Window()));
 	connect(act_simulation, SIGNAL(triggered()), this, SLOT(On_Simulation_Window()));
 	connect(actOptimize_Parameters, SIGNAL(triggered()), this, SLOT(On_Optimize_Parameters_Dialog()));
+	connect(act_batch, SIGNAL(triggered()), this, SLOT(On_Batch_Window()));
 
 	connect(mWindowMapper, SIGNAL(mapped(QWidget*)), this, SLOT(Set_Active_Sub_Window(QWidget*)));
 }
@@ -367,6 +371,10 @@ void CMain_Window::On_Simulation_Window() {
 	CSimulation_Window::Show_Instance(mFilter_Configuration.get(), pnlMDI_Content);
 }
 
+void CMain_Window::On_Batch_Window() {
+	CBatch_Window::Show_Instance(mFilter_Configuration_File_Path, pnlMDI_Content);
+}
+
 void CMain_Window::Check_And_Display_Error_Description(const HRESULT rc, refcnt::Swstr_list errors) {
 	QString error_string;
 
@@ -403,6 +411,7 @@ void CMain_Window::Open_Experimental_Setup(const std::wstring &file_path) {
 	Check_And_Display_Error_Description(rc, errors);
 
 	if (rc == S_OK) {
+		mFilter_Configuration_File_Path = file_path;
 		setWindowTitle(tr(dsGlucose_Prediction).arg(Native_Slash(file_path)));
 		On_Filters_Window();
 
@@ -437,6 +446,7 @@ void CMain_Window::On_New_Experimental_Setup() {
 	if (pnlMDI_Content->activeSubWindow()) return;	//some window has not closed
 
 	mFilter_Configuration = scgms::SPersistent_Filter_Chain_Configuration{};
+	mFilter_Configuration_File_Path.clear();
 	if (mFilter_Configuration) {
 		setWindowTitle(tr(dsGlucose_Prediction).arg(dsUnsaved_Experimental_Setup));
 		On_Filters_Window();
@@ -507,8 +517,10 @@ void CMain_Window::On_Save_Experimental_Setup_As() {
 	refcnt::Swstr_list errors;
 	const auto converted_path = filepath.toStdWString();
 	HRESULT rc = mFilter_Configuration->Save_To_File(converted_path.c_str(), errors.get());
-	if (rc == S_OK)
+	if (rc == S_OK) {
+		mFilter_Configuration_File_Path = converted_path;
 		setWindowTitle(tr(dsGlucose_Prediction).arg(Native_Slash(filepath.toStdWString())));
+	}
 
 	Push_Recent_File(filesystem::absolute(filesystem::path{ Native_Slash(filepath.toStdWString()).toStdWString() }));
 
@@ -107,6 +107,7 @@ private slots:
 	void On_Filters_Window();
 	void On_Simulation_Window();
 	void On_Optimize_Parameters_Dialog();
+	void On_Batch_Window();
 	void On_Open_Recent_Experimental_Setup(QAction* action);
 
 	void Set_Active_Sub_Window(QWidget *window);
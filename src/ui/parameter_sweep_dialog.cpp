@@ -0,0 +1,510 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "parameter_sweep_dialog.h"
+
+#include <scgms/lang/dstrings.h>
+#include <scgms/utils/QtUtils.h>
+
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+#include <QtWidgets/QBoxLayout>
+#include <QtWidgets/QGridLayout>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QSignalBlocker>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#ifndef MOC_DIR
+	#include "moc_parameter_sweep_dialog.cpp"
+#endif
+
+// how often [ms] the finished points are collected and plotted
+constexpr int Sweep_Progress_Update_Interval = 500;
+// a grid beyond this number of points is confirmed by the user first
+constexpr size_t Sweep_Large_Point_Count = 10000;
+// number of bins of the main effect line
+constexpr size_t Sweep_Effect_Bins = 10;
+
+namespace {
+	/*
+	 * Threads tearing down the cancelled sweeps of closed dialogs
+	 * No dialog waits for them, but the application does when it quits, so that no chain outlives it
+	 */
+	class CRetired_Sweeps {
+		protected:
+			struct TRetired {
+				std::thread thread;
+				std::shared_ptr<std::atomic<bool>> finished;
+			};
+
+			std::mutex mMtx;
+			std::vector<TRetired> mRetired;
+			bool mQuit_Connected = false;
+
+		public:
+			~CRetired_Sweeps() {
+				Join_All();
+			}
+
+			// GUI thread only
+			void Add(std::unique_ptr<CParameter_Sweep> sweep) {
+				if (!mQuit_Connected && QCoreApplication::instance()) {
+					QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, [this]() { Join_All(); });
+					mQuit_Connected = true;
+				}
+
+				auto finished = std::make_shared<std::atomic<bool>>(false);
+				std::thread thread{ [sweep = std::move(sweep), finished]() mutable {
+					sweep.reset();
+					*finished = true;
+				} };
+
+				std::unique_lock<std::mutex> lck(mMtx);
+
+				// the threads done by now are joined right away, so that the registry does not grow with every sweep
+				for (auto itr = mRetired.begin(); itr != mRetired.end(); ) {
+					if (*itr->finished) {
+						itr->thread.join();
+						itr = mRetired.erase(itr);
+					}
+					else
+						itr++;
+				}
+
+				mRetired.push_back({ std::move(thread), std::move(finished) });
+			}
+
+			void Join_All() {
+				std::vector<TRetired> retired;
+				{
+					std::unique_lock<std::mutex> lck(mMtx);
+					retired.swap(mRetired);
+				}
+
+				for (auto& sweep : retired)
+					sweep.thread.join();
+			}
+	};
+
+	CRetired_Sweeps& Retired_Sweeps() {
+		static CRetired_Sweeps sweeps;
+		return sweeps;
+	}
+}
+
+CSweep_Plot::CSweep_Plot(QWidget *parent) : QWidget(parent) {
+	setMinimumSize(320, 240);
+}
+
+QSize CSweep_Plot::sizeHint() const {
+	return QSize{ 640, 480 };
+}
+
+void CSweep_Plot::Set_Data(std::vector<QString> names, std::vector<TSweep_Point> points, const size_t metric_index) {
+	mNames = std::move(names);
+	mPoints = std::move(points);
+	mMetric_Index = metric_index;
+	update();
+}
+
+void CSweep_Plot::paintEvent(QPaintEvent* event) {
+	QPainter painter(this);
+	painter.setRenderHint(QPainter::Antialiasing, true);
+	painter.fillRect(rect(), palette().base());
+
+	if (mNames.empty() || mPoints.empty())
+		return;
+
+	// the metric shares its range across all the charts, so that the effects of the parameters compare at a glance
+	double metric_min = std::numeric_limits<double>::max();
+	double metric_max = std::numeric_limits<double>::lowest();
+	for (const auto& point : mPoints) {
+		if (point.result == S_OK && mMetric_Index < point.metric.size() && std::isfinite(point.metric[mMetric_Index])) {
+			metric_min = std::min(metric_min, point.metric[mMetric_Index]);
+			metric_max = std::max(metric_max, point.metric[mMetric_Index]);
+		}
+	}
+	const bool has_metric = metric_min <= metric_max;
+	if (has_metric && metric_max - metric_min <= std::numeric_limits<double>::epsilon() * std::max(1.0, std::fabs(metric_max)))
+		metric_max = metric_min + 1.0;
+
+	const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(mNames.size()))));
+	const int rows = static_cast<int>((mNames.size() + columns - 1) / columns);
+	const int cell_width = width() / columns;
+	const int cell_height = height() / rows;
+
+	const QFontMetrics metrics = painter.fontMetrics();
+	const int text_height = metrics.height();
+
+	for (size_t param = 0; param < mNames.size(); param++) {
+		const QRect cell{ static_cast<int>(param % columns) * cell_width, static_cast<int>(param / columns) * cell_height, cell_width, cell_height };
+		const QRect area = cell.adjusted(6, text_height + 4, -6, -text_height - 4);
+		if (area.width() < 10 || area.height() < 10)
+			continue;
+
+		double value_min = std::numeric_limits<double>::max();
+		double value_max = std::numeric_limits<double>::lowest();
+		for (const auto& point : mPoints) {
+			value_min = std::min(value_min, point.values[param]);
+			value_max = std::max(value_max, point.values[param]);
+		}
+		if (value_max <= value_min)
+			value_max = value_min + 1.0;
+
+		auto to_x = [&](const double value) {
+			return area.left() + area.width() * (value - value_min) / (value_max - value_min);
+		};
+		auto to_y = [&](const double metric) {
+			return area.bottom() - area.height() * (metric - metric_min) / (metric_max - metric_min);
+		};
+
+		// main effect - mean metric per bin of the parameter value
+		std::vector<double> bin_sum(Sweep_Effect_Bins, 0.0);
+		std::vector<size_t> bin_count(Sweep_Effect_Bins, 0);
+
+		painter.setPen(palette().color(QPalette::Mid));
+		painter.drawRect(area);
+
+		if (has_metric) {
+			painter.setPen(Qt::NoPen);
+			painter.setBrush(QColor{ 31, 119, 180, 128 });
+
+			for (const auto& point : mPoints) {
+				if (point.result != S_OK || mMetric_Index >= point.metric.size() || !std::isfinite(point.metric[mMetric_Index]))
+					continue;
+
+				const double metric = point.metric[mMetric_Index];
+				painter.drawEllipse(QPointF{ to_x(point.values[param]), to_y(metric) }, 2.0, 2.0);
+
+				const size_t bin = std::min(Sweep_Effect_Bins - 1, static_cast<size_t>(Sweep_Effect_Bins * (point.values[param] - value_min) / (value_max - value_min)));
+				bin_sum[bin] += metric;
+				bin_count[bin]++;
+			}
+
+			QPainterPath effect;
+			bool started = false;
+			double effect_min = std::numeric_limits<double>::max();
+			double effect_max = std::numeric_limits<double>::lowest();
+			for (size_t bin = 0; bin < Sweep_Effect_Bins; bin++) {
+				if (bin_count[bin] == 0)
+					continue;
+
+				const double mean = bin_sum[bin] / static_cast<double>(bin_count[bin]);
+				effect_min = std::min(effect_min, mean);
+				effect_max = std::max(effect_max, mean);
+
+				const QPointF pt{ to_x(value_min + (value_max - value_min) * (static_cast<double>(bin) + 0.5) / Sweep_Effect_Bins), to_y(mean) };
+				if (started)
+					effect.lineTo(pt);
+				else
+					effect.moveTo(pt);
+				started = true;
+			}
+
+			painter.setBrush(Qt::NoBrush);
+			painter.setPen(QPen{ QColor{ 214, 39, 40 }, 2.0 });
+			painter.drawPath(effect);
+
+			// spread of the main effect is a rough measure of how much the metric depends on the parameter
+			painter.setPen(palette().color(QPalette::Text));
+			const QString title = effect_min <= effect_max ? QString("%1 (%2)").arg(mNames[param]).arg(effect_max - effect_min, 0, 'g', 3) : mNames[param];
+			painter.drawText(QRect{ cell.left(), cell.top(), cell.width(), text_height + 2 }, Qt::AlignCenter, title);
+		}
+		else {
+			painter.setPen(palette().color(QPalette::Text));
+			painter.drawText(QRect{ cell.left(), cell.top(), cell.width(), text_height + 2 }, Qt::AlignCenter, mNames[param]);
+		}
+
+		painter.setPen(palette().color(QPalette::Text));
+		painter.drawText(QRect{ area.left(), area.bottom() + 2, area.width(), text_height }, Qt::AlignLeft, QString::number(value_min, 'g', 4));
+		painter.drawText(QRect{ area.left(), area.bottom() + 2, area.width(), text_height }, Qt::AlignRight, QString::number(value_max, 'g', 4));
+	}
+}
+
+CParameter_Sweep_Dialog::CParameter_Sweep_Dialog(scgms::SFilter_Chain_Configuration configuration, const size_t filter_index, const std::wstring& parameter_name,
+	std::vector<QString> names, std::vector<double> lower_bounds, std::vector<double> defaults, std::vector<double> upper_bounds, QWidget *parent)
+	: QDialog(parent), mConfiguration(configuration), mFilter_Index(filter_index), mParameter_Name(parameter_name), mNames(std::move(names)),
+	mLower_Bounds(std::move(lower_bounds)), mDefaults(std::move(defaults)), mUpper_Bounds(std::move(upper_bounds)) {
+
+	Setup_UI();
+	Update_Controls(false);
+}
+
+CParameter_Sweep_Dialog::~CParameter_Sweep_Dialog() {
+	Retire_Sweep();
+}
+
+void CParameter_Sweep_Dialog::Retire_Sweep() {
+	if (!mSweep)
+		return;
+
+	// the cancelled chains still take a while to shut down, and the destructor of the sweep waits for them
+	mSweep->Cancel();
+	Retired_Sweeps().Add(std::move(mSweep));
+}
+
+void CParameter_Sweep_Dialog::Setup_UI() {
+	setWindowTitle(tr("Parameter sensitivity sweep"));
+
+	QHBoxLayout* main_layout = new QHBoxLayout();
+	setLayout(main_layout);
+
+	QWidget* settings = new QWidget();
+	{
+		QVBoxLayout* settings_layout = new QVBoxLayout();
+		settings->setLayout(settings_layout);
+
+		// parameters with fixed values cannot be swept
+		lstParameters = new QListWidget{ settings };
+		for (size_t i = 0; i < mNames.size(); i++) {
+			QListWidgetItem* item = new QListWidgetItem{ mNames[i], lstParameters };
+			item->setData(Qt::UserRole, static_cast<qulonglong>(i));
+			const bool sweepable = mUpper_Bounds[i] > mLower_Bounds[i];
+			item->setFlags(sweepable ? (item->flags() | Qt::ItemIsUserCheckable) : (item->flags() & ~Qt::ItemIsEnabled));
+			item->setCheckState(sweepable ? Qt::Checked : Qt::Unchecked);
+		}
+		connect(lstParameters, SIGNAL(itemChanged(QListWidgetItem*)), this, SLOT(On_Design_Changed()));
+
+		cmbDesign = new QComboBox{ settings };
+		cmbDesign->addItem(tr("Latin hypercube"), static_cast<int>(NSweep_Design::Latin_Hypercube));
+		cmbDesign->addItem(tr("Grid"), static_cast<int>(NSweep_Design::Grid));
+		connect(cmbDesign, SIGNAL(currentIndexChanged(int)), this, SLOT(On_Design_Changed()));
+
+		spbSamples = new QSpinBox{ settings };
+		spbSamples->setRange(1, static_cast<int>(CParameter_Sweep::Max_Point_Count));
+		spbSamples->setValue(100);
+		connect(spbSamples, SIGNAL(valueChanged(int)), this, SLOT(On_Design_Changed()));
+
+		lblEvaluations = new QLabel{ settings };
+
+		QWidget* edits = new QWidget{ settings };
+		{
+			QGridLayout* edits_layout = new QGridLayout();
+			edits->setLayout(edits_layout);
+
+			edits_layout->addWidget(new QLabel{ tr("Design"), edits }, 0, 0);				edits_layout->addWidget(cmbDesign, 0, 1);
+			edits_layout->addWidget(new QLabel{ tr("Samples / points per axis"), edits }, 1, 0);	edits_layout->addWidget(spbSamples, 1, 1);
+			edits_layout->addWidget(lblEvaluations, 2, 1);
+		}
+
+		QWidget* buttons = new QWidget{ settings };
+		{
+			QHBoxLayout* buttons_layout = new QHBoxLayout();
+			buttons->setLayout(buttons_layout);
+
+			btnStart = new QPushButton{ tr("Start"), buttons };
+			btnCancel = new QPushButton{ dsStop, buttons };
+			btnSave = new QPushButton{ tr("Save results..."), buttons };
+
+			buttons_layout->addWidget(btnStart);	buttons_layout->addWidget(btnCancel);	buttons_layout->addWidget(btnSave);
+			connect(btnStart, SIGNAL(clicked()), this, SLOT(On_Start()));
+			connect(btnCancel, SIGNAL(clicked()), this, SLOT(On_Cancel()));
+			connect(btnSave, SIGNAL(clicked()), this, SLOT(On_Save()));
+		}
+
+		barProgress = new QProgressBar{ settings };
+		barProgress->setRange(0, 1);
+		barProgress->setValue(0);
+
+		settings_layout->addWidget(new QLabel{ tr("Swept parameters"), settings });
+		settings_layout->addWidget(lstParameters, 1);
+		settings_layout->addWidget(edits);
+		settings_layout->addWidget(buttons);
+		settings_layout->addWidget(barProgress);
+	}
+
+	QWidget* results = new QWidget();
+	{
+		QVBoxLayout* results_layout = new QVBoxLayout();
+		results->setLayout(results_layout);
+
+		// filled once the first point tells how many signal error filters the chain has
+		cmbMetric = new QComboBox{ results };
+		connect(cmbMetric, SIGNAL(currentIndexChanged(int)), this, SLOT(On_Update_Progress()));
+
+		mPlot = new CSweep_Plot{ results };
+
+		QHBoxLayout* metric_layout = new QHBoxLayout();
+		metric_layout->addWidget(new QLabel{ tr("Metric of"), results });
+		metric_layout->addWidget(cmbMetric, 1);
+
+		results_layout->addLayout(metric_layout);
+		results_layout->addWidget(mPlot, 1);
+	}
+
+	main_layout->addWidget(settings);
+	main_layout->addWidget(results, 1);
+
+	mProgress_Timer = new QTimer{ this };
+	mProgress_Timer->setInterval(Sweep_Progress_Update_Interval);
+	connect(mProgress_Timer, SIGNAL(timeout()), this, SLOT(On_Update_Progress()));
+
+	On_Design_Changed();
+}
+
+std::vector<size_t> CParameter_Sweep_Dialog::Checked_Parameters() const {
+	std::vector<size_t> checked;
+	for (int i = 0; i < lstParameters->count(); i++) {
+		if (lstParameters->item(i)->checkState() == Qt::Checked)
+			checked.push_back(static_cast<size_t>(lstParameters->item(i)->data(Qt::UserRole).toULongLong()));
+	}
+
+	return checked;
+}
+
+void CParameter_Sweep_Dialog::On_Design_Changed() {
+	const size_t dimensions = Checked_Parameters().size();
+	const size_t samples = static_cast<size_t>(spbSamples->value());
+
+	double evaluations = static_cast<double>(samples);
+	if (static_cast<NSweep_Design>(cmbDesign->currentData().toInt()) == NSweep_Design::Grid)
+		evaluations = dimensions > 0 ? std::pow(static_cast<double>(samples), static_cast<double>(dimensions)) : 0.0;
+
+	if (evaluations > static_cast<double>(CParameter_Sweep::Max_Point_Count))
+		lblEvaluations->setText(QString(tr("%1 chain runs, more than the limit of %2")).arg(evaluations, 0, 'g', 6).arg(CParameter_Sweep::Max_Point_Count));
+	else
+		lblEvaluations->setText(QString(tr("%1 chain runs")).arg(evaluations, 0, 'g', 6));
+}
+
+void CParameter_Sweep_Dialog::Update_Controls(const bool running) {
+	btnStart->setEnabled(!running);
+	btnCancel->setEnabled(running);
+	btnSave->setEnabled(!running && mSweep);
+	lstParameters->setEnabled(!running);
+	cmbDesign->setEnabled(!running);
+	spbSamples->setEnabled(!running);
+}
+
+void CParameter_Sweep_Dialog::On_Start() {
+	const std::vector<size_t> swept = Checked_Parameters();
+	if (swept.empty()) {
+		QMessageBox::warning(this, tr(dsWarning), tr("Check at least one parameter to sweep."));
+		return;
+	}
+
+	std::vector<double> lower, upper;
+	mSwept_Names.clear();
+	for (const size_t index : swept) {
+		lower.push_back(mLower_Bounds[index]);
+		upper.push_back(mUpper_Bounds[index]);
+		mSwept_Names.push_back(mNames[index]);
+	}
+
+	const size_t samples = static_cast<size_t>(spbSamples->value());
+	const bool grid = static_cast<NSweep_Design>(cmbDesign->currentData().toInt()) == NSweep_Design::Grid;
+
+	const size_t point_count = grid ? CParameter_Sweep::Grid_Point_Count(swept.size(), samples) : samples;
+	if (point_count > CParameter_Sweep::Max_Point_Count) {
+		QMessageBox::warning(this, tr("Parameter sensitivity sweep"), tr("The design needs more than %1 chain runs. Use fewer points or parameters.").arg(CParameter_Sweep::Max_Point_Count));
+		return;
+	}
+
+	if (grid && point_count > Sweep_Large_Point_Count) {
+		if (QMessageBox::question(this, tr("Parameter sensitivity sweep"), tr("The grid needs %1 chain runs. Do you want to continue?").arg(point_count)) != QMessageBox::Yes)
+			return;
+	}
+
+	// the previous sweep (if any) gets cancelled, without waiting for it
+	Retire_Sweep();
+	mSweep = std::make_unique<CParameter_Sweep>(mConfiguration, mFilter_Index, mParameter_Name, mLower_Bounds, mDefaults, mUpper_Bounds, swept);
+	mSweep->Start(point_count, grid ? CParameter_Sweep::Grid(lower, upper, samples) : CParameter_Sweep::Latin_Hypercube(lower, upper, samples));
+
+	cmbMetric->clear();
+	barProgress->setRange(0, static_cast<int>(point_count));
+	barProgress->setValue(0);
+
+	Update_Controls(true);
+	mProgress_Timer->start();
+	On_Update_Progress();
+}
+
+void CParameter_Sweep_Dialog::On_Cancel() {
+	if (mSweep)
+		mSweep->Cancel();
+}
+
+void CParameter_Sweep_Dialog::On_Save() {
+	if (!mSweep)
+		return;
+
+	const QString path = QFileDialog::getSaveFileName(this, tr("Save sweep results"), QString(), tr("CSV files (*.csv)"));
+	if (path.isEmpty())
+		return;
+
+	std::vector<std::wstring> names;
+	for (const auto& name : mSwept_Names)
+		names.push_back(name.toStdWString());
+
+	if (!mSweep->Write_CSV(path.toStdWString(), names))
+		QMessageBox::warning(this, tr(dsWarning), tr("Cannot write the sweep results to %1").arg(path));
+}
+
+void CParameter_Sweep_Dialog::On_Update_Progress() {
+	if (!mSweep)
+		return;
+
+	barProgress->setValue(static_cast<int>(mSweep->Finished_Count()));
+	Update_Plot();
+
+	if (mSweep->Is_Finished()) {
+		mProgress_Timer->stop();
+		Update_Controls(false);
+	}
+}
+
+void CParameter_Sweep_Dialog::Update_Plot() {
+	auto points = mSweep->Get_Points();
+
+	size_t metric_count = 0;
+	for (const auto& point : points)
+		metric_count = std::max(metric_count, point.metric.size());
+
+	if (static_cast<size_t>(cmbMetric->count()) < metric_count) {
+		const QSignalBlocker blocker{ cmbMetric };
+		for (size_t i = static_cast<size_t>(cmbMetric->count()); i < metric_count; i++)
+			cmbMetric->addItem(QString(tr("signal error filter %1")).arg(i + 1));
+	}
+
+	mPlot->Set_Data(mSwept_Names, std::move(points), static_cast<size_t>(std::max(cmbMetric->currentIndex(), 0)));
+}
@@ -0,0 +1,121 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/FilterLib.h>
+
+#include <QtWidgets/QDialog>
+#include <QtWidgets/QWidget>
+#include <QtWidgets/QListWidget>
+#include <QtWidgets/QComboBox>
+#include <QtWidgets/QSpinBox>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QProgressBar>
+#include <QtWidgets/QPushButton>
+#include <QtCore/QTimer>
+
+#include "../batch/parameter_sweep.h"
+
+#include <memory>
+#include <vector>
+
+/*
+ * Metric against each swept parameter, one small chart per parameter
+ * Besides the individual points, every chart shows the mean metric of equally wide bins of the parameter, i.e.; its main effect
+ */
+class CSweep_Plot : public QWidget {
+protected:
+	std::vector<QString> mNames;
+	std::vector<TSweep_Point> mPoints;
+	size_t mMetric_Index = 0;
+
+	void paintEvent(QPaintEvent* event) override;
+public:
+	explicit CSweep_Plot(QWidget *parent = nullptr);
+
+	void Set_Data(std::vector<QString> names, std::vector<TSweep_Point> points, const size_t metric_index);
+
+	QSize sizeHint() const override;
+};
+
+/*
+ * Sensitivity sweep of the parameters of a model - evaluates the configured chain for a Latin hypercube or a grid of parameter
+ * vectors within the bounds, concurrently on all cores, and plots the metric against every swept parameter
+ */
+class CParameter_Sweep_Dialog : public QDialog {
+	Q_OBJECT
+protected:
+	scgms::SFilter_Chain_Configuration mConfiguration;
+	const size_t mFilter_Index;
+	const std::wstring mParameter_Name;
+	const std::vector<QString> mNames;
+	const std::vector<double> mLower_Bounds, mDefaults, mUpper_Bounds;
+
+	std::unique_ptr<CParameter_Sweep> mSweep;
+	// names of the parameters swept by mSweep
+	std::vector<QString> mSwept_Names;
+
+	QListWidget *lstParameters = nullptr;
+	QComboBox *cmbDesign = nullptr;
+	QSpinBox *spbSamples = nullptr;
+	QLabel *lblEvaluations = nullptr;
+	QComboBox *cmbMetric = nullptr;
+	QProgressBar *barProgress = nullptr;
+	QPushButton *btnStart = nullptr;
+	QPushButton *btnCancel = nullptr;
+	QPushButton *btnSave = nullptr;
+	CSweep_Plot *mPlot = nullptr;
+	QTimer *mProgress_Timer = nullptr;
+
+	void Setup_UI();
+	// cancels the sweep and leaves waiting for its chains to a thread of its own, so that the GUI does not freeze
+	void Retire_Sweep();
+	std::vector<size_t> Checked_Parameters() const;
+	void Update_Controls(const bool running);
+	void Update_Plot();
+protected slots:
+	void On_Design_Changed();
+	void On_Start();
+	void On_Cancel();
+	void On_Save();
+	void On_Update_Progress();
+public:
+	// names and bounds are those of the model bounds panel, so the sweep uses even the values not applied yet
+	CParameter_Sweep_Dialog(scgms::SFilter_Chain_Configuration configuration, const size_t filter_index, const std::wstring& parameter_name,
+		std::vector<QString> names, std::vector<double> lower_bounds, std::vector<double> defaults, std::vector<double> upper_bounds, QWidget *parent);
+	virtual ~CParameter_Sweep_Dialog();
+};
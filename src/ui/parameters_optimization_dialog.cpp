@@ -52,19 +52,73 @@
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QProgressDialog>
-
+#include <QtWidgets/QSplitter>
+#include <QtWidgets/QListWidget>
+#include <QtWidgets/QDialogButtonBox>
+#include <QtWidgets/QFileDialog>
+#include <QtCore/QSettings>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QCryptographicHash>
+
+#include <algorithm>
 #include <thread>
 #include <chrono>
 #include <cmath>
 #include <future>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+
+#include "../batch/solver_benchmark.h"
+#include "../batch/chain_objective.h"
+#include "../batch/configuration_utils.h"
 
 #include "moc_parameters_optimization_dialog.cpp"
 
+// how often in [ms] the progress is written to the checkpoint, even if no better solution was found
+constexpr qint64 Checkpoint_Progress_Interval = 30000;
+// default length of a checkpointed segment; zero runs the solver in one piece, as restarting it from the best
+// solution discards its population - segmenting is up to the user, who trades that for crash resilience
+constexpr int Default_Checkpoint_Generations = 0;
+// limits of the progress refresh interval in [ms]; within them, the interval follows the duration of a generation
+constexpr int Progress_Min_Interval = 100;
+constexpr int Progress_Max_Interval = 2000;
+
+namespace {
+	// lexicographic comparison of the objectives; NaN objective is worse than any number
+	bool Is_Better_Fitness(const solver::TFitness& candidate, const solver::TFitness& reference) {
+		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++) {
+			const bool candidate_nan = Is_Any_NaN(candidate[i]);
+			const bool reference_nan = Is_Any_NaN(reference[i]);
+			if (candidate_nan || reference_nan) {
+				if (candidate_nan != reference_nan)
+					return reference_nan;
+				continue;
+			}
+
+			if (candidate[i] != reference[i])
+				return candidate[i] < reference[i];
+		}
+
+		return false;
+	}
+}
+
 CParameters_Optimization_Dialog::CParameters_Optimization_Dialog(scgms::SFilter_Chain_Configuration configuration, QWidget *parent)
 	: QDialog(parent), mConfiguration(configuration) {
 
 	mIs_Solving = false;
 	Populate_Parameters_Info(configuration);
+
+	// the parameter values change with every optimization, so only the filters identify the chain
+	QCryptographicHash chain_hash{ QCryptographicHash::Sha1 };
+	configuration.for_each([&chain_hash](scgms::SFilter_Configuration_Link link) {
+		chain_hash.addData(GUID_To_QUuid(link.descriptor().id).toRfc4122());
+	});
+	mCheckpoint_Key = QString::fromLatin1(chain_hash.result().toHex().left(16));
+
 	Setup_UI();
 }
 
@@ -188,6 +242,31 @@ void CParameters_Optimization_Dialog::Setup_UI() {
 		edtPopulation_Size = new QLineEdit{ edits };
 		edtPopulation_Size->setValidator(new QIntValidator(edits));
 		edtPopulation_Size->setText("100");
+
+		// every start runs on a thread of its own, so more starts than cores make no sense
+		spbStarts = new QSpinBox{ edits };
+		spbStarts->setRange(1, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+		spbStarts->setValue(1);
+
+		// the solver is restarted from the best solution after every segment of this many generations
+		spbCheckpoint_Generations = new QSpinBox{ edits };
+		spbCheckpoint_Generations->setRange(0, 1000000);
+		spbCheckpoint_Generations->setValue(Default_Checkpoint_Generations);
+		spbCheckpoint_Generations->setSpecialValueText(tr("At the end only"));
+		spbCheckpoint_Generations->setToolTip(tr("Restarting the solver discards its population, which may slow the convergence down"));
+
+		// evaluated by the desktop instead of the solver library, so that repeated candidates do not replay the chain again
+		chkFitness_Cache = new QCheckBox{ tr("Cache fitness evaluations"), edits };
+		chkFitness_Cache->setToolTip(tr("Candidates (nearly) identical to an already evaluated one reuse its fitness instead of replaying the chain; "
+			"the chain is then replayed by the desktop instead of the solver library, which is not necessarily faster"));
+
+		chkResume = new QCheckBox{ tr("Resume from the last checkpoint"), edits };
+		{
+			QSettings checkpoint{ Checkpoint_Path(), QSettings::IniFormat };
+			chkResume->setEnabled(checkpoint.contains("parameters/count"));
+			if (chkResume->isEnabled())
+				chkResume->setToolTip(checkpoint.value("saved").toDateTime().toLocalTime().toString());
+		}
 	
 		{
 			QGridLayout *edits_layout = new QGridLayout();
@@ -199,6 +278,10 @@ void CParameters_Optimization_Dialog::Setup_UI() {
 			edits_layout->addWidget(new QLabel{ tr(selected_solver.c_str()), edits }, 1, 0);	edits_layout->addWidget(cmbSolver, 1, 1);
 			edits_layout->addWidget(new QLabel{ dsMax_Generations, edits }, 2, 0);				edits_layout->addWidget(edtMax_Generations, 2, 1);
 			edits_layout->addWidget(new QLabel{ dsPopulation_Size, edits }, 3, 0);				edits_layout->addWidget(edtPopulation_Size, 3, 1);
+			edits_layout->addWidget(new QLabel{ tr("Independent starts"), edits }, 4, 0);		edits_layout->addWidget(spbStarts, 4, 1);
+			edits_layout->addWidget(new QLabel{ tr("Checkpoint every (generations)"), edits }, 5, 0);	edits_layout->addWidget(spbCheckpoint_Generations, 5, 1);
+			edits_layout->addWidget(chkResume, 6, 1);
+			edits_layout->addWidget(chkFitness_Cache, 7, 1);
 		}
 
 	
@@ -226,9 +309,21 @@ void CParameters_Optimization_Dialog::Setup_UI() {
 				labels_layout->addWidget(progressLabel2, 0, Qt::AlignCenter);
 			}
 
+			lblCache_Stats = new QLabel{ progress };
+			lblCache_Stats->hide();
+
+			tblStarts = new QTableWidget{ progress };
+			tblStarts->setColumnCount(4);
+			tblStarts->setHorizontalHeaderLabels(QStringList{} << tr("Start") << tr("Progress") << tr("Best metric") << tr("State"));
+			tblStarts->verticalHeader()->hide();
+			tblStarts->setEditTriggers(QAbstractItemView::NoEditTriggers);
+			tblStarts->setSelectionMode(QAbstractItemView::NoSelection);
+
 			progress_layout->addWidget(lblSolver_Info);
 			progress_layout->addWidget(barProgress);
 			progress_layout->addWidget(progressLabels);
+			progress_layout->addWidget(lblCache_Stats);
+			progress_layout->addWidget(tblStarts);
 		}
 
 		QWidget* buttons = new QWidget();
@@ -238,11 +333,13 @@ void CParameters_Optimization_Dialog::Setup_UI() {
 
 			btnSolve = new QPushButton{ dsSolve, buttons };
 			btnStop = new QPushButton{ dsStop, buttons };
+			btnBenchmark = new QPushButton{ tr("Benchmark..."), buttons };
 			btnClose = new QPushButton{ dsClose, buttons };
 
-			buttons_layout->addWidget(btnSolve);	buttons_layout->addWidget(btnStop);	buttons_layout->addWidget(btnClose);
+			buttons_layout->addWidget(btnSolve);	buttons_layout->addWidget(btnStop);	buttons_layout->addWidget(btnBenchmark);	buttons_layout->addWidget(btnClose);
 			connect(btnSolve, SIGNAL(clicked()), this, SLOT(On_Solve()));
 			connect(btnStop, SIGNAL(clicked()), this, SLOT(On_Stop()));
+			connect(btnBenchmark, SIGNAL(clicked()), this, SLOT(On_Benchmark()));
 			connect(btnClose, SIGNAL(clicked()), this, SLOT(close()));
 		}
 
@@ -267,26 +364,39 @@ void CParameters_Optimization_Dialog::Setup_UI() {
 		QVBoxLayout* mhb_layout = new QVBoxLayout();
 		metric_history_box->setLayout(mhb_layout);
 
-		QWidget* history = new QWidget();
-
-		lstMetricHistory = new QTableWidget{ history };
-		lstMetricHistory->setColumnCount(solver::Maximum_Objectives_Count + 2); // 2 for current and maximum generation count
+		QSplitter* history = new QSplitter{ Qt::Vertical };
 
-		QStringList headers;
-		headers << "Gen." << "Max.";
-		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++)
-			headers << QString::number(i + 1);
+		mConvergence_Model = new CConvergence_Model{ this };
+		mConvergence_Plot = new CConvergence_Plot{ mConvergence_Model, history };
 
+		lstMetricHistory = new QTableView{ history };
+		lstMetricHistory->setModel(mConvergence_Model);	// 2 columns for current and maximum generation count, then the objectives
 		lstMetricHistory->setShowGrid(true);
 		lstMetricHistory->setSelectionMode(QAbstractItemView::SingleSelection);
 		lstMetricHistory->setSelectionBehavior(QAbstractItemView::SelectRows);
-		lstMetricHistory->setHorizontalHeaderLabels(headers);
-		lstMetricHistory->resizeColumnsToContents();
 		lstMetricHistory->verticalHeader()->hide();
+		// rows are uniform, so the view does not need to measure each of them
+		lstMetricHistory->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+		lstMetricHistory->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
 
 		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++)
 			lstMetricHistory->hideColumn(static_cast<int>(i + 2));
 
+		history->addWidget(mConvergence_Plot);
+		history->addWidget(lstMetricHistory);
+
+		connect(mConvergence_Model, SIGNAL(On_Objective_Used(int)), this, SLOT(On_Objective_Used(int)));
+
+		lblImprovement_Rate = new QLabel("N/A");
+		QWidget* rateLbl = new QWidget();
+		{
+			QHBoxLayout* ly = new QHBoxLayout();
+			rateLbl->setLayout(ly);
+
+			ly->addWidget(new QLabel(tr("Improvement per 100 generations:")));
+			ly->addWidget(lblImprovement_Rate);
+		}
+
 		QWidget* startLbl = new QWidget();
 		{
 			QHBoxLayout* ly = new QHBoxLayout();
@@ -311,6 +421,7 @@ void CParameters_Optimization_Dialog::Setup_UI() {
 
 		mhb_layout->addWidget(new QLabel("Metric history"));
 		mhb_layout->addWidget(history, 1);
+		mhb_layout->addWidget(rateLbl);
 		mhb_layout->addWidget(startLbl);
 		mhb_layout->addWidget(endLbl);
 
@@ -322,30 +433,38 @@ void CParameters_Optimization_Dialog::Setup_UI() {
 
 	setMinimumSize(300, 200);	//keeping Qt happy although it should already calculate from the controls
 
-	connect(this, SIGNAL(Update_Progress_Signal()), this, SLOT(On_Update_Progress()), Qt::BlockingQueuedConnection);
+	mProgress_Timer = new QTimer{ this };
+	connect(mProgress_Timer, SIGNAL(timeout()), this, SLOT(On_Update_Progress()));
 }
 
 
+void CParameters_Optimization_Dialog::Read_Selected_Parameters() {
+	mSolve_filter_info_indices.clear();
+	mSolve_filter_parameter_names.clear();
+
+	auto model = cmbParameters->selectionModel();
+	QStandardItemModel* casted_model = dynamic_cast<QStandardItemModel*>(model->model());
+	foreach(const QModelIndex & index, model->selectedIndexes()) {
+		const size_t filter_info_index = casted_model->itemFromIndex(index)->data().toInt();
+		mSolve_filter_info_indices.push_back(mParameters_Info[filter_info_index].filter_index);
+		mSolve_filter_parameter_names.push_back(mParameters_Info[filter_info_index].parameters_name.c_str());
+	}
+}
+
 void CParameters_Optimization_Dialog::On_Solve() {
 	if (!mIs_Solving) {
 		const QVariant solver_variant = cmbSolver->currentData();
 		if (!solver_variant.isNull())
 			mChosen_Solver_Id = QUuid_To_GUID(solver_variant.toUuid());
 
-		mSolve_filter_info_indices.clear();
-		mSolve_filter_parameter_names.clear();
-
-		
-		auto model = cmbParameters->selectionModel();
-		QStandardItemModel* casted_model = dynamic_cast<QStandardItemModel*>(model->model());
-		foreach(const QModelIndex & index, model->selectedIndexes()) {
-			const size_t filter_info_index = casted_model->itemFromIndex(index)->data().toInt();
-			mSolve_filter_info_indices.push_back(mParameters_Info[filter_info_index].filter_index);
-			mSolve_filter_parameter_names.push_back(mParameters_Info[filter_info_index].parameters_name.c_str());
-		}
+		Read_Selected_Parameters();
 
-		lstMetricHistory->clearContents();
-		lstMetricHistory->setRowCount(0);
+		mConvergence_Model->Clear();
+		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++)
+			lstMetricHistory->hideColumn(static_cast<int>(i + 2));
+		mConvergence_Plot->Set_Current_Generation(0, 0);
+		mConvergence_Estimator.Reset();
+		lblImprovement_Rate->setText("N/A");
 
 		timestampLabelStart->setText("N/A");
 		timestampLabelEnd->setText("N/A");
@@ -359,46 +478,498 @@ void CParameters_Optimization_Dialog::On_Solve() {
 			const int maxGens = edtMax_Generations->text().toInt();
 
 			lastMetric = solver::Nan_Fitness;
-			lastProgress = 0;
 			startDateTime = QDateTime::currentDateTime();
 			timestampLabelStart->setText(startDateTime.toLocalTime().toString());
 
 			mProgress = solver::Null_Solver_Progress;
-			mSolver_Thread = std::make_unique<std::thread>(
-				[this, popSize, maxGens]() {
-					refcnt::Swstr_list error_description;
-					HRESULT res = scgms::Optimize_Parameters(mConfiguration, mSolve_filter_info_indices.data(), const_cast<const wchar_t**>(mSolve_filter_parameter_names.data()), mSolve_filter_info_indices.size(),
+			mGeneration = mMax_Generation = 0;
+
+			// the chain may have been edited since the last run, so the memoized fitness would not hold anymore
+			mUse_Fitness_Cache = chkFitness_Cache->isChecked();
+			mFitness_Cache.Clear();
+			lblCache_Stats->setVisible(mUse_Fitness_Cache);
+			lblCache_Stats->setText(tr("Fitness cache: N/A"));
+
+			// when resuming, the loaded checkpoint stays the best known solution until a start beats it
+			std::vector<std::vector<double>> resume_parameters;
+			solver::TFitness resume_metric = solver::Nan_Fitness;
+			size_t resume_generations = 0;
+			mResume_Hint.clear();
+			if (chkResume->isChecked()) {
+				if (Load_Checkpoint(resume_parameters, resume_metric, resume_generations))
+					mResume_Hint = Hint_From_Parameters(resume_parameters);
+				if (mResume_Hint.empty()) {
+					resume_parameters.clear();
+					resume_metric = solver::Nan_Fitness;
+					resume_generations = 0;
+					QMessageBox::warning(this, tr(dsWarning), tr("The checkpoint does not match the selected parameters, starting from the current values."));
+				}
+			}
+
+			{
+				std::unique_lock<std::mutex> lck(mCheckpoint_Mtx);
+				mCheckpoint_Metric = resume_metric;
+				mCheckpoint_Parameters = std::move(resume_parameters);
+				mLast_Checkpoint = QDateTime::currentDateTime();
+			}
+
+			// every start optimizes its own copy of the configuration, so that they do not overwrite each other's results
+			mStarts.clear();
+			const int start_count = spbStarts->value();
+			for (int i = 0; i < start_count; i++) {
+				auto start = std::make_unique<TOptimization_Start>();
+				start->total_generations = static_cast<size_t>(std::max(maxGens, 0));
+				// a resumed run goes on with the generations left; a finished one gets the whole budget once again, to refine it
+				if (resume_generations < start->total_generations)
+					start->completed_generations = resume_generations;
+				if (Clone_Configuration(mConfiguration, start->configuration) != S_OK) {
+					mStarts.clear();
+					mIs_Solving = false;
+					lblSolver_Info->setText(tr(dsSolver_Status_Failed));
+					return;
+				}
+
+				mStarts.push_back(std::move(start));
+			}
+
+			if (!mStart_Pool || mStart_Pool->Thread_Count() != mStarts.size())
+				mStart_Pool = std::make_unique<CThread_Pool>(mStarts.size());
+
+			Update_Starts_Table();
+
+			mSolve_Result = S_FALSE;
+			mSolver_Thread = std::make_unique<std::thread>(&CParameters_Optimization_Dialog::Run_Starts, this, popSize, maxGens, spbCheckpoint_Generations->value());
+
+			mProgress_Last_Value = 0;
+			mProgress_Ms_Per_Generation = 0.0;
+			mProgress_Clock.start();
+			mProgress_Timer->start(Progress_Min_Interval);
+		
+		}
+		
+	}
+}
+
+solver::TSolver_Progress CParameters_Optimization_Dialog::Progress_Snapshot(TOptimization_Start& start) {
+	// the solver library gives no way to synchronize with its writes, so the progress is copied
+	// until two consecutive copies agree, which rules out a copy torn by a write in the middle of it
+	constexpr size_t Max_Attempts = 16;
+
+	std::unique_lock<std::mutex> lck(start.progress_mtx);
+
+	solver::TSolver_Progress previous, current = start.progress;
+	for (size_t i = 0; i < Max_Attempts; i++) {
+		previous = current;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		current = start.progress;
+		if (std::memcmp(&previous, &current, sizeof(solver::TSolver_Progress)) == 0)
+			break;
+	}
+
+	return current;
+}
+
+void CParameters_Optimization_Dialog::Run_Starts(const int popSize, const int maxGens, const int segmentGens) {
+	std::vector<std::future<void>> done;
+
+	const size_t segment_generations = static_cast<size_t>(segmentGens > 0 ? segmentGens : maxGens);
+
+	for (auto& start : mStarts) {
+		TOptimization_Start* start_ptr = start.get();
+		done.push_back(mStart_Pool->Submit([this, start_ptr, popSize, segment_generations]() {
+			if (start_ptr->progress.cancelled) {
+				start_ptr->result = E_ABORT;
+				return;
+			}
+
+			// the run is split into segments, each of them starting from the best solution of the previous one,
+			// so that the best solution so far can be checkpointed; solvers seed themselves, so every start explores differently
+			std::vector<double> hint = mResume_Hint;
+			size_t remaining = start_ptr->total_generations - start_ptr->completed_generations;
+			HRESULT rc = S_OK;
+
+			while (remaining > 0 && rc == S_OK && !start_ptr->progress.cancelled) {
+				const size_t generations = std::min(remaining, segment_generations);
+				const double* hint_ptr = hint.data();
+
+				refcnt::Swstr_list error_description;
+				if (mUse_Fitness_Cache) {
+					CChain_Objective objective{ start_ptr->configuration, mSolve_filter_info_indices,
+						std::vector<std::wstring>{ mSolve_filter_parameter_names.begin(), mSolve_filter_parameter_names.end() }, mFitness_Cache };
+					rc = objective.Optimize(mChosen_Solver_Id, static_cast<size_t>(popSize), generations,
+						hint.empty() ? nullptr : &hint_ptr, hint.empty() ? 0 : 1,
+						start_ptr->progress,
+						error_description);
+				}
+				else {
+					rc = scgms::Optimize_Parameters(start_ptr->configuration, mSolve_filter_info_indices.data(), const_cast<const wchar_t**>(mSolve_filter_parameter_names.data()), mSolve_filter_info_indices.size(),
 						Setup_Filter_DB_Access, nullptr,
 						mChosen_Solver_Id,
 						popSize,
-						maxGens,
-						nullptr, 0,	//additional hints
-						mProgress,
+						generations,
+						hint.empty() ? nullptr : &hint_ptr, hint.empty() ? 0 : 1,
+						start_ptr->progress,
 						error_description);
+				}
 
-					mIs_Solving = false;
-					mProgress.cancelled = TRUE;	//stops mProgress_Update_Thread
-
-					if (res != S_OK)
-						lblSolver_Info->setText(tr(dsSolver_Status_Failed));
-					else
-						emit Update_Progress_Signal();
-			});
-
-			mProgress_Update_Thread = std::make_unique<std::thread>([this]() {
-				while (mProgress.cancelled == FALSE) {
-					if (mIs_Solving) emit Update_Progress_Signal();
-					std::this_thread::sleep_for(std::chrono::milliseconds(500));
+				if (rc == S_OK) {
+					Record_Checkpoint(*start_ptr);
+					hint = Hint_From_Parameters(Read_Parameters(start_ptr->configuration));
 				}
-			});
-		
+
+				{
+					// the solver of this start is not running now, the lock just keeps the readers from counting the segment twice
+					std::unique_lock<std::mutex> lck(start_ptr->progress_mtx);
+					start_ptr->completed_generations += generations;
+					start_ptr->progress.current_progress = 0;
+				}
+				remaining -= generations;
+			}
+
+			start_ptr->result = rc;
+		}));
+	}
+
+	for (auto& start_done : done) {
+		while (start_done.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout) {
+			if (mStop_Requested) {
+				for (auto& start : mStarts)
+					start->progress.cancelled = TRUE;
+			}
 		}
-		
 	}
+
+	TOptimization_Start* best = nullptr;
+	for (auto& start : mStarts) {
+		if (start->result == S_OK && (!best || Is_Better_Fitness(start->progress.best_metric, best->progress.best_metric)))
+			best = start.get();
+	}
+
+	mSolve_Result = best ? Commit_Parameters(*best) : E_FAIL;
+
+	Save_Checkpoint();
+
+	// the widgets belong to GUI thread; nothing waits for this, the dialog picks the result up when it gets to it
+	QMetaObject::invokeMethod(this, "On_Solve_Finished", Qt::QueuedConnection);
+}
+
+void CParameters_Optimization_Dialog::On_Solve_Finished() {
+	// the solver thread is about to end, it gets joined by the next start or by the dialog destruction
+	mProgress_Timer->stop();
+
+	// the starts have finished, so their progress is not written anymore
+	Aggregate_Progress();
+	mIs_Solving = false;
+
+	if (mSolve_Result != S_OK)
+		lblSolver_Info->setText(tr(dsSolver_Status_Failed));
+	else
+		On_Update_Progress();
+}
+
+void CParameters_Optimization_Dialog::On_Objective_Used(int objective) {
+	const int column = objective + 2;
+	lstMetricHistory->showColumn(column);
+	// sized once, when the first value appears, instead of after every improvement
+	lstMetricHistory->resizeColumnToContents(0);
+	lstMetricHistory->resizeColumnToContents(1);
+	lstMetricHistory->resizeColumnToContents(column);
+}
+
+void CParameters_Optimization_Dialog::Adapt_Progress_Interval() {
+	const size_t value = mProgress.current_progress;
+	const double elapsed = static_cast<double>(mProgress_Clock.restart());
+
+	int interval = mProgress_Timer->interval();
+	if (value > mProgress_Last_Value) {
+		// smoothed duration of a generation; refreshing more often than a generation completes shows nothing new
+		const double per_generation = elapsed / static_cast<double>(value - mProgress_Last_Value);
+		mProgress_Ms_Per_Generation = mProgress_Ms_Per_Generation > 0.0 ? 0.7 * mProgress_Ms_Per_Generation + 0.3 * per_generation : per_generation;
+		interval = static_cast<int>(mProgress_Ms_Per_Generation);
+	}
+	else
+		interval *= 2;	// nothing new, back off
+
+	mProgress_Last_Value = value;
+	mProgress_Timer->setInterval(std::clamp(interval, Progress_Min_Interval, Progress_Max_Interval));
+}
+
+HRESULT CParameters_Optimization_Dialog::Commit_Parameters(TOptimization_Start& start) {
+	for (size_t i = 0; i < mSolve_filter_info_indices.size(); i++) {
+		scgms::SFilter_Parameter source = Find_Filter_Parameter(start.configuration, mSolve_filter_info_indices[i], mSolve_filter_parameter_names[i]);
+		scgms::SFilter_Parameter target = Find_Filter_Parameter(mConfiguration, mSolve_filter_info_indices[i], mSolve_filter_parameter_names[i]);
+		if (!source || !target)
+			return E_FAIL;
+
+		HRESULT rc;
+		const std::vector<double> values = source.as_double_array(rc);
+		if (rc == S_OK)
+			rc = target.set_double_array(values);
+		if (rc != S_OK)
+			return rc;
+	}
+
+	return S_OK;
+}
+
+QString CParameters_Optimization_Dialog::Checkpoint_Path() const {
+	QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+	if (dir.isEmpty())
+		dir = QDir::tempPath();
+
+	QDir{}.mkpath(dir);
+	return QDir{ dir }.filePath(QString("optimization_checkpoint_%1.ini").arg(mCheckpoint_Key));
+}
+
+std::vector<std::vector<double>> CParameters_Optimization_Dialog::Read_Parameters(scgms::SFilter_Chain_Configuration configuration) const {
+	std::vector<std::vector<double>> result;
+
+	for (size_t i = 0; i < mSolve_filter_info_indices.size(); i++) {
+		scgms::SFilter_Parameter parameter = Find_Filter_Parameter(configuration, mSolve_filter_info_indices[i], mSolve_filter_parameter_names[i]);
+		HRESULT rc = E_FAIL;
+		result.push_back(parameter ? parameter.as_double_array(rc) : std::vector<double>{});
+		if (rc != S_OK)
+			return {};
+	}
+
+	return result;
+}
+
+std::vector<double> CParameters_Optimization_Dialog::Hint_From_Parameters(const std::vector<std::vector<double>>& parameters) {
+	std::vector<double> hint;
+
+	for (const auto& values : parameters) {
+		if (values.size() % 3 != 0)
+			return {};
+
+		const size_t count = values.size() / 3;
+		hint.insert(hint.end(), values.begin() + count, values.begin() + 2 * count);
+	}
+
+	return hint;
+}
+
+void CParameters_Optimization_Dialog::Record_Checkpoint(TOptimization_Start& start) {
+	bool improved = false;
+	const solver::TSolver_Progress progress = Progress_Snapshot(start);
+
+	{
+		std::unique_lock<std::mutex> lck(mCheckpoint_Mtx);
+		if (mCheckpoint_Parameters.empty() || Is_Better_Fitness(progress.best_metric, mCheckpoint_Metric)) {
+			auto parameters = Read_Parameters(start.configuration);
+			if (!parameters.empty()) {
+				mCheckpoint_Metric = progress.best_metric;
+				mCheckpoint_Parameters = std::move(parameters);
+				improved = true;
+			}
+		}
+	}
+
+	if (improved)
+		Save_Checkpoint();
+}
+
+void CParameters_Optimization_Dialog::Save_Checkpoint() {
+	TCheckpoint_Snapshot snapshot;
+
+	{
+		std::unique_lock<std::mutex> lck(mCheckpoint_Mtx);
+		mLast_Checkpoint = QDateTime::currentDateTime();
+
+		// until there is something better than the initial values, the checkpoint on disk (possibly of a previous run) is kept
+		if (mCheckpoint_Parameters.empty())
+			return;
+
+		snapshot.sequence = ++mCheckpoint_Sequence;
+		snapshot.metric = mCheckpoint_Metric;
+		snapshot.parameters = mCheckpoint_Parameters;
+	}
+
+	for (const auto& start : mStarts) {
+		snapshot.current_progress += start->completed_generations + Progress_Snapshot(*start).current_progress;
+		snapshot.max_progress += start->total_generations;
+	}
+	snapshot.start_count = mStarts.size();
+
+	Write_Checkpoint(snapshot);
+}
+
+void CParameters_Optimization_Dialog::Write_Checkpoint(const TCheckpoint_Snapshot& snapshot) {
+	std::unique_lock<std::mutex> lck(mCheckpoint_File_Mtx);
+	if (snapshot.sequence <= mCheckpoint_Written)
+		return;
+
+	// written aside and renamed over the previous checkpoint, so that a crash while writing never loses it
+	const QString path = Checkpoint_Path();
+	const QString temporary_path = path + ".tmp";
+	QFile::remove(temporary_path);
+
+	{
+		QSettings checkpoint{ temporary_path, QSettings::IniFormat };
+
+		checkpoint.setValue("saved", QDateTime::currentDateTimeUtc());
+		checkpoint.setValue("solver", GUID_To_QUuid(mChosen_Solver_Id).toString());
+
+		checkpoint.setValue("progress/current", static_cast<qulonglong>(snapshot.current_progress));
+		checkpoint.setValue("progress/max", static_cast<qulonglong>(snapshot.max_progress));
+		checkpoint.setValue("progress/starts", static_cast<qulonglong>(snapshot.start_count));
+
+		QStringList metric;
+		for (size_t i = 0; i < solver::Maximum_Objectives_Count; i++)
+			metric << QString::number(snapshot.metric[i], 'g', 17);
+		checkpoint.setValue("progress/best_metric", metric);
+
+		checkpoint.setValue("parameters/count", static_cast<qulonglong>(snapshot.parameters.size()));
+		for (size_t i = 0; i < snapshot.parameters.size(); i++) {
+			const QString key = QString("parameters/%1/").arg(i);
+			checkpoint.setValue(key + "filter_index", static_cast<qulonglong>(mSolve_filter_info_indices[i]));
+			checkpoint.setValue(key + "name", QString::fromWCharArray(mSolve_filter_parameter_names[i]));
+
+			QStringList values;
+			for (const double value : snapshot.parameters[i])
+				values << QString::number(value, 'g', 17);
+			checkpoint.setValue(key + "values", values);
+		}
+
+		checkpoint.sync();
+		if (checkpoint.status() != QSettings::NoError)
+			return;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temporary_path.toStdWString(), path.toStdWString(), ec);
+	if (!ec)
+		mCheckpoint_Written = snapshot.sequence;
+}
+
+bool CParameters_Optimization_Dialog::Load_Checkpoint(std::vector<std::vector<double>>& parameters, solver::TFitness& metric, size_t& completed_generations) {
+	QSettings checkpoint{ Checkpoint_Path(), QSettings::IniFormat };
+
+	// the checkpoint is usable only for the very same set of parameters
+	const size_t count = checkpoint.value("parameters/count", 0).toULongLong();
+	if (count == 0 || count != mSolve_filter_info_indices.size())
+		return false;
+
+	// and only if the values fit the parameters as they are configured now
+	const auto current = Read_Parameters(mConfiguration);
+	if (current.size() != count)
+		return false;
+
+	parameters.clear();
+	for (size_t i = 0; i < count; i++) {
+		const QString key = QString("parameters/%1/").arg(i);
+		if (checkpoint.value(key + "filter_index").toULongLong() != mSolve_filter_info_indices[i] ||
+			checkpoint.value(key + "name").toString() != QString::fromWCharArray(mSolve_filter_parameter_names[i]))
+			return false;
+
+		std::vector<double> values;
+		for (const auto& value : checkpoint.value(key + "values").toStringList()) {
+			bool ok = false;
+			values.push_back(value.toDouble(&ok));
+			if (!ok)
+				return false;
+		}
+
+		if (values.size() != current[i].size())
+			return false;
+
+		parameters.push_back(std::move(values));
+	}
+
+	metric = solver::Nan_Fitness;
+	const QStringList stored_metric = checkpoint.value("progress/best_metric").toStringList();
+	for (int i = 0; i < stored_metric.size() && static_cast<size_t>(i) < solver::Maximum_Objectives_Count; i++) {
+		bool ok = false;
+		const double value = stored_metric[i].toDouble(&ok);
+		if (ok)
+			metric[i] = value;
+	}
+
+	// the progress is summed over the starts of the checkpointed run; a checkpoint with no start count comes from a single start
+	const size_t start_count = std::max(static_cast<qulonglong>(1), checkpoint.value("progress/starts", 1).toULongLong());
+	completed_generations = checkpoint.value("progress/current", 0).toULongLong() / start_count;
+	if (completed_generations >= checkpoint.value("progress/max", 0).toULongLong() / start_count)
+		completed_generations = 0;	// the run finished, there is nothing to go on with
+
+	return true;
+}
+
+void CParameters_Optimization_Dialog::Aggregate_Progress() {
+	size_t current_progress = 0, max_progress = 0;
+	solver::TFitness best_metric = solver::Nan_Fitness;
+
+	size_t max_generation = 0;
+
+	for (const auto& start : mStarts) {
+		const solver::TSolver_Progress progress = Progress_Snapshot(*start);
+		current_progress += start->completed_generations + progress.current_progress;
+		max_progress += start->total_generations;
+		max_generation = std::max(max_generation, start->total_generations);
+		if (Is_Better_Fitness(progress.best_metric, best_metric))
+			best_metric = progress.best_metric;
+	}
+
+	mProgress.current_progress = current_progress;
+	mProgress.max_progress = max_progress;
+	mProgress.best_metric = best_metric;
+
+	// the starts run side by side, so N starts past generation g are at generation g, not N*g
+	mGeneration = mStarts.empty() ? 0 : current_progress / mStarts.size();
+	mMax_Generation = max_generation;
+}
+
+void CParameters_Optimization_Dialog::Update_Starts_Table() {
+	tblStarts->setRowCount(static_cast<int>(mStarts.size()));
+
+	for (size_t i = 0; i < mStarts.size(); i++) {
+		const solver::TSolver_Progress progress = Progress_Snapshot(*mStarts[i]);
+		const HRESULT result = mStarts[i]->result;
+		const int row = static_cast<int>(i);
+
+		QString state;
+		if (result == S_FALSE)
+			state = mIs_Solving ? tr(dsSolver_Status_In_Progress) : tr(dsSolver_Status_Stopped);
+		else if (result == S_OK)
+			state = tr(dsSolver_Status_Completed_Improved);
+		else
+			state = tr(dsSolver_Status_Failed);
+
+		const size_t current_progress = mStarts[i]->completed_generations + progress.current_progress;
+		const QString progress_text = progress.max_progress > 0 ? QString("%1 / %2").arg(current_progress).arg(mStarts[i]->total_generations) : QString("N/A");
+		const QString metric_text = Is_Any_NaN(progress.best_metric[0]) ? QString("N/A") : QString::number(progress.best_metric[0]);
+
+		auto set_text = [this, row](const int column, const QString& text) {
+			QTableWidgetItem* item = tblStarts->item(row, column);
+			if (item)
+				item->setText(text);
+			else
+				tblStarts->setItem(row, column, new QTableWidgetItem(text));
+		};
+
+		set_text(0, QString::number(i + 1));
+		set_text(1, progress_text);
+		set_text(2, metric_text);
+		set_text(3, state);
+	}
+
+	tblStarts->resizeColumnsToContents();
 }
 
 void CParameters_Optimization_Dialog::On_Update_Progress() {
+	Update_Starts_Table();
+
 	if (mIs_Solving) {
+		Aggregate_Progress();
+		Adapt_Progress_Interval();
+
+		bool checkpoint_due;
+		{
+			std::unique_lock<std::mutex> lck(mCheckpoint_Mtx);
+			checkpoint_due = mLast_Checkpoint.msecsTo(QDateTime::currentDateTime()) >= Checkpoint_Progress_Interval;
+		}
+		if (checkpoint_due)
+			Save_Checkpoint();
+
 		if (mProgress.max_progress > 0) {
 
 			int progressValue = static_cast<int>(std::round(100.0 * mProgress.current_progress / mProgress.max_progress));
@@ -408,19 +979,24 @@ void CParameters_Optimization_Dialog::On_Update_Progress() {
 			progressLabel2->setText(QString("%1 %").arg(progressValue));
 			lblSolver_Info->setText(QString(tr(dsBest_Metric_Label)).arg(mProgress.best_metric[0]));
 
-			if (lastProgress != mProgress.current_progress)
-			{
-				lastProgress = mProgress.current_progress;
+			// ETA from the recent speed, as the generations usually get slower (or faster) as the solver converges
+			mConvergence_Estimator.Update(mGeneration, mProgress.best_metric[0], static_cast<double>(startDateTime.msecsTo(QDateTime::currentDateTime())));
+			const double remaining_ms = mConvergence_Estimator.Remaining_Ms(mMax_Generation);
+			if (remaining_ms >= 0.0)
+				timestampLabelEnd->setText(QString("%1 (ETA)").arg(QDateTime::currentDateTime().addMSecs(static_cast<qint64>(remaining_ms)).toLocalTime().toString()));
+			else
+				timestampLabelEnd->setText("N/A");
 
-				if (mProgress.current_progress > 0)
-				{
-					const auto msPerUnit = (QDateTime::currentDateTime().toMSecsSinceEpoch() - startDateTime.toMSecsSinceEpoch()) / mProgress.current_progress;
-					const QDateTime etaEnd = startDateTime.addMSecs(msPerUnit * mProgress.max_progress);
+			const double improvement = mConvergence_Estimator.Improvement_Per_Generation();
+			lblImprovement_Rate->setText(Is_Any_NaN(improvement) ? QString("N/A") : QString("%1 %").arg(100.0 * 100.0 * improvement, 0, 'g', 3));
 
-					timestampLabelEnd->setText(QString("%1 (ETA)").arg(etaEnd.toLocalTime().toString()));
-				}
-				else
-					timestampLabelEnd->setText("N/A");
+			mConvergence_Plot->Set_Current_Generation(mGeneration, mMax_Generation);
+
+			if (mUse_Fitness_Cache) {
+				const double hit_rate = mFitness_Cache.Hit_Rate();
+				if (!Is_Any_NaN(hit_rate))
+					lblCache_Stats->setText(QString(tr("Fitness cache: %1 % hits, %2 of %3 evaluations replayed the chain"))
+						.arg(100.0 * hit_rate, 0, 'f', 1).arg(mFitness_Cache.Misses()).arg(mFitness_Cache.Hits() + mFitness_Cache.Misses()));
 			}
 
 			bool changed = false;
@@ -438,18 +1014,7 @@ void CParameters_Optimization_Dialog::On_Update_Progress() {
 					lastMetric[i] = mProgress.best_metric[i];
 				}
 
-				int i = lstMetricHistory->rowCount();
-
-				lstMetricHistory->insertRow(i);
-				lstMetricHistory->setItem(i, 0, new QTableWidgetItem(QString::number(mProgress.current_progress)));
-				lstMetricHistory->setItem(i, 1, new QTableWidgetItem(QString::number(mProgress.max_progress)));
-				for (size_t j = 0; j < solver::Maximum_Objectives_Count; j++) {
-					lstMetricHistory->setItem(i, static_cast<int>(2 + j), new QTableWidgetItem(QString::number(mProgress.best_metric[j])));
-					if (!Is_Any_NaN(mProgress.best_metric[j]))
-						lstMetricHistory->showColumn(static_cast<int>(j + 2));
-				}
-
-				lstMetricHistory->resizeColumnsToContents();
+				mConvergence_Model->Append({ mGeneration, mMax_Generation, mProgress.best_metric });
 				lstMetricHistory->scrollToBottom();
 			}
 		} else
@@ -463,6 +1028,113 @@ void CParameters_Optimization_Dialog::On_Update_Progress() {
 	}
 }
 
+void CParameters_Optimization_Dialog::On_Benchmark() {
+	if (mIs_Solving)
+		return;
+
+	Read_Selected_Parameters();
+	if (mSolve_filter_info_indices.empty()) {
+		QMessageBox::warning(this, tr(dsWarning), tr("Select the parameters to optimize first."));
+		return;
+	}
+
+	// the solvers to compare, the selected one checked by default
+	std::vector<GUID> solvers;
+	{
+		QDialog selection{ this };
+		selection.setWindowTitle(tr("Benchmark solvers"));
+
+		QVBoxLayout* layout = new QVBoxLayout();
+		selection.setLayout(layout);
+
+		QListWidget* lstSolvers = new QListWidget{ &selection };
+		for (int i = 0; i < cmbSolver->count(); i++) {
+			QListWidgetItem* item = new QListWidgetItem{ cmbSolver->itemText(i), lstSolvers };
+			item->setData(Qt::UserRole, cmbSolver->itemData(i));
+			item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+			item->setCheckState(i == cmbSolver->currentIndex() ? Qt::Checked : Qt::Unchecked);
+		}
+
+		QDialogButtonBox* buttons = new QDialogButtonBox{ QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &selection };
+		connect(buttons, SIGNAL(accepted()), &selection, SLOT(accept()));
+		connect(buttons, SIGNAL(rejected()), &selection, SLOT(reject()));
+
+		layout->addWidget(new QLabel{ QString(tr("Every solver runs with %1 generations of population %2.")).arg(edtMax_Generations->text()).arg(edtPopulation_Size->text()), &selection });
+		layout->addWidget(lstSolvers);
+		layout->addWidget(buttons);
+
+		if (selection.exec() != QDialog::Accepted)
+			return;
+
+		for (int i = 0; i < lstSolvers->count(); i++) {
+			if (lstSolvers->item(i)->checkState() == Qt::Checked)
+				solvers.push_back(QUuid_To_GUID(lstSolvers->item(i)->data(Qt::UserRole).toUuid()));
+		}
+	}
+
+	if (solvers.empty())
+		return;
+
+	const QString report_path = QFileDialog::getSaveFileName(this, tr("Save benchmark report"), QString(), tr("CSV files (*.csv)"));
+	if (report_path.isEmpty())
+		return;
+
+	std::vector<std::wstring> parameter_names{ mSolve_filter_parameter_names.begin(), mSolve_filter_parameter_names.end() };
+	CSolver_Benchmark benchmark{ mConfiguration, mSolve_filter_info_indices, parameter_names,
+		static_cast<size_t>(std::max(edtPopulation_Size->text().toInt(), 0)), static_cast<size_t>(std::max(edtMax_Generations->text().toInt(), 0)) };
+
+	QProgressDialog progress(tr("Benchmarking the solvers..."), dsStop, 0, 1000, this);
+	progress.setWindowTitle(tr("Benchmark solvers"));
+	progress.setWindowModality(Qt::ApplicationModal);
+	progress.setAutoClose(false);
+	progress.setAutoReset(false);
+	progress.show();
+
+	refcnt::Swstr_list errors;
+	auto done = std::async(std::launch::async, [&benchmark, &solvers, errors]() {
+		return benchmark.Run(solvers, errors);
+	});
+
+	// the solvers run one by one, the bar goes through all of them
+	while (done.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout) {
+		if (progress.wasCanceled())
+			benchmark.Cancel();
+
+		const size_t current = benchmark.Current_Solver();
+		progress.setValue(static_cast<int>(1000.0 * (static_cast<double>(current) + benchmark.Current_Progress()) / static_cast<double>(solvers.size())));
+		progress.setLabelText(QString(tr("Solver %1 / %2: %3")).arg(current + 1).arg(solvers.size()).arg(cmbSolver->itemText(cmbSolver->findData(GUID_To_QUuid(solvers[current])))));
+
+		QApplication::processEvents();
+	}
+
+	const HRESULT rc = done.get();
+	progress.close();
+
+	if (!benchmark.Write_Report(report_path.toStdWString())) {
+		QMessageBox::warning(this, tr(dsWarning), tr("Cannot write the benchmark report to %1").arg(report_path));
+		return;
+	}
+
+	QString summary;
+	for (const auto& result : benchmark.Get_Results()) {
+		if (result.result == S_FALSE)
+			continue;
+
+		summary += QString("%1: %2 s, %3 evaluations/s, %4 %5\n").arg(QString::fromStdWString(result.description))
+			.arg(result.wall_time_ms / 1000.0, 0, 'f', 1).arg(result.Evaluations_Per_Second(), 0, 'f', 1)
+			.arg(tr("best metric")).arg(result.best_metric[0]);
+	}
+
+	errors.for_each([&summary](auto str) {
+		summary += "\n" + QString::fromStdWString(str);
+	});
+
+	if (rc == S_OK)
+		QMessageBox::information(this, tr("Benchmark solvers"), summary);
+	else
+		QMessageBox::warning(this, tr("Benchmark solvers"), (rc == E_ABORT ? tr("The benchmark was stopped.") : tr("No solver succeeded.")) + "\n" + summary);
+}
+
 void CParameters_Optimization_Dialog::On_Stop() {
 	Stop_Async();
 	On_Update_Progress();
@@ -493,10 +1165,9 @@ void CParameters_Optimization_Dialog::Stop_Threads() {
 		}
 	};
 
-	mProgress.cancelled = TRUE;
+	mStop_Requested = true;
 	wait_for_thread(mSolver_Thread);
-	wait_for_thread(mProgress_Update_Thread);
-	mProgress.cancelled = FALSE;
+	mStop_Requested = false;
 }
 
 void CParameters_Optimization_Dialog::Stop_Async() {
@@ -513,18 +1184,18 @@ void CParameters_Optimization_Dialog::Stop_Async() {
 	if (L.size() > 0)
 		L[0]->setDisabled(true);
 
+	mIs_Solving = false;
+	mProgress_Timer->stop();
+
 	auto r = std::async(std::launch::async, [this]() {
-		mProgress.cancelled = TRUE;
-		mIs_Solving = false;
 		Stop_Threads();
 		});
 
-	while (r.wait_for(std::chrono::milliseconds(10)) == std::future_status::timeout) {
-		mProgress.cancelled = TRUE;
-		mIs_Solving = false;
+	while (r.wait_for(std::chrono::milliseconds(10)) == std::future_status::timeout)
 		QApplication::processEvents();
-	}
-	mProgress.cancelled = FALSE;
+
+	// the starts have finished, so their progress is not written anymore
+	Aggregate_Progress();
 
 	progress.close();
 }
@@ -44,11 +44,23 @@
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QProgressBar>
+#include <QtWidgets/QSpinBox>
+#include <QtWidgets/QCheckBox>
 #include <QtWidgets/QListView>
 #include <QtWidgets/QTableWidget>
+#include <QtWidgets/QTableView>
 #include <QtGui/QStandardItem>
 #include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
 
+#include "../utils/thread_pool.h"
+#include "../utils/fitness_cache.h"
+#include "helpers/convergence_model.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <thread>
 
@@ -67,35 +79,130 @@ protected:
 	void Populate_Parameters_Info(scgms::SFilter_Chain_Configuration configuration);
 protected:
 	QListView* cmbParameters = nullptr;
-	QTableWidget* lstMetricHistory = nullptr;
+	QTableView* lstMetricHistory = nullptr;
+	CConvergence_Model* mConvergence_Model = nullptr;
+	CConvergence_Plot* mConvergence_Plot = nullptr;
+	CConvergence_Estimator mConvergence_Estimator;
+	QLabel* lblImprovement_Rate = nullptr;
 	QComboBox* cmbSolver = nullptr;
 	QLineEdit *edtMax_Generations, *edtPopulation_Size;
+	QSpinBox *spbStarts;
+	QSpinBox *spbCheckpoint_Generations;
+	QCheckBox *chkResume;
+	QCheckBox *chkFitness_Cache;
+	QLabel *lblCache_Stats;
+	QTableWidget *tblStarts;
 	QLabel *lblSolver_Info;
 	QProgressBar *barProgress;
 	QLabel* progressLabel1, *progressLabel2;
-	QPushButton *btnSolve, *btnStop, *btnClose;
+	QPushButton *btnSolve, *btnStop, *btnBenchmark, *btnClose;
 	QLabel* timestampLabelStart, *timestampLabelEnd;
 	QDateTime startDateTime;
 	solver::TFitness lastMetric = solver::Nan_Fitness;
-	size_t lastProgress = 0;
 	void Setup_UI();
 
 	std::vector<size_t> mSolve_filter_info_indices;
 	std::vector<const wchar_t*> mSolve_filter_parameter_names;
 	GUID mChosen_Solver_Id;
+	// fills the two vectors above from the selection of parameters
+	void Read_Selected_Parameters();
 protected:
-	std::unique_ptr<std::thread> mSolver_Thread, mProgress_Update_Thread;
+	std::unique_ptr<std::thread> mSolver_Thread;
+	// aggregated progress of all the starts - generations summed over them; GUI thread only
 	solver::TSolver_Progress mProgress;
-	bool mIs_Solving = false;
+	// generation a start has reached on average, and of how many; the convergence is tracked per generation, not per start count
+	size_t mGeneration = 0, mMax_Generation = 0;
+	std::atomic<bool> mIs_Solving{ false };
+	// stop request for the solver thread, which passes it on to all the starts
+	std::atomic<bool> mStop_Requested{ false };
+	// result of the whole run, valid once the solver thread finished
+	std::atomic<HRESULT> mSolve_Result{ S_FALSE };
+
+	// progress is refreshed by a timer in GUI thread, at a rate following the speed of the generations
+	QTimer* mProgress_Timer = nullptr;
+	QElapsedTimer mProgress_Clock;
+	size_t mProgress_Last_Value = 0;
+	double mProgress_Ms_Per_Generation = 0.0;
+	void Adapt_Progress_Interval();
+
+	// single independent run of the solver on its own copy of the configuration
+	struct TOptimization_Start {
+		scgms::SPersistent_Filter_Chain_Configuration configuration;
+		// written by the solver without any lock; read it through Progress_Snapshot only
+		solver::TSolver_Progress progress = solver::Null_Solver_Progress;
+		// serializes the readers of the progress
+		std::mutex progress_mtx;
+		// S_FALSE while not finished
+		std::atomic<HRESULT> result{ S_FALSE };
+		// generations of the checkpointed segments already finished, out of the total
+		std::atomic<size_t> completed_generations{ 0 };
+		size_t total_generations = 0;
+	};
+
+	std::vector<std::unique_ptr<TOptimization_Start>> mStarts;
+	std::unique_ptr<CThread_Pool> mStart_Pool;
+
+	// consistent copy of the progress the solver of given start is writing
+	static solver::TSolver_Progress Progress_Snapshot(TOptimization_Start& start);
+
+	// memoized fitness, shared by all the starts of a run, when the evaluations are cached
+	CFitness_Cache mFitness_Cache;
+	bool mUse_Fitness_Cache = false;
+
+	// runs all the starts and commits the best result; body of the solver thread
+	void Run_Starts(const int popSize, const int maxGens, const int segmentGens);
+	// copies the optimized parameters of given start to mConfiguration
+	HRESULT Commit_Parameters(TOptimization_Start& start);
+	void Aggregate_Progress();
+	void Update_Starts_Table();
+
+	// best solution found so far, written to disk whenever it improves and periodically with the progress
+	std::mutex mCheckpoint_Mtx;
+	solver::TFitness mCheckpoint_Metric = solver::Nan_Fitness;
+	std::vector<std::vector<double>> mCheckpoint_Parameters;
+	QDateTime mLast_Checkpoint;
+	// incremented with every snapshot taken for writing
+	uint64_t mCheckpoint_Sequence = 0;
+	// solver hint taken from the checkpoint when resuming; empty otherwise
+	std::vector<double> mResume_Hint;
+
+	// content of the checkpoint file, taken under mCheckpoint_Mtx and written outside of it
+	struct TCheckpoint_Snapshot {
+		uint64_t sequence = 0;
+		size_t current_progress = 0, max_progress = 0;
+		size_t start_count = 0;
+		solver::TFitness metric = solver::Nan_Fitness;
+		std::vector<std::vector<double>> parameters;
+	};
+
+	// serializes the writers of the checkpoint file, so that an older snapshot never replaces a newer one
+	std::mutex mCheckpoint_File_Mtx;
+	uint64_t mCheckpoint_Written = 0;
+	// identifies the filters of the chain, so that every chain has a checkpoint file of its own
+	QString mCheckpoint_Key;
+
+	QString Checkpoint_Path() const;
+	// values of the parameters being optimized, as stored in given configuration
+	std::vector<std::vector<double>> Read_Parameters(scgms::SFilter_Chain_Configuration configuration) const;
+	// solver hint - concatenated current values (the middle third of lower, current and upper bounds) of the parameters
+	static std::vector<double> Hint_From_Parameters(const std::vector<std::vector<double>>& parameters);
+	// called by a start after every finished segment
+	void Record_Checkpoint(TOptimization_Start& start);
+	void Save_Checkpoint();
+	void Write_Checkpoint(const TCheckpoint_Snapshot& snapshot);
+	// reads the parameters, the metric and the generations a start completed of the checkpoint, if it matches the selected parameters
+	bool Load_Checkpoint(std::vector<std::vector<double>>& parameters, solver::TFitness& metric, size_t& completed_generations);
 
 	void Stop_Threads();
 	void Stop_Async();
-signals:
-	void Update_Progress_Signal();
 protected slots:
 	void On_Solve();
 	void On_Stop();	
+	// runs the chosen solvers one after another with the same budget and writes the comparison report
+	void On_Benchmark();
 	void On_Update_Progress();
+	void On_Solve_Finished();
+	void On_Objective_Used(int objective);
 
 	void reject();
 public:
@@ -107,7 +107,7 @@ void CDrawing_Graphics_View::animFinished()
 }
 
 CDrawing_Tab_Widget::CDrawing_Tab_Widget(const scgms::TDrawing_Image_Type type, QWidget *parent)
-	: CAbstract_Simulation_Tab_Widget(parent), mType(type), mItem(nullptr), mDiagnosis_Box(nullptr), mCurrent_Diagnosis(scgms::TDiagnosis::Type1)
+	: CAbstract_Simulation_Tab_Widget(parent), mType(type), mDiagnosis_Box(nullptr), mCurrent_Diagnosis(scgms::TDiagnosis::Type1)
 {
 	mView = new CDrawing_Graphics_View();
 	mScene = new QGraphicsScene(mView);
@@ -116,7 +116,10 @@ CDrawing_Tab_Widget::CDrawing_Tab_Widget(const scgms::TDrawing_Image_Type type,
 	mView->setDragMode(QGraphicsView::ScrollHandDrag);
 	mView->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
 
-	mRenderer = new QSvgRenderer();
+	// the item lives as long as the widget; new documents are handed over to its background renderers
+	mItem = new CSvg_Tile_Item();
+	mItem->setZValue(0);
+	mScene->addItem(mItem);
 
 	QGridLayout *mainLayout = new QGridLayout;
 	mainLayout->addWidget(mView, 0, 0);
@@ -144,11 +147,8 @@ CDrawing_Tab_Widget::CDrawing_Tab_Widget(const scgms::TDrawing_Image_Type type,
 
 CDrawing_Tab_Widget::~CDrawing_Tab_Widget()
 {
-	if (mItem)
-		delete mItem;
-
+	// scene owns the item
 	mScene->clear();
-	delete mRenderer;
 }
 
 void CDrawing_Tab_Widget::Update_View_Size()
@@ -170,13 +170,27 @@ void CDrawing_Tab_Widget::Drawing_Callback(const scgms::TDrawing_Image_Type type
 	if (type != mType)
 		return;
 
+	const size_t hash = std::hash<std::string>{}(svg);
+
 	std::unique_lock<std::mutex> lck(mDrawMtx);
 
+	// the inspection regenerates the drawing even if no new data arrived in the meantime; the hash just spares most of the comparisons
+	auto existing = mSvg_Hashes.find(diagnosis);
+	if (existing != mSvg_Hashes.end() && existing->second == hash && mSvgContents[diagnosis] == svg)
+		return;
+
 	mSvgContents[diagnosis] = svg;
+	mSvg_Hashes[diagnosis] = hash;
+	mSvg_Generations[diagnosis] = ++mLast_Generation;
 
 	Redraw();
 }
 
+scgms::TDrawing_Image_Type CDrawing_Tab_Widget::Get_Type() const
+{
+	return mType;
+}
+
 void CDrawing_Tab_Widget::Redraw()
 {
 	if (!mDefered_Work)
@@ -193,28 +207,31 @@ void CDrawing_Tab_Widget::Slot_Redraw()
 	if (mSvgContents.find(mCurrent_Diagnosis) != mSvgContents.end())
 		diag = mCurrent_Diagnosis;
 
+	QByteArray document;
+
 	// lock scope
 	{
 		std::unique_lock<std::mutex> lck(mDrawMtx);
 
-		mRenderer->load(QByteArray::fromStdString(mSvgContents[diag]));
-
 		mDefered_Work = false;
-	}
 
-	if (mItem)
-		delete mItem;
+		const uint64_t generation = mSvg_Generations[diag];
+		if (diag == mRendered_Diagnosis && generation == mRendered_Generation)
+			return;
 
-	mScene->clear();
-	mView->viewport()->update();
+		// e.g.; switching between diagnoses with the same picture; compared with the stored document of the rendered diagnosis, if it is still the rendered one
+		const bool rendered_stored = mRendered_Generation != 0 && mSvg_Generations[mRendered_Diagnosis] == mRendered_Generation;
+		const bool same_picture = rendered_stored && mSvg_Hashes[diag] == mSvg_Hashes[mRendered_Diagnosis] && mSvgContents[diag] == mSvgContents[mRendered_Diagnosis];
 
-	mItem = new QGraphicsSvgItem();
-	mItem->setSharedRenderer(mRenderer);
-	mItem->setFlags(QGraphicsItem::ItemClipsToShape);
-	mItem->setCacheMode(QGraphicsItem::NoCache);
-	mItem->setZValue(0);
+		mRendered_Diagnosis = diag;
+		mRendered_Generation = generation;
+		if (same_picture)
+			return;
 
-	mScene->addItem(mItem);
+		document = QByteArray::fromStdString(mSvgContents[diag]);
+	}
+
+	mItem->Set_Document(document);
 	//mView->fitInView(mItem, Qt::AspectRatioMode::KeepAspectRatio);
 }
 
@@ -42,15 +42,10 @@
 #include <QtWidgets/QGraphicsView>
 #include <QtWidgets/QGraphicsScene>
 #include <QtWidgets/QComboBox>
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-#include <QtSvg/QGraphicsSvgItem>
-#else
-#include <QtSvgWidgets/QGraphicsSvgItem>
-#endif
-#include <QtSvg/QSvgRenderer>
 
 #include <scgms/iface/FilterIface.h>
 #include "abstract_simulation_tab.h"
+#include "svg_tile_item.h"
 
 #include <mutex>
 #include <map>
@@ -86,10 +81,8 @@ class CDrawing_Tab_Widget : public CAbstract_Simulation_Tab_Widget
 		// maintained output type
 		const scgms::TDrawing_Image_Type mType;
 
-		// drawn item
-		QGraphicsSvgItem* mItem;
-		// SVG renderer
-		QSvgRenderer* mRenderer;
+		// drawn item, rasterized in background
+		CSvg_Tile_Item* mItem;
 		// main graphics view ("canvas")
 		CDrawing_Graphics_View* mView;
 		// main scene
@@ -99,6 +92,14 @@ class CDrawing_Tab_Widget : public CAbstract_Simulation_Tab_Widget
 
 		// contents of SVG to be drawn
 		std::map<scgms::TDiagnosis, std::string> mSvgContents;
+		// hashes of SVG contents, to recognize unchanged documents
+		std::map<scgms::TDiagnosis, size_t> mSvg_Hashes;
+		// generations of SVG contents; every replacement by a different document gets a new one, unique across the diagnoses
+		std::map<scgms::TDiagnosis, uint64_t> mSvg_Generations;
+		uint64_t mLast_Generation = 0;
+		// diagnosis and generation of the document currently loaded in renderer
+		scgms::TDiagnosis mRendered_Diagnosis = scgms::TDiagnosis::NotSpecified;
+		uint64_t mRendered_Generation = 0;
 		// draw mutex
 		std::mutex mDrawMtx;
 
@@ -128,4 +129,6 @@ class CDrawing_Tab_Widget : public CAbstract_Simulation_Tab_Widget
 		void Drawing_Callback(const scgms::TDrawing_Image_Type type, const scgms::TDiagnosis diagnosis, const std::string &svg);
 
 		void Redraw();
+
+		scgms::TDrawing_Image_Type Get_Type() const;
 };
@@ -94,7 +94,7 @@ void CDrawing_v2_Graphics_View::animFinished()
 }
 
 CDrawing_v2_Tab_Widget::CDrawing_v2_Tab_Widget(QWidget *parent)
-	: CAbstract_Simulation_Tab_Widget(parent), mItem(nullptr)
+	: CAbstract_Simulation_Tab_Widget(parent)
 {
 	mView = new CDrawing_v2_Graphics_View();
 	mScene = new QGraphicsScene(mView);
@@ -103,7 +103,10 @@ CDrawing_v2_Tab_Widget::CDrawing_v2_Tab_Widget(QWidget *parent)
 	mView->setDragMode(QGraphicsView::ScrollHandDrag);
 	mView->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
 
-	mRenderer = new QSvgRenderer();
+	// the item lives as long as the widget; new documents are handed over to its background renderers
+	mItem = new CSvg_Tile_Item();
+	mItem->setZValue(0);
+	mScene->addItem(mItem);
 
 	QGridLayout *mainLayout = new QGridLayout;
 	mainLayout->addWidget(mView, 0, 0);
@@ -117,11 +120,8 @@ CDrawing_v2_Tab_Widget::CDrawing_v2_Tab_Widget(QWidget *parent)
 
 CDrawing_v2_Tab_Widget::~CDrawing_v2_Tab_Widget()
 {
-	if (mItem)
-		delete mItem;
-
+	// scene owns the item
 	mScene->clear();
-	delete mRenderer;
 }
 
 void CDrawing_v2_Tab_Widget::Update_View_Size()
@@ -139,9 +139,17 @@ CAbstract_Simulation_Tab_Widget* CDrawing_v2_Tab_Widget::Clone()
 
 void CDrawing_v2_Tab_Widget::Drawing_Callback(const std::string &svg)
 {
+	const size_t hash = std::hash<std::string>{}(svg);
+
 	std::unique_lock<std::mutex> lck(mDrawMtx);
 
+	// the inspection regenerates the drawing even if no new data arrived in the meantime; the hash just spares most of the comparisons
+	if (!mSvgContents.empty() && hash == mSvg_Hash && mSvgContents == svg)
+		return;
+
 	mSvgContents = svg;
+	mSvg_Hash = hash;
+	mSvg_Generation++;
 
 	Redraw();
 }
@@ -157,28 +165,22 @@ void CDrawing_v2_Tab_Widget::Redraw()
 
 void CDrawing_v2_Tab_Widget::Slot_Redraw()
 {
+	QByteArray document;
+
 	// lock scope
 	{
 		std::unique_lock<std::mutex> lck(mDrawMtx);
 
-		mRenderer->load(QByteArray::fromStdString(mSvgContents));
-
 		mDefered_Work = false;
-	}
-
-	if (mItem)
-		delete mItem;
 
-	mScene->clear();
-	mView->viewport()->update();
+		if (mSvg_Generation == mRendered_Generation)
+			return;
 
-	mItem = new QGraphicsSvgItem();
-	mItem->setSharedRenderer(mRenderer);
-	mItem->setFlags(QGraphicsItem::ItemClipsToShape);
-	mItem->setCacheMode(QGraphicsItem::NoCache);
-	mItem->setZValue(0);
+		document = QByteArray::fromStdString(mSvgContents);
+		mRendered_Generation = mSvg_Generation;
+	}
 
-	mScene->addItem(mItem);
+	mItem->Set_Document(document);
 	//mView->fitInView(mItem, Qt::AspectRatioMode::KeepAspectRatio);
 }
 
@@ -42,16 +42,10 @@
 #include <QtWidgets/QGraphicsView>
 #include <QtWidgets/QGraphicsScene>
 #include <QtWidgets/QComboBox>
-#include <QtSvg/QSvgRenderer>
-
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-#include <QtSvg/QGraphicsSvgItem>
-#else
-#include <QtSvgWidgets/QGraphicsSvgItem>
-#endif
 
 #include <scgms/iface/FilterIface.h>
 #include "abstract_simulation_tab.h"
+#include "svg_tile_item.h"
 
 #include <mutex>
 #include <map>
@@ -84,10 +78,8 @@ class CDrawing_v2_Tab_Widget : public CAbstract_Simulation_Tab_Widget
 		Q_OBJECT
 
 	protected:
-		// drawn item
-		QGraphicsSvgItem* mItem;
-		// SVG renderer
-		QSvgRenderer* mRenderer;
+		// drawn item, rasterized in background
+		CSvg_Tile_Item* mItem;
 		// main graphics view ("canvas")
 		CDrawing_v2_Graphics_View* mView;
 		// main scene
@@ -95,6 +87,12 @@ class CDrawing_v2_Tab_Widget : public CAbstract_Simulation_Tab_Widget
 
 		// contents of SVG to be drawn
 		std::string mSvgContents;
+		// hash of SVG contents, to recognize unchanged documents
+		size_t mSvg_Hash = 0;
+		// incremented whenever the contents get replaced by a different document
+		uint64_t mSvg_Generation = 0;
+		// generation of the document currently loaded in renderer
+		uint64_t mRendered_Generation = 0;
 		// draw mutex
 		std::mutex mDrawMtx;
 
@@ -39,12 +39,28 @@
 #include <scgms/lang/dstrings.h>
 #include <scgms/rtl/UILib.h>
 #include <scgms/utils/QtUtils.h>
+#include <scgms/rtl/rattime.h>
 
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QGridLayout>
 #include <QtWidgets/QScrollBar>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+#include <QtCore/QDateTime>
+#include <QtCore/QMetaObject>
+#include <QtCore/QPointer>
+#include <QtCore/QCoreApplication>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QTabWidget>
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+
+#include "../../utils/thread_pool.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
 
 #include <iostream>
 #include <fstream>
@@ -80,14 +96,15 @@ const std::array<const wchar_t*, Error_Column_Count>  gError_Column_Names = {
 };
 
 
-CErrors_Tab_Widget_internal::CError_Table_Model::CError_Table_Model(QObject *parent) noexcept : QAbstractTableModel(parent) {
+CErrors_Tab_Widget_internal::CError_Table_Model::CError_Table_Model(QObject *parent) noexcept
+	: QAbstractTableModel(parent), mSnapshot(std::make_shared<TError_Snapshot>()), mProduced(mSnapshot) {
 	//
 }
 
 int CErrors_Tab_Widget_internal::CError_Table_Model::rowCount(const QModelIndex &idx) const
 {
 	//return mMaxSignalRow * static_cast<int>(scgms::NError_Type::count);
-	const size_t signal_errors_size = mSignal_Errors.size();
+	const size_t signal_errors_size = mSnapshot->size();
 	return signal_errors_size == 0 ?  0 : 3 * static_cast<int>(signal_errors_size)-1;
 }
 
@@ -145,6 +162,7 @@ QVariant CErrors_Tab_Widget_internal::CError_Table_Model::data(const QModelIndex
 
 
 	if (role == Qt::DisplayRole || role == Qt::EditRole) {
+		const TError_Snapshot& signal_errors = *mSnapshot;
 		const int row = index.row();
 		const int col = index.column();
 
@@ -162,24 +180,24 @@ QVariant CErrors_Tab_Widget_internal::CError_Table_Model::data(const QModelIndex
 		constexpr int rel50_col = 15;
 		
 		if (col == desc_col) {
-			return QVariant{ QString::fromStdWString(mSignal_Errors[error_index].description) };
+			return QVariant{ QString::fromStdWString(signal_errors[error_index].description) };
 		}
 		else if (col < rel5_col) {
 
 			switch (row_role) {
-				case absolute_role: return display_signal(col, mSignal_Errors[error_index].recent_abs_error, false); break;
-				case relative_role:	return display_signal(col, mSignal_Errors[error_index].recent_rel_error, true); break;
+				case absolute_role: return display_signal(col, signal_errors[error_index].recent_abs_error, false); break;
+				case relative_role:	return display_signal(col, signal_errors[error_index].recent_rel_error, true); break;
 				default: return QVariant();	//spacing role
 			}
 		}
 		else if ((col>= rel5_col) && (row_role == relative_role)) {
 			//relative errors
 				switch (col) {
-					case rel5_col: return Format_Error_String(mSignal_Errors[error_index].r5, true); break;
-					case rel10_col: return Format_Error_String(mSignal_Errors[error_index].r10, true); break;
-					case rel25_col: return Format_Error_String(mSignal_Errors[error_index].r25, true); break;
-					case rel50_col: return Format_Error_String(mSignal_Errors[error_index].r50, true); break;
-					default: return display_signal(col, mSignal_Errors[error_index].recent_rel_error, true); break;
+					case rel5_col: return Format_Error_String(signal_errors[error_index].r5, true); break;
+					case rel10_col: return Format_Error_String(signal_errors[error_index].r10, true); break;
+					case rel25_col: return Format_Error_String(signal_errors[error_index].r25, true); break;
+					case rel50_col: return Format_Error_String(signal_errors[error_index].r50, true); break;
+					default: return display_signal(col, signal_errors[error_index].recent_rel_error, true); break;
 				}						
 		} else
 			return QVariant{};	//default value
@@ -212,83 +230,705 @@ QVariant CErrors_Tab_Widget_internal::CError_Table_Model::headerData(int section
 
 CErrors_Tab_Widget_internal::CError_Table_Model* CErrors_Tab_Widget_internal::CError_Table_Model::Clone(QObject *parent) {
 	CErrors_Tab_Widget_internal::CError_Table_Model* result = new CErrors_Tab_Widget_internal::CError_Table_Model(parent);
-	result->mSignal_Errors.assign(this->mSignal_Errors.begin(), this->mSignal_Errors.end());
+	// snapshots are immutable, so they can be shared
+	result->mSnapshot = mSnapshot;
+	result->mProduced = mSnapshot;
+
+	// the clone does not calculate anything, but it keeps the history recorded so far
+	std::unique_lock<std::mutex> lck(mSource_Mtx);
+	for (const auto& source : mSources) {
+		TSignal_Error_Source copy;
+		copy.history = source.history;
+		result->mSources.push_back(std::move(copy));
+	}
+
 	return result;
 }
 
+std::vector<TError_Record> CErrors_Tab_Widget_internal::CError_Table_Model::Get_Error_Records(const std::string& run, const std::set<size_t>& signal_indices,
+	const std::vector<uint64_t>& segment_ids) const {
 
-void CErrors_Tab_Widget_internal::CError_Table_Model::On_Filter_Configured(scgms::IFilter *filter) {
-	CErrors_Tab_Widget_internal::TSignal_Error_Inspection inspection;
+	std::vector<TError_Record> records;
+	const TError_Snapshot& signal_errors = *mSnapshot;
+
+	std::vector<scgms::SSignal_Error_Inspection> inspections(signal_errors.size());
+	{
+		std::unique_lock<std::mutex> lck(mSource_Mtx);
+		for (size_t i = 0; i < inspections.size() && i < mSources.size(); i++)
+			inspections[i] = mSources[i].signal_error;
+	}
+
+	for (size_t i = 0; i < signal_errors.size(); i++) {
+		if (!signal_indices.empty() && signal_indices.find(i) == signal_indices.end())
+			continue;
+
+		const std::string description = QString::fromStdWString(signal_errors[i].description).toStdString();
+		records.push_back({ run, description, scgms::All_Segments_Id, false, signal_errors[i].recent_abs_error });
+		records.push_back({ run, description, scgms::All_Segments_Id, true, signal_errors[i].recent_rel_error });
+
+		// a cloned model keeps no filters, so it has the overall values only
+		if (!inspections[i])
+			continue;
+
+		for (const uint64_t segment_id : segment_ids) {
+			TError_Record abs_record{ run, description, segment_id, false };
+			TError_Record rel_record{ run, description, segment_id, true };
+			if (inspections[i]->Calculate_Signal_Error(segment_id, &abs_record.stats, &rel_record.stats) == S_OK) {
+				records.push_back(std::move(abs_record));
+				records.push_back(std::move(rel_record));
+			}
+		}
+	}
+
+	return records;
+}
+
+std::vector<CErrors_Tab_Widget_internal::TError_History_Sample> CErrors_Tab_Widget_internal::CError_Table_Model::Get_History(const size_t signal_index) const {
+	std::unique_lock<std::mutex> lck(mSource_Mtx);
+	return signal_index < mSources.size() ? mSources[signal_index].history.To_Vector() : std::vector<TError_History_Sample>{};
+}
+
+namespace {
+	bool Same_Value(const double a, const double b) {
+		return a == b || (std::isnan(a) && std::isnan(b));
+	}
+
+	bool Same_Stats(const scgms::TSignal_Stats& a, const scgms::TSignal_Stats& b) {
+		if (a.count != b.count || !Same_Value(a.avg, b.avg) || !Same_Value(a.stddev, b.stddev) || !Same_Value(a.exc_kurtosis, b.exc_kurtosis)
+			|| !Same_Value(a.skewness, b.skewness) || !Same_Value(a.sum, b.sum))
+			return false;
+
+		return std::equal(std::begin(a.ecdf), std::end(a.ecdf), std::begin(b.ecdf), Same_Value);
+	}
+}
+
+bool CErrors_Tab_Widget_internal::CError_Table_Model::Calculate(const scgms::SSignal_Error_Inspection& inspection, TSignal_Error_Values& values) {
+	scgms::TSignal_Stats abs_error, rel_error;
+	if (!inspection || inspection->Calculate_Signal_Error(scgms::All_Segments_Id, &abs_error, &rel_error) != S_OK)
+		return false;
+
+	// the clock moves with every event, even with no effect on the errors, e.g.; a level of another signal
+	if (Same_Stats(abs_error, values.recent_abs_error) && Same_Stats(rel_error, values.recent_rel_error))
+		return false;
+
+	values.recent_abs_error = abs_error;
+	values.recent_rel_error = rel_error;
+	values.version++;
+
+	if (values.recent_rel_error.count > 0) {
+		values.r5 = Relative_Error_Range(values.recent_rel_error, 0.05);
+		values.r10 = Relative_Error_Range(values.recent_rel_error, 0.1);
+		values.r25 = Relative_Error_Range(values.recent_rel_error, 0.25);
+		values.r50 = Relative_Error_Range(values.recent_rel_error, 0.50);
+	}
 
-	inspection.signal_error = scgms::SSignal_Error_Inspection{ scgms::SFilter{filter} };
-	if (inspection.signal_error) {
-		wchar_t *tmp_desc;
-		inspection.description = inspection.signal_error->Get_Description(&tmp_desc) == S_OK ? tmp_desc : dsSignal_Unknown;
-		inspection.signal_error->Calculate_Signal_Error(scgms::All_Segments_Id, &inspection.recent_abs_error, &inspection.recent_rel_error);
-		inspection.r5 = inspection.r10 = inspection.r25 = inspection.r50 = std::numeric_limits<double>::quiet_NaN();
-		mSignal_Errors.push_back(inspection);
+	return true;
+}
+
+void CErrors_Tab_Widget_internal::CError_Table_Model::On_Filter_Configured(scgms::IFilter *filter) {
+	TSignal_Error_Source source;
+	source.signal_error = scgms::SSignal_Error_Inspection{ scgms::SFilter{filter} };
+	if (!source.signal_error)
+		return;
+
+	TSignal_Error_Values values;
+	wchar_t *tmp_desc;
+	values.description = source.signal_error->Get_Description(&tmp_desc) == S_OK ? tmp_desc : dsSignal_Unknown;
+	values.r5 = values.r10 = values.r25 = values.r50 = std::numeric_limits<double>::quiet_NaN();
+	Calculate(source.signal_error, values);
+
+	std::shared_ptr<const TError_Snapshot> snapshot;
+	{
+		std::unique_lock<std::mutex> lck(mSource_Mtx);
+		mSources.push_back(source);
+		mSources_Epoch++;
+
+		auto extended = std::make_shared<TError_Snapshot>(*mProduced);
+		extended->push_back(std::move(values));
+		mProduced = extended;
+		snapshot = extended;
 	}
+
+	// configured in GUI thread, so the snapshot can be applied right away
+	Apply_Snapshot(snapshot);
 }
 
-void CErrors_Tab_Widget_internal::CError_Table_Model::Update_Errors() {
+void CErrors_Tab_Widget_internal::CError_Table_Model::Update_Errors(const double device_time) {
+	struct TCalculation {
+		size_t index;
+		scgms::SSignal_Error_Inspection inspection;
+		ULONG logical_clock;
+		TSignal_Error_Values values;
+		bool changed = false;
+	};
+
+	std::vector<TCalculation> calculations;
+	uint64_t epoch;
+
+	{
+		std::unique_lock<std::mutex> lck(mSource_Mtx);
+
+		epoch = mSources_Epoch;
+		for (size_t i = 0; i < mSources.size() && i < mProduced->size(); i++) {
+			if (mSources[i].signal_error)
+				calculations.push_back({ i, mSources[i].signal_error, mSources[i].logical_clock, (*mProduced)[i] });
+		}
+	}
+
+	// the filters are queried without the lock, so that the GUI thread reading the history or the records never waits for them
+	bool any_moved = false;
+	for (auto& calculation : calculations) {
+		// every signal has its own clock, so a change of one does not recalculate the others
+		if (calculation.inspection->Logical_Clock(&calculation.logical_clock) != S_OK)
+			continue;
+
+		any_moved = true;
+		calculation.changed = Calculate(calculation.inspection, calculation.values);
+	}
+
+	if (!any_moved)
+		return;
 
-	bool called_begin_reset = false;
+	std::shared_ptr<const TError_Snapshot> snapshot;
+
+	{
+		std::unique_lock<std::mutex> lck(mSource_Mtx);
 
-	for (auto &signal_error : mSignal_Errors) {
-		if (signal_error.signal_error->Logical_Clock(&mErrors_Logical_Clock) == S_OK) {
+		// the filters were replaced in the meantime, so the results belong to none of the current ones
+		if (epoch != mSources_Epoch)
+			return;
 
-			if (!called_begin_reset) {
-				beginResetModel();
-				called_begin_reset = true;
+		std::shared_ptr<TError_Snapshot> updated;
+
+		for (auto& calculation : calculations) {
+			auto& source = mSources[calculation.index];
+			source.logical_clock = calculation.logical_clock;
+
+			const TSignal_Error_Values& values = calculation.changed ? calculation.values : (*mProduced)[calculation.index];
+			if (std::isfinite(device_time)) {
+				source.history.Push({ device_time, values.recent_abs_error.avg, values.recent_rel_error.avg,
+					values.recent_rel_error.ecdf[scgms::NECDF::median], values.recent_rel_error.ecdf[scgms::NECDF::p95] });
 			}
 
-			if (signal_error.signal_error && signal_error.signal_error->Calculate_Signal_Error(scgms::All_Segments_Id, &signal_error.recent_abs_error, &signal_error.recent_rel_error) == S_OK) {
-				if (signal_error.recent_rel_error.count > 0) {
-
-					auto inv_ecdf = [&signal_error](const double threshold)->double {
-						auto found = std::lower_bound(signal_error.recent_rel_error.ecdf.begin(), signal_error.recent_rel_error.ecdf.end(), threshold);
-						if (found != signal_error.recent_rel_error.ecdf.end()) {
-							return 0.01*static_cast<double>(std::distance(signal_error.recent_rel_error.ecdf.begin(), found));
-						}
-						else
-							return 1.0;	//100% relative
-					};
-
-					signal_error.r5 = inv_ecdf(0.05);
-					signal_error.r10 = inv_ecdf(0.1);
-					signal_error.r25 = inv_ecdf(0.25);
-					signal_error.r50 = inv_ecdf(0.50);
-				}
+			if (calculation.changed) {
+				if (!updated)
+					updated = std::make_shared<TError_Snapshot>(*mProduced);
+				(*updated)[calculation.index] = std::move(calculation.values);
 			}
 		}
+
+		if (!updated)
+			return;
+
+		mProduced = updated;
+		snapshot = updated;
 	}
 
-	if (called_begin_reset)
+	QMetaObject::invokeMethod(this, [this, snapshot]() { Apply_Snapshot(snapshot); }, Qt::QueuedConnection);
+}
+
+void CErrors_Tab_Widget_internal::CError_Table_Model::Apply_Snapshot(std::shared_ptr<const TError_Snapshot> snapshot) {
+	const auto previous = mSnapshot;
+
+	if (previous->size() != snapshot->size()) {
+		// signals come and go only between runs
+		beginResetModel();
+		mSnapshot = snapshot;
 		endResetModel();
+		emit On_Errors_Updated();
+		return;
+	}
+
+	mSnapshot = snapshot;
 
-	emit dataChanged(createIndex(0, 0), createIndex(rowCount() - 1, Error_Column_Count - 1));
+	for (size_t i = 0; i < snapshot->size(); i++) {
+		if ((*snapshot)[i].version != (*previous)[i].version) {
+			// absolute and relative rows of the signal; the third one is just a spacer
+			const int first_row = static_cast<int>(3 * i);
+			emit dataChanged(index(first_row, 0), index(first_row + 1, Error_Column_Count - 1));
+		}
+	}
+
+	emit On_Errors_Updated();
 }
 
 
 void CErrors_Tab_Widget_internal::CError_Table_Model::Clear_Filters(bool wipeTable) {
-	if (wipeTable)
-		mSignal_Errors.clear();
-	else
+	std::shared_ptr<const TError_Snapshot> snapshot;
+
+	{
+		std::unique_lock<std::mutex> lck(mSource_Mtx);
+		mSources_Epoch++;
+
+		if (wipeTable) {
+			mSources.clear();
+			mProduced = std::make_shared<TError_Snapshot>();
+			snapshot = mProduced;
+		}
+		else
+		{
+			for (auto& source : mSources) {
+				source.signal_error.reset();
+			}
+		}
+	}
+
+	if (snapshot)
+		Apply_Snapshot(snapshot);
+}
+
+
+CErrors_Tab_Widget_internal::CSegment_Error_Model::CSegment_Error_Model(QObject *parent) noexcept : QAbstractTableModel(parent) {
+	//
+}
+
+int CErrors_Tab_Widget_internal::CSegment_Error_Model::rowCount(const QModelIndex &idx) const {
+	std::unique_lock<std::mutex> lck(mMtx);
+	return static_cast<int>(mSegments.size());
+}
+
+int CErrors_Tab_Widget_internal::CSegment_Error_Model::columnCount(const QModelIndex &idx) const {
+	std::unique_lock<std::mutex> lck(mMtx);
+	return static_cast<int>(mSignals.size());
+}
+
+QVariant CErrors_Tab_Widget_internal::CSegment_Error_Model::data(const QModelIndex &index, int role) const {
+	if (role != Qt::DisplayRole)
+		return QVariant();
+
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	const size_t row = static_cast<size_t>(index.row());
+	const size_t col = static_cast<size_t>(index.column());
+	if (row >= mSegments.size() || col >= mSignals.size())
+		return QVariant();
+
+	auto cell = mCells.find({ col, mSegments[row].first });
+	if (cell == mCells.end() || !cell->second.valid)
+		return QVariant();
+
+	switch (mStatistic) {
+		case NStatistic::Absolute_Average: return Format_Error_String(cell->second.abs_error.avg, false);
+		case NStatistic::Relative_Average: return Format_Error_String(cell->second.rel_error.avg, true);
+		case NStatistic::Relative_Median: return Format_Error_String(cell->second.rel_error.ecdf[scgms::NECDF::median], true);
+		case NStatistic::Relative_95_Quantile: return Format_Error_String(cell->second.rel_error.ecdf[scgms::NECDF::p95], true);
+		case NStatistic::Relative_Maximum: return Format_Error_String(cell->second.rel_error.ecdf[scgms::NECDF::max_value], true);
+		default: return QVariant();
+	}
+}
+
+QVariant CErrors_Tab_Widget_internal::CSegment_Error_Model::headerData(int section, Qt::Orientation orientation, int role) const {
+	if (role != Qt::DisplayRole || section < 0)
+		return QVariant();
+
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	if (orientation == Qt::Horizontal && static_cast<size_t>(section) < mSignals.size())
+		return QString::fromStdWString(mSignals[section].description);
+	else if (orientation == Qt::Vertical && static_cast<size_t>(section) < mSegments.size())
+		return QString::number(mSegments[section].first);
+
+	return QVariant();
+}
+
+CErrors_Tab_Widget_internal::CSegment_Error_Model* CErrors_Tab_Widget_internal::CSegment_Error_Model::Clone(QObject *parent) {
+	CSegment_Error_Model* result = new CSegment_Error_Model(parent);
+
+	std::unique_lock<std::mutex> lck(mMtx);
+	for (const auto& signal : mSignals)
+		result->mSignals.push_back({ signal.description, scgms::SSignal_Error_Inspection{}, signal.logical_clock, signal.generation });
+	result->mSegments = mSegments;
+	result->mCells = mCells;
+	result->mStatistic = mStatistic;
+
+	return result;
+}
+
+void CErrors_Tab_Widget_internal::CSegment_Error_Model::On_Filter_Configured(scgms::IFilter *filter) {
+	scgms::SSignal_Error_Inspection inspection{ scgms::SFilter{filter} };
+	if (!inspection)
+		return;
+
+	wchar_t *tmp_desc;
+	TSignal signal;
+	signal.description = inspection->Get_Description(&tmp_desc) == S_OK ? tmp_desc : dsSignal_Unknown;
+	signal.inspection = inspection;
+
+	// structure changes only in GUI thread, so the size cannot change until the insertion
+	const int column = columnCount();
+	beginInsertColumns(QModelIndex(), column, column);
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		mSignals.push_back(std::move(signal));
+	}
+	endInsertColumns();
+}
+
+void CErrors_Tab_Widget_internal::CSegment_Error_Model::Clear_Filters(bool wipeTable) {
+	if (wipeTable) {
+		// the lock is never held while signalling the views, as they call back to the model
+		beginResetModel();
+		{
+			std::unique_lock<std::mutex> lck(mMtx);
+			mSignals.clear();
+			mSegments.clear();
+			mCells.clear();
+			mIn_Flight.clear();
+			mEpoch++;
+		}
+		endResetModel();
+	}
+	else {
+		std::unique_lock<std::mutex> lck(mMtx);
+		for (auto& signal : mSignals)
+			signal.inspection.reset();
+	}
+}
+
+void CErrors_Tab_Widget_internal::CSegment_Error_Model::Add_Segment(const uint64_t segment_id) {
+	int row;
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+
+		auto itr = std::lower_bound(mSegments.begin(), mSegments.end(), segment_id, [](const auto& segment, const uint64_t id) { return segment.first < id; });
+		if (itr != mSegments.end() && itr->first == segment_id)
+			return;
+
+		row = static_cast<int>(std::distance(mSegments.begin(), itr));
+	}
+
+	beginInsertRows(QModelIndex(), row, row);
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		mSegments.insert(mSegments.begin() + row, { segment_id, false });
+	}
+	endInsertRows();
+}
+
+void CErrors_Tab_Widget_internal::CSegment_Error_Model::Close_Segment(const uint64_t segment_id) {
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	auto itr = std::lower_bound(mSegments.begin(), mSegments.end(), segment_id, [](const auto& segment, const uint64_t id) { return segment.first < id; });
+	if (itr != mSegments.end() && itr->first == segment_id)
+		itr->second = true;
+}
+
+std::vector<uint64_t> CErrors_Tab_Widget_internal::CSegment_Error_Model::Segment_Ids() const {
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	std::vector<uint64_t> ids;
+	for (const auto& segment : mSegments)
+		ids.push_back(segment.first);
+
+	return ids;
+}
+
+void CErrors_Tab_Widget_internal::CSegment_Error_Model::Set_Statistic(const NStatistic statistic) {
+	int rows, columns;
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		mStatistic = statistic;
+		rows = static_cast<int>(mSegments.size());
+		columns = static_cast<int>(mSignals.size());
+	}
+
+	if (rows > 0 && columns > 0)
+		emit dataChanged(index(0, 0), index(rows - 1, columns - 1));
+}
+
+void CErrors_Tab_Widget_internal::CSegment_Error_Model::Update_Errors() {
+	struct TClock {
+		size_t signal;
+		scgms::SSignal_Error_Inspection inspection;
+		ULONG logical_clock;
+	};
+
+	struct TJob {
+		size_t signal;
+		uint64_t segment;
+		uint64_t generation;
+		bool final;
+		scgms::SSignal_Error_Inspection inspection;
+	};
+
+	std::vector<TClock> clocks;
+	uint64_t epoch;
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		epoch = mEpoch;
+		for (size_t i = 0; i < mSignals.size(); i++) {
+			if (mSignals[i].inspection)
+				clocks.push_back({ i, mSignals[i].inspection, mSignals[i].logical_clock });
+		}
+	}
+
+	// the error filters lock their data to answer, so they are never asked while we hold our own lock
+	std::vector<size_t> moved;
+	for (auto& clock : clocks) {
+		if (clock.inspection->Logical_Clock(&clock.logical_clock) == S_OK)
+			moved.push_back(clock.signal);
+	}
+
+	std::vector<TJob> jobs;
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+
+		// a new run might have wiped the grid in the meantime
+		if (epoch != mEpoch)
+			return;
+
+		for (const auto& clock : clocks)
+			mSignals[clock.signal].logical_clock = clock.logical_clock;
+		for (const size_t signal : moved)
+			mSignals[signal].generation++;
+
+		for (const auto& segment : mSegments) {
+			for (size_t i = 0; i < mSignals.size(); i++) {
+				if (!mSignals[i].inspection)
+					continue;
+
+				const std::pair<size_t, uint64_t> key{ i, segment.first };
+				// the result of the previous pass is still on its way; the clock is checked again once it lands
+				if (mIn_Flight.find(key) != mIn_Flight.end())
+					continue;
+
+				auto cell = mCells.find(key);
+				const bool dirty = cell == mCells.end() || (!cell->second.final && cell->second.generation != mSignals[i].generation);
+				if (dirty) {
+					jobs.push_back({ i, segment.first, mSignals[i].generation, segment.second, mSignals[i].inspection });
+					mIn_Flight.insert(key);
+				}
+			}
+		}
+	}
+
+	if (jobs.empty())
+		return;
+
+	// results of one pass are posted to GUI thread together, by whichever task finishes last
+	struct TBatch {
+		std::mutex mtx;
+		std::vector<TResult> results;
+		size_t remaining;
+	};
+
+	auto batch = std::make_shared<TBatch>();
+	batch->results.reserve(jobs.size());
+	batch->remaining = jobs.size();
+
+	// the model may be gone by the time the batch completes; the pointer is only checked in GUI thread
+	QPointer<CSegment_Error_Model> model{ this };
+
+	// one task per cell; an error filter that guards its data with a lock still serves different signals in parallel
+	auto& pool = Get_Shared_Thread_Pool();
+	for (auto& job : jobs) {
+		pool.Submit([job = std::move(job), epoch, batch, model]() {
+			TResult result{ epoch, job.signal, job.segment, job.generation, job.final, false };
+			result.valid = job.inspection->Calculate_Signal_Error(job.segment, &result.abs_error, &result.rel_error) == S_OK;
+
+			std::vector<TResult> results;
+			{
+				std::unique_lock<std::mutex> lck(batch->mtx);
+				batch->results.push_back(result);
+				if (--batch->remaining > 0)
+					return;
+				results = std::move(batch->results);
+			}
+
+			QMetaObject::invokeMethod(qApp, [model, results = std::move(results)]() {
+				if (model)
+					model->Apply_Results(results);
+			}, Qt::QueuedConnection);
+		});
+	}
+}
+
+void CErrors_Tab_Widget_internal::CSegment_Error_Model::Apply_Results(const std::vector<TResult>& results) {
+	int first_row = std::numeric_limits<int>::max(), last_row = -1;
+	int columns;
+
 	{
-		for (auto& signal_error : mSignal_Errors) {
-			signal_error.signal_error.reset();
+		std::unique_lock<std::mutex> lck(mMtx);
+
+		for (const auto& result : results) {
+			// a new run might have wiped the grid in the meantime
+			if (result.epoch != mEpoch || result.signal >= mSignals.size())
+				continue;
+
+			mIn_Flight.erase({ result.signal, result.segment });
+
+			auto segment = std::lower_bound(mSegments.begin(), mSegments.end(), result.segment, [](const auto& seg, const uint64_t id) { return seg.first < id; });
+			if (segment == mSegments.end() || segment->first != result.segment)
+				continue;
+
+			TCell& cell = mCells[{ result.signal, result.segment }];
+			cell.abs_error = result.abs_error;
+			cell.rel_error = result.rel_error;
+			cell.valid = result.valid;
+			cell.generation = result.generation;
+			cell.final = result.final;
+
+			const int row = static_cast<int>(std::distance(mSegments.begin(), segment));
+			first_row = std::min(first_row, row);
+			last_row = std::max(last_row, row);
 		}
+
+		columns = static_cast<int>(mSignals.size());
 	}
+
+	if (last_row >= 0 && columns > 0)
+		emit dataChanged(index(first_row, 0), index(last_row, columns - 1));
+}
+
+
+CErrors_Tab_Widget_internal::CError_Trend_Plot::CError_Trend_Plot(QWidget *parent) : QWidget(parent) {
+	setMinimumHeight(120);
+	setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void CErrors_Tab_Widget_internal::CError_Trend_Plot::Set_Samples(std::vector<TError_History_Sample> samples) {
+	mSamples = std::move(samples);
+	update();
+}
+
+QSize CErrors_Tab_Widget_internal::CError_Trend_Plot::sizeHint() const {
+	return QSize{ 400, 160 };
+}
+
+void CErrors_Tab_Widget_internal::CError_Trend_Plot::paintEvent(QPaintEvent* event) {
+	QPainter painter(this);
+	painter.setRenderHint(QPainter::Antialiasing, true);
+	painter.fillRect(rect(), palette().base());
+
+	const QFontMetrics metrics = painter.fontMetrics();
+	const int text_height = metrics.height();
+	const QRect area = rect().adjusted(metrics.horizontalAdvance(QStringLiteral("000.0 %")) + 6, text_height + 4, -8, -text_height - 4);
+	if (area.width() < 10 || area.height() < 10)
+		return;
+
+	painter.setPen(palette().color(QPalette::Mid));
+	painter.drawRect(area);
+
+	// series to plot, all of them relative errors
+	struct TSeries {
+		double TError_History_Sample::* value;
+		QColor color;
+		QString name;
+	};
+	const std::array<TSeries, 3> series = { {
+		{ &TError_History_Sample::rel_average, QColor{ 31, 119, 180 }, QString::fromWCharArray(dsError_Column_Average) },
+		{ &TError_History_Sample::rel_median, QColor{ 44, 160, 44 }, QString::fromWCharArray(dsError_Column_Median) },
+		{ &TError_History_Sample::rel_p95, QColor{ 214, 39, 40 }, QString::fromWCharArray(dsError_Column_95_Quantile) },
+	} };
+
+	int legend_x = area.left();
+	for (const auto& s : series) {
+		painter.setPen(s.color);
+		painter.drawText(legend_x, text_height, s.name);
+		legend_x += metrics.horizontalAdvance(s.name) + 12;
+	}
+
+	if (mSamples.size() < 2) {
+		painter.setPen(palette().color(QPalette::Text));
+		painter.drawText(area, Qt::AlignCenter, tr("Not enough data yet"));
+		return;
+	}
+
+	const double time_min = mSamples.front().device_time;
+	const double time_max = mSamples.back().device_time;
+	double value_max = 0.0;
+	for (const auto& sample : mSamples) {
+		for (const auto& s : series) {
+			if (std::isfinite(sample.*s.value))
+				value_max = std::max(value_max, sample.*s.value);
+		}
+	}
+	if (value_max <= 0.0)
+		value_max = 1.0;
+	const double time_span = time_max > time_min ? time_max - time_min : 1.0;
+
+	auto to_point = [&](const double time, const double value) {
+		return QPointF{ area.left() + area.width() * (time - time_min) / time_span, area.bottom() - area.height() * value / value_max };
+	};
+
+	for (const auto& s : series) {
+		QPainterPath path;
+		bool started = false;
+		for (const auto& sample : mSamples) {
+			const double value = sample.*s.value;
+			if (!std::isfinite(value)) {
+				started = false;
+				continue;
+			}
+
+			if (started)
+				path.lineTo(to_point(sample.device_time, value));
+			else
+				path.moveTo(to_point(sample.device_time, value));
+			started = true;
+		}
+
+		painter.setPen(QPen{ s.color, 1.5 });
+		painter.drawPath(path);
+	}
+
+	painter.setPen(palette().color(QPalette::Text));
+	painter.drawText(QRect{ 0, area.top() - text_height / 2, area.left() - 4, text_height }, Qt::AlignRight | Qt::AlignVCenter, QString("%1 %").arg(100.0 * value_max, 0, 'f', 1));
+	painter.drawText(QRect{ 0, area.bottom() - text_height / 2, area.left() - 4, text_height }, Qt::AlignRight | Qt::AlignVCenter, QStringLiteral("0 %"));
+	painter.drawText(QRect{ area.left(), area.bottom() + 2, area.width(), text_height }, Qt::AlignLeft, QString::fromStdWString(Rat_Time_To_Default_WStr(time_min)));
+	painter.drawText(QRect{ area.left(), area.bottom() + 2, area.width(), text_height }, Qt::AlignRight, QString::fromStdWString(Rat_Time_To_Default_WStr(time_max)));
 }
 
 
 CErrors_Tab_Widget::CErrors_Tab_Widget(QWidget *parent) noexcept: CAbstract_Simulation_Tab_Widget(parent) {
 	QGridLayout *mainLayout = new QGridLayout();
 
+	QTabWidget* views = new QTabWidget();
+
 	mTableView = new QTableView();
 	mModel = new CErrors_Tab_Widget_internal::CError_Table_Model(this);
 	mTableView->setModel(mModel);
-	mainLayout->addWidget(mTableView);
+	views->addTab(mTableView, tr("All segments"));
+
+	QWidget* segmentPage = new QWidget();
+	QGridLayout* segmentLayout = new QGridLayout();
+	segmentPage->setLayout(segmentLayout);
+
+	QHBoxLayout* statisticLayout = new QHBoxLayout();
+	statisticLayout->addWidget(new QLabel(tr("Statistic")));
+	mSegment_Statistic = new QComboBox();
+	mSegment_Statistic->addItem(QString("%1 - %2").arg(QString::fromWCharArray(dsAbsolute), QString::fromWCharArray(dsError_Column_Average)));
+	mSegment_Statistic->addItem(QString("%1 - %2").arg(QString::fromWCharArray(dsRelative), QString::fromWCharArray(dsError_Column_Average)));
+	mSegment_Statistic->addItem(QString("%1 - %2").arg(QString::fromWCharArray(dsRelative), QString::fromWCharArray(dsError_Column_Median)));
+	mSegment_Statistic->addItem(QString("%1 - %2").arg(QString::fromWCharArray(dsRelative), QString::fromWCharArray(dsError_Column_95_Quantile)));
+	mSegment_Statistic->addItem(QString("%1 - %2").arg(QString::fromWCharArray(dsRelative), QString::fromWCharArray(dsError_Column_Maximum)));
+	mSegment_Statistic->setCurrentIndex(static_cast<int>(CErrors_Tab_Widget_internal::CSegment_Error_Model::NStatistic::Relative_Average));
+	statisticLayout->addWidget(mSegment_Statistic);
+	statisticLayout->addStretch();
+	segmentLayout->addLayout(statisticLayout, 0, 0);
+
+	mSegment_View = new QTableView();
+	mSegment_Model = new CErrors_Tab_Widget_internal::CSegment_Error_Model(this);
+	mSegment_View->setModel(mSegment_Model);
+	segmentLayout->addWidget(mSegment_View, 1, 0);
+	views->addTab(segmentPage, tr("Per segment"));
+
+	QWidget* trendPage = new QWidget();
+	QGridLayout* trendLayout = new QGridLayout();
+	trendPage->setLayout(trendLayout);
+
+	QHBoxLayout* trendSignalLayout = new QHBoxLayout();
+	trendSignalLayout->addWidget(new QLabel(tr("Signal")));
+	mTrend_Signal = new QComboBox();
+	trendSignalLayout->addWidget(mTrend_Signal);
+	trendSignalLayout->addStretch();
+	trendLayout->addLayout(trendSignalLayout, 0, 0);
+
+	mTrend_Plot = new CErrors_Tab_Widget_internal::CError_Trend_Plot();
+	trendLayout->addWidget(mTrend_Plot, 1, 0);
+	views->addTab(trendPage, tr("Trend"));
+
+	mainLayout->addWidget(views, 0, 0);
 
 	QPushButton* exportBtn = new QPushButton(dsExport_To_CSV);
 	mainLayout->addWidget(exportBtn, 1, 0);
@@ -297,75 +937,62 @@ CErrors_Tab_Widget::CErrors_Tab_Widget(QWidget *parent) noexcept: CAbstract_Simu
 	setLayout(mainLayout);
 
 	connect(exportBtn, SIGNAL(clicked()), this, SLOT(Export_CSV_Button_Clicked()));
+	connect(mSegment_Statistic, SIGNAL(currentIndexChanged(int)), this, SLOT(On_Segment_Statistic_Change(int)));
+	connect(mTrend_Signal, SIGNAL(currentIndexChanged(int)), this, SLOT(Update_Trend()));
+	connect(mModel, SIGNAL(On_Errors_Updated()), this, SLOT(Update_Trend()));
+}
+
+void CErrors_Tab_Widget::Update_Trend()
+{
+	// signal names are the first column of every third row of the table; the last signal lacks the spacer row
+	const int signal_count = (mModel->rowCount() + 1) / 3;
+	if (mTrend_Signal->count() != signal_count) {
+		const int current = mTrend_Signal->currentIndex();
+		mTrend_Signal->blockSignals(true);
+		mTrend_Signal->clear();
+		for (int i = 0; i < signal_count; i++)
+			mTrend_Signal->addItem(mModel->data(mModel->index(3 * i, 0)).toString());
+		mTrend_Signal->setCurrentIndex(current >= 0 && current < signal_count ? current : 0);
+		mTrend_Signal->blockSignals(false);
+	}
+
+	const int signal = mTrend_Signal->currentIndex();
+	mTrend_Plot->Set_Samples(signal >= 0 ? mModel->Get_History(static_cast<size_t>(signal)) : std::vector<CErrors_Tab_Widget_internal::TError_History_Sample>{});
+}
+
+void CErrors_Tab_Widget::On_Segment_Statistic_Change(int index)
+{
+	if (index >= 0 && index < static_cast<int>(CErrors_Tab_Widget_internal::CSegment_Error_Model::NStatistic::count))
+		mSegment_Model->Set_Statistic(static_cast<CErrors_Tab_Widget_internal::CSegment_Error_Model::NStatistic>(index));
 }
 
 void CErrors_Tab_Widget::Export_CSV_Button_Clicked()
 {
-	auto path = QFileDialog::getSaveFileName(this, tr(dsExport_CSV_Dialog_Title), dsExport_CSV_Default_File_Name, tr(dsExport_CSV_Ext_Spec));
+	const QString csv_filter = tr(dsExport_CSV_Ext_Spec);
+	const QString columnar_filter = tr("Columnar error statistics, appended to existing file (*.scgerr)");
+
+	QString selected_filter;
+	auto path = QFileDialog::getSaveFileName(this, tr(dsExport_CSV_Dialog_Title), dsExport_CSV_Default_File_Name, csv_filter + ";;" + columnar_filter, &selected_filter);
 	if (path.length() != 0)
 	{
-		std::ofstream fs(path.toStdString());
-
-		int fromRow, fromCol, toRow, toCol;
-		fromRow = 0;
-		fromCol = 0;
-		toRow = mTableView->model()->rowCount() - 1;
-		toCol = mTableView->model()->columnCount() - 1;
-
+		// exported rows are limited to the signals of selected rows, if any; columns are always complete
+		std::set<size_t> signal_indices;
 		auto* selModel = mTableView->selectionModel();
 		if (selModel->hasSelection())
 		{
-			auto rowList = selModel->selectedRows();
-			if (!rowList.empty())
-			{
-				fromRow = mTableView->model()->rowCount() - 1;
-				toRow = 0;
-
-				for (auto& val : rowList)
-				{
-					if (val.row() > toRow)
-						toRow = val.row();
-					if (val.row() < fromRow)
-						fromRow = val.row();
-				}
-			}
-
-			auto colList = selModel->selectedColumns();
-			if (!colList.empty())
-			{
-				fromCol = mTableView->model()->columnCount() - 1;
-				toCol = 0;
-
-				for (auto& val : colList)
-				{
-					if (val.column() > toCol)
-						toCol = val.column();
-					if (val.column() < fromCol)
-						fromCol = val.column();
-				}
-			}
+			for (const auto& idx : selModel->selectedIndexes())
+				signal_indices.insert(static_cast<size_t>(idx.row()) / 3);
 		}
 
-		// skip one column
-		fs << ";";
-		for (int j = fromCol; j <= toCol; j++)
-			fs << mTableView->model()->headerData(j, Qt::Orientation::Horizontal).toString().toStdString() << ";";
-
-		fs << std::endl;
-
-		for (int i = fromRow; i <= toRow; i++)
-		{
-			fs << mTableView->model()->headerData(i, Qt::Orientation::Vertical).toString().toStdString() << ";";
+		auto model = static_cast<CErrors_Tab_Widget_internal::CError_Table_Model*>(mTableView->model());
+		const auto records = model->Get_Error_Records(QDateTime::currentDateTime().toString(Qt::ISODate).toStdString(), signal_indices, mSegment_Model->Segment_Ids());
 
-			for (int j = fromCol; j <= toCol; j++)
-			{
-				QModelIndex idx = mTableView->model()->index(i, j, QModelIndex());
-
-				fs << mTableView->model()->data(idx).toString().toStdString() << ";";
-			}
+		const filesystem::path target = path.toStdWString();
+		const bool columnar = selected_filter == columnar_filter || path.endsWith(".scgerr", Qt::CaseInsensitive);
+		const bool succeeded = columnar ? CError_Export::Append_Columnar(target, records) : CError_Export::Write_CSV(target, records);
 
-			fs << std::endl;
-		}
+		if (!succeeded)
+			QMessageBox::warning(this, tr(dsWarning), tr("Cannot export error metrics to %1").arg(path));
 	}
 }
 
@@ -374,21 +1001,46 @@ CAbstract_Simulation_Tab_Widget* CErrors_Tab_Widget::Clone() {
 	auto empty_model = cloned_widget->mTableView->model();
 	auto cloned_model = static_cast<CErrors_Tab_Widget_internal::CError_Table_Model*>(this->mTableView->model())->Clone();
 	cloned_widget->mTableView->setModel(cloned_model);
+	cloned_widget->mModel = cloned_model;
 	delete empty_model;
+	connect(cloned_model, SIGNAL(On_Errors_Updated()), cloned_widget, SLOT(Update_Trend()));
+	cloned_widget->Update_Trend();
+	cloned_widget->mTrend_Signal->setCurrentIndex(mTrend_Signal->currentIndex());
+
+	auto empty_segment_model = cloned_widget->mSegment_Model;
+	cloned_widget->mSegment_Model = mSegment_Model->Clone(cloned_widget);
+	cloned_widget->mSegment_View->setModel(cloned_widget->mSegment_Model);
+	delete empty_segment_model;
+	cloned_widget->mSegment_Statistic->setCurrentIndex(mSegment_Statistic->currentIndex());
 
 	return cloned_widget;
 }
 
 void CErrors_Tab_Widget::On_Filter_Configured(scgms::IFilter *filter) {
 	if (mModel) mModel->On_Filter_Configured(filter);
+	if (mSegment_Model) mSegment_Model->On_Filter_Configured(filter);
 }
 
-void CErrors_Tab_Widget::Refresh() {
+void CErrors_Tab_Widget::Refresh(const double device_time) {
 	if (mModel)
-		mModel->Update_Errors();
+		mModel->Update_Errors(device_time);
+	if (mSegment_Model)
+		mSegment_Model->Update_Errors();
 }
 
 void CErrors_Tab_Widget::Clear_Filters(bool wipeTable) {
 	if (mModel)
 		mModel->Clear_Filters(wipeTable);
+	if (mSegment_Model)
+		mSegment_Model->Clear_Filters(wipeTable);
+}
+
+void CErrors_Tab_Widget::Add_Segment(const uint64_t segment_id) {
+	if (mSegment_Model)
+		mSegment_Model->Add_Segment(segment_id);
+}
+
+void CErrors_Tab_Widget::Close_Segment(const uint64_t segment_id) {
+	if (mSegment_Model)
+		mSegment_Model->Close_Segment(segment_id);
 }
\ No newline at end of file
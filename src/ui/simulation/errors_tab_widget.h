@@ -45,10 +45,17 @@
 #include <scgms/rtl/UILib.h>
 
 #include "abstract_simulation_tab.h"
+#include "../../batch/error_export.h"
+#include "../../utils/history_ring.h"
 
 #include <QtWidgets/QTableView>
+#include <QtWidgets/QComboBox>
 #include <QtCore/QAbstractTableModel>
 #include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 
 /*
  * QTableView model for error values
@@ -56,19 +63,52 @@
 
 namespace CErrors_Tab_Widget_internal {
 
-	struct TSignal_Error_Inspection{
+	struct TSignal_Error_Values {
 		std::wstring description;
-		scgms::SSignal_Error_Inspection signal_error;
 		scgms::TSignal_Stats recent_abs_error;
 		scgms::TSignal_Stats recent_rel_error;
 		double r5 = 0.0, r10 = 0.0, r25 = 0.0, r50 = 0.0;	//inverse ECDF for relative errors
+		// incremented whenever a recalculation changes the values, so the GUI knows which rows changed
+		uint64_t version = 0;
+	};
+
+	// immutable state of all the signal errors; the producer replaces it as a whole
+	using TError_Snapshot = std::vector<TSignal_Error_Values>;
+
+	// how many recalculations of a signal's errors are remembered for the trend plot
+	constexpr size_t Error_History_Capacity = 2048;
+
+	struct TError_History_Sample {
+		double device_time;
+		double abs_average;
+		double rel_average;
+		double rel_median;
+		double rel_p95;
+	};
+
+	struct TSignal_Error_Source {
+		scgms::SSignal_Error_Inspection signal_error;
+		ULONG logical_clock = 0;
+		CHistory_Ring<TError_History_Sample> history{ Error_History_Capacity };
 	};
 
 	class CError_Table_Model : public QAbstractTableModel {
 		Q_OBJECT
 	protected:
-		ULONG mErrors_Logical_Clock = 0;
-		std::vector<TSignal_Error_Inspection> mSignal_Errors;
+		// snapshot displayed by the model; GUI thread only
+		std::shared_ptr<const TError_Snapshot> mSnapshot;
+
+		// producer side - filters to calculate the errors with and the most recent snapshot produced
+		mutable std::mutex mSource_Mtx;
+		std::vector<TSignal_Error_Source> mSources;
+		std::shared_ptr<const TError_Snapshot> mProduced;
+		// incremented whenever mSources get replaced, so that calculations made meanwhile get discarded
+		uint64_t mSources_Epoch = 0;
+
+		// recalculates the values; returns true (and bumps their version) only if they changed
+		static bool Calculate(const scgms::SSignal_Error_Inspection& inspection, TSignal_Error_Values& values);
+		// swaps the displayed snapshot for a newer one; GUI thread only
+		void Apply_Snapshot(std::shared_ptr<const TError_Snapshot> snapshot);
 	public:
 		explicit CError_Table_Model(QObject *parent = 0) noexcept;
 
@@ -78,10 +118,122 @@ namespace CErrors_Tab_Widget_internal {
 		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
 		
 		CError_Table_Model* Clone(QObject *parent = 0);
+
+		// statistics of given signals (indices of rows of the snapshot; all of them if empty) for export - over all the segments,
+		// then in each of given segments; GUI thread only
+		std::vector<TError_Record> Get_Error_Records(const std::string& run, const std::set<size_t>& signal_indices, const std::vector<uint64_t>& segment_ids) const;
+		// recorded history of given signal, oldest first
+		std::vector<TError_History_Sample> Get_History(const size_t signal_index) const;
 		
 		void On_Filter_Configured(scgms::IFilter *filter);
-		void Update_Errors();
+		// recalculates errors of signals with new data into a new snapshot and posts it to GUI thread; not to be called from GUI thread
+		void Update_Errors(const double device_time);
 		void Clear_Filters(bool wipeTable = true);
+
+	signals:
+		// a new snapshot is displayed
+		void On_Errors_Updated();
+	};
+
+	/*
+	 * Compact plot of relative error statistics of a single signal over the simulated time
+	 */
+	class CError_Trend_Plot : public QWidget {
+	protected:
+		std::vector<TError_History_Sample> mSamples;
+
+		void paintEvent(QPaintEvent* event) override;
+	public:
+		explicit CError_Trend_Plot(QWidget *parent = nullptr);
+
+		void Set_Samples(std::vector<TError_History_Sample> samples);
+
+		QSize sizeHint() const override;
+	};
+
+	/*
+	 * Grid of error metrics of every signal (columns) in every time segment (rows)
+	 * Stats of a segment are recomputed on the worker pool only when the signal's logical clock moved on and
+	 * the segment is still open; once computed after the segment closed, they are final
+	 */
+	class CSegment_Error_Model : public QAbstractTableModel {
+		Q_OBJECT
+	public:
+		enum class NStatistic {
+			Absolute_Average,
+			Relative_Average,
+			Relative_Median,
+			Relative_95_Quantile,
+			Relative_Maximum,
+
+			count
+		};
+
+	protected:
+		struct TSignal {
+			std::wstring description;
+			scgms::SSignal_Error_Inspection inspection;
+			ULONG logical_clock = 0;
+			// incremented whenever the logical clock reports a change
+			uint64_t generation = 1;
+		};
+
+		struct TCell {
+			scgms::TSignal_Stats abs_error, rel_error;
+			bool valid = false;
+			// generation of the signal the stats were computed for; zero if never computed
+			uint64_t generation = 0;
+			// computed after the segment closed, so they will not change anymore
+			bool final = false;
+		};
+
+		struct TResult {
+			uint64_t epoch;
+			size_t signal;
+			uint64_t segment;
+			uint64_t generation;
+			bool final;
+			bool valid;
+			scgms::TSignal_Stats abs_error, rel_error;
+		};
+
+		// guards everything below; the updater thread plans the work, GUI thread applies the results
+		mutable std::mutex mMtx;
+		std::vector<TSignal> mSignals;
+		// segments in ascending order, with flag whether the segment already closed
+		std::vector<std::pair<uint64_t, bool>> mSegments;
+		std::map<std::pair<size_t, uint64_t>, TCell> mCells;
+		// cells submitted to the pool whose results did not arrive yet
+		std::set<std::pair<size_t, uint64_t>> mIn_Flight;
+		// incremented when the grid is wiped, so that results computed for a previous run get discarded
+		uint64_t mEpoch = 0;
+
+		NStatistic mStatistic = NStatistic::Relative_Average;
+
+		void Apply_Results(const std::vector<TResult>& results);
+
+	public:
+		explicit CSegment_Error_Model(QObject *parent = 0) noexcept;
+
+		int rowCount(const QModelIndex &parent = QModelIndex()) const;
+		int columnCount(const QModelIndex &parent = QModelIndex()) const;
+		QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+		CSegment_Error_Model* Clone(QObject *parent = 0);
+
+		void On_Filter_Configured(scgms::IFilter *filter);
+		void Clear_Filters(bool wipeTable = true);
+
+		// GUI thread only
+		void Add_Segment(const uint64_t segment_id);
+		void Close_Segment(const uint64_t segment_id);
+		void Set_Statistic(const NStatistic statistic);
+		// ascending
+		std::vector<uint64_t> Segment_Ids() const;
+
+		// submits cells whose signal clock moved to the worker pool and returns; the results are applied in GUI thread
+		void Update_Errors();
 	};
 
 }
@@ -96,15 +248,28 @@ protected:
 	QTableView* mTableView;
 	// table model for error metrics
 	CErrors_Tab_Widget_internal::CError_Table_Model* mModel;
+	// per-segment error metrics
+	QTableView* mSegment_View;
+	CErrors_Tab_Widget_internal::CSegment_Error_Model* mSegment_Model;
+	QComboBox* mSegment_Statistic;
+	// trend of error metrics of the selected signal
+	QComboBox* mTrend_Signal;
+	CErrors_Tab_Widget_internal::CError_Trend_Plot* mTrend_Plot;
 	// stored signal names	
     const scgms::CSignal_Description mSignal_Descriptions;
 public slots:
 	void Export_CSV_Button_Clicked();
+	void On_Segment_Statistic_Change(int index);
+	void Update_Trend();
 
 public:
 	explicit CErrors_Tab_Widget(QWidget *parent = 0) noexcept;
 	virtual CAbstract_Simulation_Tab_Widget* Clone() override; 		
-	void Refresh();	
+	void Refresh(const double device_time);
 	void On_Filter_Configured(scgms::IFilter *filter);
 	void Clear_Filters(bool wipeTable);
+
+	// time segments the per-segment grid shows; GUI thread only
+	void Add_Segment(const uint64_t segment_id);
+	void Close_Segment(const uint64_t segment_id);
 };
@@ -0,0 +1,242 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "log_index.h"
+
+#include <algorithm>
+
+// a column is checked for its cardinality once this many rows got indexed, so that the start of the log does not mislead
+constexpr uint32_t Log_Index_Cardinality_Check_Rows = 10000;
+// a column with more distinct values per indexed row is dropped from the index
+constexpr double Log_Index_Max_Distinct_Ratio = 0.2;
+// runs of a range column collected before they get sorted into a block
+constexpr size_t Log_Index_Runs_Per_Block = 4096;
+
+CLog_Index::CLog_Index(std::vector<size_t> columns, const std::vector<size_t>& range_columns, std::function<void()> on_indexed)
+	: mColumns(std::move(columns)), mRanged(mColumns.size(), false), mValues(mColumns.size()), mRanges(mColumns.size()), mDropped(mColumns.size(), false),
+	mOn_Indexed(std::move(on_indexed)) {
+
+	for (size_t i = 0; i < mColumns.size(); i++)
+		mRanged[i] = std::find(range_columns.begin(), range_columns.end(), mColumns[i]) != range_columns.end();
+
+	mWorker = std::thread(&CLog_Index::Run_Worker, this);
+}
+
+CLog_Index::~CLog_Index() {
+	{
+		std::unique_lock<std::mutex> lck(mQueue_Mtx);
+		mStop = true;
+	}
+	mQueue_Cv.notify_all();
+
+	if (mWorker.joinable())
+		mWorker.join();
+}
+
+void CLog_Index::Append(const uint32_t first_row, const QStringList& lines) {
+	if (lines.isEmpty() || mColumns.empty())
+		return;
+
+	{
+		std::unique_lock<std::mutex> lck(mQueue_Mtx);
+		mQueue.push_back({ first_row, lines });
+	}
+	mQueue_Cv.notify_one();
+}
+
+void CLog_Index::Run_Worker() {
+	while (true) {
+		TBatch batch;
+
+		{
+			std::unique_lock<std::mutex> lck(mQueue_Mtx);
+			mQueue_Cv.wait(lck, [this]() { return mStop || !mQueue.empty(); });
+			if (mStop)
+				return;
+
+			batch = std::move(mQueue.front());
+			mQueue.pop_front();
+		}
+
+		Index_Batch(batch);
+
+		if (mOn_Indexed)
+			mOn_Indexed();
+	}
+}
+
+void CLog_Index::Index_Batch(const TBatch& batch) {
+	// split the lines before taking the lock, so that queries are not blocked by parsing
+	std::vector<std::vector<QString>> values(mColumns.size());
+	for (auto& column_values : values)
+		column_values.reserve(static_cast<size_t>(batch.lines.size()));
+
+	for (const auto& line : batch.lines) {
+		const QStringList fields = line.split(QLatin1Char(';'));
+		for (size_t i = 0; i < mColumns.size(); i++)
+			values[i].push_back(mColumns[i] < static_cast<size_t>(fields.size()) ? fields[static_cast<int>(mColumns[i])].trimmed().toCaseFolded() : QString());
+	}
+
+	std::unique_lock<std::shared_mutex> lck(mIndex_Mtx);
+
+	for (size_t i = 0; i < mColumns.size(); i++) {
+		if (mDropped[i])
+			continue;
+
+		for (size_t j = 0; j < values[i].size(); j++) {
+			if (values[i][j].isEmpty())
+				continue;
+
+			const uint32_t row = batch.first_row + static_cast<uint32_t>(j);
+			if (mRanged[i])
+				Add_Run(mRanges[i], values[i][j], row);
+			else
+				mValues[i][values[i][j]].push_back(row);
+		}
+	}
+
+	mIndexed_Rows = std::max(mIndexed_Rows, batch.first_row + static_cast<uint32_t>(batch.lines.size()));
+
+	if (mIndexed_Rows >= Log_Index_Cardinality_Check_Rows) {
+		for (size_t i = 0; i < mColumns.size(); i++) {
+			if (!mDropped[i] && !mRanged[i] && static_cast<double>(mValues[i].size()) > Log_Index_Max_Distinct_Ratio * static_cast<double>(mIndexed_Rows)) {
+				// swap releases the memory, unlike clear
+				std::map<QString, TPostings>{}.swap(mValues[i]);
+				mDropped[i] = true;
+				mDropped_Count++;
+			}
+		}
+	}
+}
+
+void CLog_Index::Add_Run(TRange_Index& range, const QString& value, const uint32_t row) {
+	// the log keeps its time order, mostly, so neighbouring rows tend to share the value
+	if (!range.open.empty()) {
+		TRun& last = range.open.back();
+		if (last.first_row + last.row_count == row && last.value == value) {
+			last.row_count++;
+			return;
+		}
+	}
+
+	range.open.push_back({ value, row, 1 });
+
+	if (range.open.size() >= Log_Index_Runs_Per_Block) {
+		std::sort(range.open.begin(), range.open.end(), [](const TRun& a, const TRun& b) {
+			return a.value < b.value || (a.value == b.value && a.first_row < b.first_row);
+		});
+
+		range.sealed.push_back(std::move(range.open));
+		range.open = std::vector<TRun>{};
+	}
+}
+
+const std::vector<size_t>& CLog_Index::Columns() const {
+	return mColumns;
+}
+
+bool CLog_Index::Is_Indexed(const size_t column) const {
+	std::shared_lock<std::shared_mutex> lck(mIndex_Mtx);
+
+	for (size_t i = 0; i < mColumns.size(); i++) {
+		if (mColumns[i] == column)
+			return !mDropped[i];
+	}
+
+	return false;
+}
+
+uint32_t CLog_Index::Indexed_Rows() const {
+	std::shared_lock<std::shared_mutex> lck(mIndex_Mtx);
+	return mIndexed_Rows;
+}
+
+uint32_t CLog_Index::Dropped_Count() const {
+	std::shared_lock<std::shared_mutex> lck(mIndex_Mtx);
+	return mDropped_Count;
+}
+
+std::vector<uint32_t> CLog_Index::Query(const size_t column, const QString& prefix, const uint32_t first_row, uint32_t* indexed_rows) const {
+	std::vector<uint32_t> result;
+
+	// the values are indexed case-folded
+	const QString folded = prefix.toCaseFolded();
+
+	std::shared_lock<std::shared_mutex> lck(mIndex_Mtx);
+
+	if (indexed_rows)
+		*indexed_rows = mIndexed_Rows;
+
+	if (prefix.isEmpty())
+		return result;
+
+	for (size_t i = 0; i < mColumns.size(); i++) {
+		if (mDropped[i] || (column != Any_Column && mColumns[i] != column))
+			continue;
+
+		if (mRanged[i]) {
+			const auto add_run = [&result, first_row](const TRun& run) {
+				for (uint32_t row = std::max(run.first_row, first_row); row < run.first_row + run.row_count; row++)
+					result.push_back(row);
+			};
+
+			// runs sharing the prefix form a contiguous range of a sorted block
+			for (const auto& block : mRanges[i].sealed) {
+				auto itr = std::lower_bound(block.begin(), block.end(), folded, [](const TRun& run, const QString& value) { return run.value < value; });
+				for (; itr != block.end() && itr->value.startsWith(folded); itr++)
+					add_run(*itr);
+			}
+
+			for (const auto& run : mRanges[i].open) {
+				if (run.value.startsWith(folded))
+					add_run(run);
+			}
+		}
+		else {
+			// values sharing the prefix form a contiguous range of the ordered map
+			for (auto itr = mValues[i].lower_bound(folded); itr != mValues[i].end() && itr->first.startsWith(folded); itr++)
+				result.insert(result.end(), std::lower_bound(itr->second.begin(), itr->second.end(), first_row), itr->second.end());
+		}
+	}
+
+	lck.unlock();
+
+	// a row may match through more values or columns
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+
+	return result;
+}
@@ -0,0 +1,132 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Inverted index over selected columns of log lines
+ * Every distinct value of an indexed column maps to the (ascending) list of rows holding it, so a query
+ * just merges a few posting lists instead of scanning the log; lines are indexed by a background thread
+ * A column with nearly unique values would make the index as large as the log itself, so such a column is dropped from
+ * the index once it proves so - except for range columns (e.g.; device time), which keep runs of equal values in sorted
+ * blocks instead of posting lists; values are case-folded, so the queries ignore case
+ */
+class CLog_Index {
+	public:
+		// query over all the indexed columns
+		static constexpr size_t Any_Column = static_cast<size_t>(-1);
+
+	protected:
+		using TPostings = std::vector<uint32_t>;
+
+		struct TBatch {
+			uint32_t first_row;
+			QStringList lines;
+		};
+
+		// consecutive rows holding the same value
+		struct TRun {
+			QString value;
+			uint32_t first_row;
+			uint32_t row_count;
+		};
+
+		// runs of a range column; a full block gets sorted by value, so that a query binary-searches every block
+		struct TRange_Index {
+			std::vector<std::vector<TRun>> sealed;
+			std::vector<TRun> open;
+		};
+
+		// index of the log column for every indexed column
+		const std::vector<size_t> mColumns;
+		// true for a column indexed by runs rather than by distinct values
+		std::vector<bool> mRanged;
+		std::vector<std::map<QString, TPostings>> mValues;
+		std::vector<TRange_Index> mRanges;
+		// columns dropped for their high cardinality
+		std::vector<bool> mDropped;
+		// rows below this one are indexed
+		uint32_t mIndexed_Rows = 0;
+		// grows whenever a column gets dropped, so that earlier query results may be told outdated
+		uint32_t mDropped_Count = 0;
+		mutable std::shared_mutex mIndex_Mtx;
+
+		std::deque<TBatch> mQueue;
+		std::mutex mQueue_Mtx;
+		std::condition_variable mQueue_Cv;
+		bool mStop = false;
+		std::thread mWorker;
+
+		// called from the worker thread whenever a batch got indexed
+		const std::function<void()> mOn_Indexed;
+
+		void Run_Worker();
+		void Index_Batch(const TBatch& batch);
+		static void Add_Run(TRange_Index& range, const QString& value, const uint32_t row);
+
+	public:
+		// range_columns is a subset of columns, indexed regardless of their cardinality
+		CLog_Index(std::vector<size_t> columns, const std::vector<size_t>& range_columns, std::function<void()> on_indexed);
+		~CLog_Index();
+
+		CLog_Index(const CLog_Index&) = delete;
+		CLog_Index& operator=(const CLog_Index&) = delete;
+
+		// queues lines for indexing; first_row is the row of the first line
+		void Append(const uint32_t first_row, const QStringList& lines);
+
+		const std::vector<size_t>& Columns() const;
+		// false for a column not indexed at all, or dropped from the index for having too many distinct values
+		bool Is_Indexed(const size_t column) const;
+		uint32_t Indexed_Rows() const;
+		uint32_t Dropped_Count() const;
+
+		// rows (ascending, from first_row on) with a value of given column (or any indexed column) starting with prefix, regardless of case;
+		// indexed_rows receives the count of rows indexed at the time of the query, so that the next query may continue from it
+		std::vector<uint32_t> Query(const size_t column, const QString& prefix, const uint32_t first_row = 0, uint32_t* indexed_rows = nullptr) const;
+};
@@ -44,11 +44,21 @@
 #include <QtWidgets/QScrollBar>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 #include <QtCore/QTimer>
 #include <QtCore/QEventLoop>
 #include <QtWidgets/QTableView>
 #include <QtWidgets/QHeaderView>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+#include <QtCore/QFile>
+#include <QtCore/QMetaObject>
+#include <QtGui/QTextCursor>
+
+#include <climits>
 
 #include "moc_log_tab_widget.cpp"
 
@@ -63,22 +73,31 @@ CLog_Subtab_Raw_Widget::CLog_Subtab_Raw_Widget(QWidget *parent)
 	mainLayout->addWidget(mLogContents);
 	setLayout(mainLayout);
 
-	connect(this, SIGNAL(On_Log_Message(QString)), this, SLOT(Slot_Log_Message(QString)), Qt::QueuedConnection);
+	Set_Retained_Lines(Log_Default_Retained_Lines);
 }
 
-void CLog_Subtab_Raw_Widget::Log_Message(const std::wstring &msg)
+void CLog_Subtab_Raw_Widget::Append_Lines(const QStringList &lines)
 {
-	emit On_Log_Message(StdWStringToQString(msg));
-}
+	if (lines.isEmpty())
+		return;
 
-void CLog_Subtab_Raw_Widget::Slot_Log_Message(QString msg)
-{
-	mLogContents->append(msg);
+	// follow the end of the log, unless the user scrolled away from it
+	QScrollBar* scrollBar = mLogContents->verticalScrollBar();
+	const bool at_end = scrollBar->value() == scrollBar->maximum();
+
+	// single insertion; line feeds become block separators
+	QTextCursor cursor(mLogContents->document());
+	cursor.movePosition(QTextCursor::End);
+	cursor.insertText((mLogContents->document()->isEmpty() ? QString() : QStringLiteral("\n")) + lines.join(QLatin1Char('\n')));
+
+	if (at_end)
+		scrollBar->setValue(scrollBar->maximum());
 }
 
 CAbstract_Simulation_Tab_Widget* CLog_Subtab_Raw_Widget::Clone()
 {
 	CLog_Subtab_Raw_Widget* cloned = new CLog_Subtab_Raw_Widget();
+	cloned->mLogContents->document()->setMaximumBlockCount(mLogContents->document()->maximumBlockCount());
 	cloned->Set_Contents(mLogContents->document()->toPlainText());
 
 	return cloned;
@@ -89,6 +108,12 @@ void CLog_Subtab_Raw_Widget::Set_Contents(const QString& contents)
 	mLogContents->document()->setPlainText(contents);
 }
 
+void CLog_Subtab_Raw_Widget::Set_Retained_Lines(const size_t lines_count)
+{
+	// the document drops the oldest blocks by itself
+	mLogContents->document()->setMaximumBlockCount(static_cast<int>(std::min(lines_count, static_cast<size_t>(INT_MAX))));
+}
+
 /* TABLE subtab widget */
 
 CLog_Subtab_Table_Widget::CLog_Subtab_Table_Widget(QWidget *parent)
@@ -98,24 +123,97 @@ CLog_Subtab_Table_Widget::CLog_Subtab_Table_Widget(QWidget *parent)
 
 	mTableView = new QTableView();
 	mModel = new CLog_Table_Model(this);
+	mFilter_Model = new CLog_Filter_Model(mModel, this);
 	mTableView->setModel(mModel);
-	mainLayout->addWidget(mTableView);
+
+	QHBoxLayout *filterLayout = new QHBoxLayout;
+	filterLayout->addWidget(new QLabel(tr("Search")));
+	mFilter_Column = new QComboBox();
+	mFilter_Column->addItem(tr("Any indexed column"), QVariant::fromValue(static_cast<qulonglong>(CLog_Index::Any_Column)));
+	for (const size_t column : mModel->Get_Index().Columns())
+		mFilter_Column->addItem(mModel->headerData(static_cast<int>(column), Qt::Horizontal, Qt::DisplayRole).toString(), QVariant::fromValue(static_cast<qulonglong>(column)));
+	filterLayout->addWidget(mFilter_Column);
+	mFilter_Text = new QLineEdit();
+	mFilter_Text->setPlaceholderText(tr("Value or its beginning"));
+	mFilter_Text->setClearButtonEnabled(true);
+	filterLayout->addWidget(mFilter_Text, 1);
+	mFilter_Status = new QLabel();
+	filterLayout->addWidget(mFilter_Status);
+
+	mainLayout->addLayout(filterLayout, 0, 0);
+	mainLayout->addWidget(mTableView, 1, 0);
 	
 	mTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
 
 	setLayout(mainLayout);
 
-	connect(this, SIGNAL(On_Log_Message(QString)), this, SLOT(Slot_Log_Message(QString)), Qt::QueuedConnection);
+	mFilter_Timer = new QTimer(this);
+	mFilter_Timer->setSingleShot(true);
+	mFilter_Timer->setInterval(200);
+
+	connect(mFilter_Text, SIGNAL(textChanged(const QString&)), this, SLOT(On_Filter_Changed()));
+	connect(mFilter_Column, SIGNAL(currentIndexChanged(int)), this, SLOT(On_Filter_Changed()));
+	connect(mFilter_Timer, SIGNAL(timeout()), this, SLOT(On_Apply_Filter()));
+	connect(mModel, SIGNAL(On_Index_Updated()), this, SLOT(On_Index_Updated()));
 }
 
-void CLog_Subtab_Table_Widget::Log_Message(const std::wstring &msg)
+void CLog_Subtab_Table_Widget::On_Filter_Changed()
 {
-	emit On_Log_Message(StdWStringToQString(msg));
+	mFilter_Timer->start();
 }
 
-void CLog_Subtab_Table_Widget::Slot_Log_Message(QString msg)
+void CLog_Subtab_Table_Widget::On_Apply_Filter()
 {
-	mModel->Log_Message(msg.toStdWString());
+	const QString prefix = mFilter_Text->text().trimmed();
+
+	if (prefix.isEmpty())
+	{
+		mTableView->setModel(mModel);
+	}
+	else
+	{
+		mFilter_Model->Set_Filter(static_cast<size_t>(mFilter_Column->currentData().toULongLong()), prefix);
+		if (mTableView->model() != mFilter_Model)
+			mTableView->setModel(mFilter_Model);
+	}
+
+	Update_Filter_Status();
+}
+
+void CLog_Subtab_Table_Widget::On_Index_Updated()
+{
+	// columns with too many distinct values get dropped from the index, so they cannot be searched anymore
+	const CLog_Index& index = mModel->Get_Index();
+	for (int i = mFilter_Column->count() - 1; i >= 0; i--)
+	{
+		const size_t column = static_cast<size_t>(mFilter_Column->itemData(i).toULongLong());
+		if (column != CLog_Index::Any_Column && !index.Is_Indexed(column))
+			mFilter_Column->removeItem(i);
+	}
+
+	if (mTableView->model() == mFilter_Model)
+		mFilter_Model->Refresh();
+
+	Update_Filter_Status();
+}
+
+void CLog_Subtab_Table_Widget::Update_Filter_Status()
+{
+	const size_t indexed = mModel->Get_Index().Indexed_Rows();
+	const size_t total = static_cast<size_t>(mModel->rowCount());
+
+	QString status;
+	if (mTableView->model() == mFilter_Model)
+		status = tr("%1 matching lines").arg(mFilter_Model->Match_Count());
+	if (indexed < total)
+		status += (status.isEmpty() ? QString() : QStringLiteral(", ")) + tr("indexing %1 of %2").arg(indexed).arg(total);
+
+	mFilter_Status->setText(status);
+}
+
+void CLog_Subtab_Table_Widget::Append_Lines(const QStringList &lines)
+{
+	mModel->Append_Lines(lines);
 	// scrolling to bottom is disabled for now
 	//mTableView->scrollToBottom();
 }
@@ -130,18 +228,22 @@ CAbstract_Simulation_Tab_Widget* CLog_Subtab_Table_Widget::Clone()
 
 void CLog_Subtab_Table_Widget::Append_From_Model(CLog_Table_Model* source)
 {
-	for (int i = 0; i < source->rowCount(); i++)
-	{
-		mModel->insertRows(i, 1, QModelIndex());
+	mModel->Append_From(*source);
+}
 
-		for (int j = 0; j < source->columnCount(); j++)
-		{
-			QModelIndex idx = mModel->index(i, j, QModelIndex());
-			mModel->setData(idx, source->data(idx), Qt::DisplayRole);
-		}
-	}
+void CLog_Subtab_Table_Widget::Set_Retained_Lines(const size_t lines_count)
+{
+	mModel->Set_Retained_Lines(lines_count);
+}
+
+bool CLog_Subtab_Table_Widget::Save_Log(QIODevice &target) const
+{
+	return mModel->Save(target);
 }
 
+// lines per chunk of the log table model; a full chunk is never reallocated again
+constexpr size_t Log_Lines_Per_Chunk = 4096;
+
 CLog_Table_Model::CLog_Table_Model(QObject *parent) noexcept : QAbstractTableModel(parent) {
 
 	std::wistringstream iss(dsLog_Header);
@@ -149,11 +251,37 @@ CLog_Table_Model::CLog_Table_Model(QObject *parent) noexcept : QAbstractTableMod
 	while (std::getline(iss, str, L';')) {
 		mHeaderTitles.push_back(str);
 	}
+
+	// the columns worth searching in; if the header is not recognized, everything gets indexed
+	std::vector<size_t> indexed_columns;
+	// time is nearly unique per line, so it is indexed by ranges rather than by distinct values
+	std::vector<size_t> range_columns;
+	for (size_t i = 0; i < mHeaderTitles.size(); i++)
+	{
+		const QString title = StdWStringToQString(mHeaderTitles[i]).toLower();
+		if (title.contains(QLatin1String("signal")) || title.contains(QLatin1String("segment")) || title.contains(QLatin1String("code")))
+			indexed_columns.push_back(i);
+		else if (title.contains(QLatin1String("time")))
+		{
+			indexed_columns.push_back(i);
+			range_columns.push_back(i);
+		}
+	}
+	if (indexed_columns.empty())
+	{
+		for (size_t i = 0; i < mHeaderTitles.size(); i++)
+			indexed_columns.push_back(i);
+	}
+
+	// the index outlives no model, so a notification queued to a model already destroyed is just dropped
+	mIndex = std::make_unique<CLog_Index>(std::move(indexed_columns), range_columns, [this]() {
+		QMetaObject::invokeMethod(this, [this]() { emit On_Index_Updated(); }, Qt::QueuedConnection);
+	});
 }
 
 int CLog_Table_Model::rowCount(const QModelIndex &idx) const
 {
-	return static_cast<int>(mLogRows.size());
+	return static_cast<int>(mLine_Count);
 }
 
 int CLog_Table_Model::columnCount(const QModelIndex &idx) const
@@ -168,9 +296,23 @@ QVariant CLog_Table_Model::data(const QModelIndex &index, int role) const
 	{
 		const size_t row = static_cast<size_t>(index.row());
 		const size_t col = static_cast<size_t>(index.column());
+		const size_t columns = mHeaderTitles.size();
+		const size_t spilled = mSpill.Line_Count();
+
+		if (row < spilled && col < columns)
+			return Line_Text(row).section(QLatin1Char(';'), static_cast<int>(col), static_cast<int>(col));
 
-		if (row < mLogRows.size() && col < mLogRows[row].size())
-			return mLogRows[row][col];
+		if (row < mLine_Count && col < columns)
+		{
+			const size_t local_row = row - spilled;
+			const TLog_Chunk& chunk = mChunks[local_row / Log_Lines_Per_Chunk];
+			const uint32_t* bounds = chunk.field_bounds.data() + (local_row % Log_Lines_Per_Chunk) * (columns + 1);
+
+			// the column ends one character before the next one starts (the separator); missing columns are empty
+			const int begin = static_cast<int>(bounds[col]);
+			const int length = static_cast<int>(bounds[col + 1]) - begin - 1;
+			return length > 0 ? chunk.text.mid(begin, length) : QString();
+		}
 	}
 
 	return QVariant();
@@ -191,49 +333,250 @@ QVariant CLog_Table_Model::headerData(int section, Qt::Orientation orientation,
 	return QVariant();
 }
 
-bool CLog_Table_Model::insertRows(int position, int rows, const QModelIndex &index)
+void CLog_Table_Model::Store_Line(const QString &line)
+{
+	if (mChunks.empty() || mLine_Count % Log_Lines_Per_Chunk == 0)
+	{
+		// the full chunk will not grow anymore
+		if (!mChunks.empty())
+			mChunks.back().text.squeeze();
+
+		mChunks.emplace_back();
+		mChunks.back().field_bounds.reserve(Log_Lines_Per_Chunk * (mHeaderTitles.size() + 1));
+	}
+
+	TLog_Chunk& chunk = mChunks.back();
+	const uint32_t line_begin = static_cast<uint32_t>(chunk.text.size());
+	chunk.text.append(line);
+	const uint32_t line_end = static_cast<uint32_t>(chunk.text.size());
+
+	// column N starts after N-th separator; text beyond the last column is kept, but never displayed
+	uint32_t pos = line_begin;
+	chunk.field_bounds.push_back(pos);
+	for (size_t col = 1; col <= mHeaderTitles.size(); col++)
+	{
+		if (pos <= line_end)
+		{
+			const int separator = chunk.text.indexOf(QLatin1Char(';'), static_cast<int>(pos));
+			pos = (separator >= 0 && static_cast<uint32_t>(separator) < line_end) ? static_cast<uint32_t>(separator) + 1 : line_end + 1;
+		}
+
+		chunk.field_bounds.push_back(pos);
+	}
+
+	mLine_Count++;
+}
+
+QString CLog_Table_Model::Line_Text(const size_t row) const
+{
+	const size_t spilled = mSpill.Line_Count();
+	if (row < spilled)
+		return mSpill.Line(row);
+
+	if (row >= mLine_Count)
+		return QString();
+
+	const size_t local_row = row - spilled;
+	const TLog_Chunk& chunk = mChunks[local_row / Log_Lines_Per_Chunk];
+	const size_t stride = mHeaderTitles.size() + 1;
+	const size_t line = local_row % Log_Lines_Per_Chunk;
+
+	// a line spans up to the start of the next one
+	const int begin = static_cast<int>(chunk.field_bounds[line * stride]);
+	const int end = (line + 1) * stride < chunk.field_bounds.size() ? static_cast<int>(chunk.field_bounds[(line + 1) * stride]) : static_cast<int>(chunk.text.size());
+	return chunk.text.mid(begin, end - begin);
+}
+
+void CLog_Table_Model::Spill_Chunks()
+{
+	const size_t stride = mHeaderTitles.size() + 1;
+
+	// the last chunk is the one being filled, so it always stays
+	while (mChunks.size() > 1 && mLine_Count - mSpill.Line_Count() - Log_Lines_Per_Chunk >= mRetained_Lines)
+	{
+		const TLog_Chunk& chunk = mChunks.front();
+		const size_t first_row = mSpill.Line_Count();
+
+		QStringList lines;
+		lines.reserve(static_cast<int>(chunk.field_bounds.size() / stride));
+		for (size_t i = 0; i < chunk.field_bounds.size() / stride; i++)
+			lines.append(Line_Text(first_row + i));
+
+		// disk full or not writable - keep the lines in memory rather than lose them
+		if (!mSpill.Append_Segment(lines))
+			break;
+
+		mChunks.pop_front();
+	}
+}
+
+void CLog_Table_Model::Append_Lines(const QStringList &lines)
 {
-	beginInsertRows(QModelIndex(), position, position + rows - 1);
+	if (lines.isEmpty())
+		return;
 
-	const size_t oldSize = mLogRows.size();
+	const int first = static_cast<int>(mLine_Count);
+	beginInsertRows(QModelIndex(), first, first + lines.size() - 1);
 
-	mLogRows.resize(static_cast<size_t>(position) + size_t(1));
-	// stretch vector inside to desired size
-	for (size_t i = oldSize; i < mLogRows.size(); i++)
-		mLogRows[i].resize(mHeaderTitles.size());
+	for (const auto& line : lines)
+		Store_Line(line);
 
 	endInsertRows();
 
-	return true;
+	mIndex->Append(static_cast<uint32_t>(first), lines);
+
+	Spill_Chunks();
+}
+
+void CLog_Table_Model::Index_Rows(const size_t first_row, const size_t end_row)
+{
+	for (size_t batch_begin = first_row; batch_begin < end_row; batch_begin += Log_Lines_Per_Chunk)
+	{
+		const size_t batch_end = std::min(end_row, batch_begin + Log_Lines_Per_Chunk);
+
+		QStringList lines;
+		lines.reserve(static_cast<int>(batch_end - batch_begin));
+		for (size_t row = batch_begin; row < batch_end; row++)
+			lines.append(Line_Text(row));
+
+		mIndex->Append(static_cast<uint32_t>(batch_begin), lines);
+	}
 }
 
-bool CLog_Table_Model::setData(const QModelIndex &index, const QVariant &value, int role)
+const CLog_Index& CLog_Table_Model::Get_Index() const
 {
-	if (!index.isValid())
+	return *mIndex;
+}
+
+void CLog_Table_Model::Append_From(const CLog_Table_Model &source)
+{
+	if (source.mLine_Count == 0)
+		return;
+
+	const int first = static_cast<int>(mLine_Count);
+	beginInsertRows(QModelIndex(), first, first + static_cast<int>(source.mLine_Count) - 1);
+
+	mRetained_Lines = source.mRetained_Lines;
+	const size_t first_row = mLine_Count;
+
+	if (mLine_Count == 0 && source.mSpill.Line_Count() == 0 && source.mHeaderTitles.size() == mHeaderTitles.size())
+	{
+		// the usual case of a cloned tab - the chunks can be shared as they are (QString is implicitly shared)
+		mChunks = source.mChunks;
+		mLine_Count = source.mLine_Count;
+	}
+	else
+	{
+		for (size_t row = 0; row < source.mLine_Count; row++)
+		{
+			Store_Line(source.Line_Text(row));
+
+			// do not let a copy of a huge log pile up in memory
+			if (mLine_Count % Log_Lines_Per_Chunk == 0)
+				Spill_Chunks();
+		}
+	}
+
+	endInsertRows();
+
+	Index_Rows(first_row, mLine_Count);
+
+	Spill_Chunks();
+}
+
+void CLog_Table_Model::Set_Retained_Lines(const size_t lines_count)
+{
+	mRetained_Lines = lines_count;
+	Spill_Chunks();
+}
+
+bool CLog_Table_Model::Save(QIODevice &target) const
+{
+	// spilled lines are stored as the log file is, so they are just copied
+	if (!mSpill.Write_To(target))
 		return false;
 
+	for (size_t row = mSpill.Line_Count(); row < mLine_Count; row++)
+	{
+		const QByteArray line = Line_Text(row).toUtf8() + '\n';
+		if (target.write(line) != line.size())
+			return false;
+	}
+
+	return true;
+}
+
+CLog_Filter_Model::CLog_Filter_Model(CLog_Table_Model* source, QObject *parent) : QAbstractTableModel(parent), mSource(source)
+{
+	//
+}
+
+int CLog_Filter_Model::rowCount(const QModelIndex &idx) const
+{
+	return static_cast<int>(mRows.size());
+}
+
+int CLog_Filter_Model::columnCount(const QModelIndex &idx) const
+{
+	return mSource->columnCount();
+}
+
+QVariant CLog_Filter_Model::data(const QModelIndex &index, int role) const
+{
 	const size_t row = static_cast<size_t>(index.row());
-	const size_t col = static_cast<size_t>(index.column());
+	if (row >= mRows.size())
+		return QVariant();
 
-	mLogRows[row][col] = value.toString();
-	emit(dataChanged(index, index));
+	return mSource->data(mSource->index(static_cast<int>(mRows[row]), index.column()), role);
+}
 
-	return true;
+QVariant CLog_Filter_Model::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	// rows are numbered as in the complete log
+	if (orientation == Qt::Vertical && role == Qt::DisplayRole)
+	{
+		if (section >= 0 && static_cast<size_t>(section) < mRows.size())
+			return static_cast<qulonglong>(mRows[section]) + 1;
+		return QVariant();
+	}
+
+	return mSource->headerData(section, orientation, role);
 }
 
-void CLog_Table_Model::Log_Message(const std::wstring &msg)
+void CLog_Filter_Model::Set_Filter(const size_t column, const QString &prefix)
 {
-	int row = static_cast<int>(mLogRows.size());
+	beginResetModel();
+	mColumn = column;
+	mPrefix = prefix;
+	mQueried_Dropped = mSource->Get_Index().Dropped_Count();
+	mRows = mSource->Get_Index().Query(mColumn, mPrefix, 0, &mQueried_Rows);
+	endResetModel();
+}
 
-	insertRows(row, 1, QModelIndex());
+void CLog_Filter_Model::Refresh()
+{
+	const CLog_Index& index = mSource->Get_Index();
 
-	int i = 0;
-	std::wistringstream iss(msg);
-	std::wstring str;
-	while (std::getline(iss, str, L';')) {
-		QModelIndex idx = index(row, i++, QModelIndex());
-		setData(idx, StdWStringToQString(str), Qt::EditRole);
+	// a dropped column takes its matches away, so the whole query has to run again
+	if (index.Dropped_Count() != mQueried_Dropped)
+	{
+		Set_Filter(mColumn, mPrefix);
+		return;
 	}
+
+	// lines are indexed in the order they came, so new matches can only follow the known ones
+	std::vector<uint32_t> rows = index.Query(mColumn, mPrefix, mQueried_Rows, &mQueried_Rows);
+	if (rows.empty())
+		return;
+
+	beginInsertRows(QModelIndex(), static_cast<int>(mRows.size()), static_cast<int>(mRows.size() + rows.size()) - 1);
+	mRows.insert(mRows.end(), rows.begin(), rows.end());
+	endInsertRows();
+}
+
+size_t CLog_Filter_Model::Match_Count() const
+{
+	return mRows.size();
 }
 
 /* PARENT widget */
@@ -267,15 +610,55 @@ void CLog_Tab_Widget::Init_Layout()
 	QGridLayout *mainLayout = new QGridLayout;
 
 	mTabWidget = new QTabWidget();
-	mainLayout->addWidget(mTabWidget);
+	mainLayout->addWidget(mTabWidget, 0, 0);
+
+	QHBoxLayout *bottomLayout = new QHBoxLayout;
+	bottomLayout->addWidget(new QLabel(tr("Lines kept in memory")));
+	mRetained_Lines = new QSpinBox();
+	mRetained_Lines->setRange(1000, 100000000);
+	mRetained_Lines->setSingleStep(10000);
+	mRetained_Lines->setValue(static_cast<int>(Log_Default_Retained_Lines));
+	mRetained_Lines->setToolTip(tr("Older lines are moved to a temporary file; the table view reads them back when scrolled to"));
+	bottomLayout->addWidget(mRetained_Lines);
+	bottomLayout->addStretch();
+	QPushButton *saveBtn = new QPushButton(tr("Save log"));
+	bottomLayout->addWidget(saveBtn);
+	mainLayout->addLayout(bottomLayout, 1, 0);
 
 	setLayout(mainLayout);
+
+	connect(mRetained_Lines, SIGNAL(valueChanged(int)), this, SLOT(On_Retained_Lines_Change(int)));
+	connect(saveBtn, SIGNAL(clicked()), this, SLOT(On_Save_Log()));
+	connect(this, SIGNAL(On_Log_Messages(QStringList)), this, SLOT(Slot_Log_Messages(QStringList)), Qt::QueuedConnection);
+}
+
+void CLog_Tab_Widget::On_Retained_Lines_Change(int lines_count)
+{
+	mRawLogWidget->Set_Retained_Lines(static_cast<size_t>(lines_count));
+	mTableLogWidget->Set_Retained_Lines(static_cast<size_t>(lines_count));
+}
+
+void CLog_Tab_Widget::On_Save_Log()
+{
+	auto path = QFileDialog::getSaveFileName(this, tr("Save log"), "log.txt", tr("Text files (*.txt);;All files (*)"));
+	if (path.length() != 0)
+	{
+		QFile file(path);
+		if (!file.open(QIODevice::WriteOnly) || !mTableLogWidget->Save_Log(file))
+			QMessageBox::warning(this, tr(dsWarning), tr("Cannot save the log to %1").arg(path));
+	}
+}
+
+void CLog_Tab_Widget::Log_Messages(const QStringList &lines)
+{
+	if (!lines.isEmpty())
+		emit On_Log_Messages(lines);
 }
 
-void CLog_Tab_Widget::Log_Message(const std::wstring &msg)
+void CLog_Tab_Widget::Slot_Log_Messages(QStringList lines)
 {
-	mRawLogWidget->Log_Message(msg);
-	mTableLogWidget->Log_Message(msg);
+	mRawLogWidget->Append_Lines(lines);
+	mTableLogWidget->Append_Lines(lines);
 }
 
 CAbstract_Simulation_Tab_Widget* CLog_Tab_Widget::Clone()
@@ -283,6 +666,7 @@ CAbstract_Simulation_Tab_Widget* CLog_Tab_Widget::Clone()
 	CLog_Tab_Widget* cloned = new CLog_Tab_Widget(
 		dynamic_cast<CLog_Subtab_Raw_Widget*>(mRawLogWidget->Clone()),
 		dynamic_cast<CLog_Subtab_Table_Widget*>(mTableLogWidget->Clone()));
+	cloned->mRetained_Lines->setValue(mRetained_Lines->value());
 
 	return cloned;
 }
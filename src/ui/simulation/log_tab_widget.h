@@ -40,10 +40,25 @@
 #include <QtWidgets/QTextEdit>
 #include <QtWidgets/QTableView>
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QStringList>
+#include <QtWidgets/QSpinBox>
+#include <QtWidgets/QComboBox>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QLabel>
+#include <QtCore/QTimer>
+
+#include <deque>
+#include <memory>
+#include <vector>
 
 #include "abstract_simulation_tab.h"
+#include "../../utils/log_spill_file.h"
+#include "log_index.h"
 #include <scgms/rtl/referencedImpl.h>
 
+// default count of log lines kept in memory; older lines are spilled to disk
+constexpr size_t Log_Default_Retained_Lines = 100000;
+
 /*
 * Log display subtab widget - raw view
 */
@@ -51,12 +66,6 @@ class CLog_Subtab_Raw_Widget : public CAbstract_Simulation_Tab_Widget
 {
 		Q_OBJECT
 
-	signals:
-		void On_Log_Message(QString msg);
-
-	protected slots:
-		void Slot_Log_Message(QString msg);
-
 	protected:
 		// log contents display - text edit
 		QTextEdit * mLogContents;
@@ -66,34 +75,102 @@ class CLog_Subtab_Raw_Widget : public CAbstract_Simulation_Tab_Widget
 
 		virtual CAbstract_Simulation_Tab_Widget* Clone() override;
 
-		// when a new log message is available
-		void Log_Message(const std::wstring &msg);
+		// appends a batch of log lines; GUI thread only
+		void Append_Lines(const QStringList &lines);
 		// sets contents
 		void Set_Contents(const QString& contents);
+		// raw view shows just the last lines_count lines; the complete log is kept by the table view
+		void Set_Retained_Lines(const size_t lines_count);
 };
 
 
 /*
  * QTableView model for log lines
+ * Append-only; lines are stored in chunks, each holding the raw text of its lines in a single buffer
+ * along with offsets of the columns, so that cells are split out only when the view asks for them
+ * Only the most recent chunks are kept in memory, older ones are spilled to disk and paged back in when displayed
  */
 class CLog_Table_Model : public QAbstractTableModel
 {
 		Q_OBJECT
 	protected:
+		struct TLog_Chunk {
+			// raw text of all the lines of the chunk, one after another
+			QString text;
+			// for every line, (column count + 1) positions in text: starts of the columns and one past the end of the last one
+			std::vector<uint32_t> field_bounds;
+		};
+
 		std::vector<std::wstring> mHeaderTitles;
-		std::vector<std::vector<QString>> mLogRows;
+		// chunks kept in memory, following the spilled lines
+		std::deque<TLog_Chunk> mChunks;
+		size_t mLine_Count = 0;
+
+		// lines that no longer fit into the retained window
+		CLog_Spill_File mSpill;
+		size_t mRetained_Lines = Log_Default_Retained_Lines;
+
+		// stores the line without notifying views
+		void Store_Line(const QString &line);
+		// moves the oldest chunks out of memory, as long as the rest still covers the retained window
+		void Spill_Chunks();
+		QString Line_Text(const size_t row) const;
+
+		// search index over the signal, segment, event code and time columns
+		std::unique_ptr<CLog_Index> mIndex;
+		void Index_Rows(const size_t first_row, const size_t end_row);
+
+	signals:
+		// the index caught up with another batch of lines
+		void On_Index_Updated();
 
 	public:
 		explicit CLog_Table_Model(QObject *parent = 0) noexcept;
 		int rowCount(const QModelIndex &parent = QModelIndex()) const;
 		int columnCount(const QModelIndex &parent = QModelIndex()) const;
 		QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
-		bool setData(const QModelIndex &index, const QVariant &value, int role);
 		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
-		bool insertRows(int position, int rows, const QModelIndex &index);
 
-		// appends parsed log line to table view
-		void Log_Message(const std::wstring &msg);
+		// appends parsed log lines with a single row insertion
+		void Append_Lines(const QStringList &lines);
+		// appends all lines of another model
+		void Append_From(const CLog_Table_Model &source);
+
+		void Set_Retained_Lines(const size_t lines_count);
+		// writes the complete log, one line per row
+		bool Save(QIODevice &target) const;
+
+		const CLog_Index& Get_Index() const;
+};
+
+/*
+ * Rows of the log table model matching a search in its index
+ * The matching rows are kept as a plain list, so filtering never walks the whole log
+ */
+class CLog_Filter_Model : public QAbstractTableModel
+{
+		Q_OBJECT
+	protected:
+		CLog_Table_Model* mSource;
+		size_t mColumn = CLog_Index::Any_Column;
+		QString mPrefix;
+		std::vector<uint32_t> mRows;
+		// rows indexed at the time of the last query, and columns dropped by then
+		uint32_t mQueried_Rows = 0;
+		uint32_t mQueried_Dropped = 0;
+
+	public:
+		CLog_Filter_Model(CLog_Table_Model* source, QObject *parent = 0);
+		int rowCount(const QModelIndex &parent = QModelIndex()) const;
+		int columnCount(const QModelIndex &parent = QModelIndex()) const;
+		QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+		// runs a new query; column is a log column, or CLog_Index::Any_Column
+		void Set_Filter(const size_t column, const QString &prefix);
+		// picks up matches among the lines indexed since the last query
+		void Refresh();
+		size_t Match_Count() const;
 };
 
 /*
@@ -103,27 +180,39 @@ class CLog_Subtab_Table_Widget : public CAbstract_Simulation_Tab_Widget
 {
 		Q_OBJECT
 
-	signals:
-		void On_Log_Message(QString msg);
-
-	protected slots:
-		void Slot_Log_Message(QString msg);
-
 	protected:
 		// table view for log messages
 		QTableView* mTableView;
 		// table model for log messages
 		CLog_Table_Model* mModel;
+		// model of the rows matching the filter bar, shown instead of mModel when a filter is set
+		CLog_Filter_Model* mFilter_Model;
+
+		QComboBox* mFilter_Column;
+		QLineEdit* mFilter_Text;
+		QLabel* mFilter_Status;
+		// delays the query until the user stops typing
+		QTimer* mFilter_Timer;
+
+		void Update_Filter_Status();
+
+	protected slots:
+		void On_Filter_Changed();
+		void On_Apply_Filter();
+		void On_Index_Updated();
 
 	public:
 		explicit CLog_Subtab_Table_Widget(QWidget *parent = 0);
 
 		virtual CAbstract_Simulation_Tab_Widget* Clone() override;
 
-		// when a new log message is available
-		void Log_Message(const std::wstring &msg);
+		// appends a batch of log lines; GUI thread only
+		void Append_Lines(const QStringList &lines);
 
 		void Append_From_Model(CLog_Table_Model* source);
+
+		void Set_Retained_Lines(const size_t lines_count);
+		bool Save_Log(QIODevice &target) const;
 };
 
 /*
@@ -137,10 +226,19 @@ class CLog_Tab_Widget : public CAbstract_Simulation_Tab_Widget
 		QTabWidget *mTabWidget;
 		CLog_Subtab_Raw_Widget *mRawLogWidget, *mConfig_Errors;
 		CLog_Subtab_Table_Widget *mTableLogWidget;
+		QSpinBox *mRetained_Lines;
 
 	protected:
 		void Init_Layout();
 
+	signals:
+		void On_Log_Messages(QStringList lines);
+
+	protected slots:
+		void Slot_Log_Messages(QStringList lines);
+		void On_Save_Log();
+		void On_Retained_Lines_Change(int lines_count);
+
 	public:
 		explicit CLog_Tab_Widget(QWidget *parent = 0);
 		// clone constructor
@@ -148,7 +246,7 @@ class CLog_Tab_Widget : public CAbstract_Simulation_Tab_Widget
 
 		virtual CAbstract_Simulation_Tab_Widget* Clone() override;
 
-		// when a new log message is available
-		void Log_Message(const std::wstring &msg);
+		// when new log messages are available; may be called from any thread, the whole batch is posted to GUI thread at once
+		void Log_Messages(const QStringList &lines);
 		void Log_Config_Errors(refcnt::Swstr_list errors);
 };
@@ -0,0 +1,399 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "svg_tile_item.h"
+
+#include "../../utils/thread_pool.h"
+
+#include <QtGui/QPainter>
+#include <QtSvg/QSvgRenderer>
+#include <QtWidgets/QStyleOptionGraphicsItem>
+#include <QtWidgets/QGraphicsScene>
+#include <QtWidgets/QGraphicsView>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QMetaObject>
+#include <QtCore/QRegularExpression>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+// edge of a square tile in [px]
+constexpr int Tile_Size = 512;
+// zoom level limits; scale of a level is 2^level
+constexpr int Min_Level = -4;
+constexpr int Max_Level = 5;
+// how many coarser levels are searched for a fallback of a tile not rendered yet
+constexpr int Fallback_Levels = 3;
+// memory taken by a single tile
+constexpr size_t Tile_Bytes = static_cast<size_t>(Tile_Size) * Tile_Size * 4;
+// memory for the tiles of all the items together
+constexpr size_t Tile_Memory_Budget = 128 * 1024 * 1024;
+// a render job parses the whole document, so it is worth to give it at least this many tiles
+constexpr size_t Min_Tiles_Per_Job = 4;
+
+namespace {
+	// dedicated pool, so that rasterization never competes with other background work for the same workers
+	CThread_Pool& Render_Pool() {
+		static CThread_Pool pool;
+		return pool;
+	}
+
+	// tile memory of all the items, checked against Tile_Memory_Budget
+	std::atomic<size_t> Total_Tile_Bytes{ 0 };
+
+	// living items, to split the budget among them once it is exceeded; GUI thread only
+	std::vector<CSvg_Tile_Item*>& Live_Items() {
+		static std::vector<CSvg_Tile_Item*> items;
+		return items;
+	}
+
+	// caller holds the store lock
+	void Account_Tile(CSvg_Tile_Item::TTile_Store& store, const size_t added, const size_t removed) {
+		store.bytes = store.bytes + added - removed;
+		Total_Tile_Bytes += added;
+		Total_Tile_Bytes -= removed;
+	}
+
+	// reads the document size from the root element without parsing the whole document
+	QSizeF Parse_Document_Size(const QByteArray& svg) {
+		auto parse_length = [](QString str) -> qreal {
+			str = str.trimmed();
+			if (str.isEmpty() || str.endsWith('%'))
+				return 0.0;
+			if (str.endsWith("px"))
+				str.chop(2);
+
+			bool ok = false;
+			const qreal value = str.toDouble(&ok);
+			return ok ? value : 0.0;
+		};
+
+		QXmlStreamReader reader(svg);
+		while (!reader.atEnd()) {
+			if (reader.readNext() != QXmlStreamReader::StartElement)
+				continue;
+
+			const auto attributes = reader.attributes();
+			const qreal width = parse_length(attributes.value("width").toString());
+			const qreal height = parse_length(attributes.value("height").toString());
+			if (width > 0.0 && height > 0.0)
+				return QSizeF{ width, height };
+
+			// same fallback as QSvgRenderer::defaultSize uses
+			const auto view_box = attributes.value("viewBox").toString().split(QRegularExpression("[\\s,]+"), Qt::SkipEmptyParts);
+			if (view_box.size() == 4)
+				return QSizeF{ view_box[2].toDouble(), view_box[3].toDouble() };
+
+			break;
+		}
+
+		return QSizeF{};
+	}
+
+	void Render_Tiles(std::shared_ptr<CSvg_Tile_Item::TTile_Store> store, CSvg_Tile_Item* item, const QByteArray document, const QSizeF document_size,
+		const uint64_t generation, const std::vector<CSvg_Tile_Item::TTile_Key> keys) {
+
+		auto release_pending = [&store, &keys, generation]() {
+			for (const auto& key : keys) {
+				auto itr = store->pending.find(key);
+				if (itr != store->pending.end() && itr->second == generation)
+					store->pending.erase(itr);
+			}
+		};
+
+		{
+			std::unique_lock<std::mutex> lck(store->mtx);
+			if (!store->alive || store->generation != generation) {
+				release_pending();
+				return;
+			}
+		}
+
+		QSvgRenderer renderer(document);
+
+		for (const auto& key : keys) {
+			if (!renderer.isValid())
+				break;
+
+			{
+				// a newer document makes the rest of this job pointless
+				std::unique_lock<std::mutex> lck(store->mtx);
+				if (!store->alive || store->generation != generation)
+					break;
+			}
+
+			const qreal scale = std::ldexp(1.0, key.level);
+
+			QImage image{ Tile_Size, Tile_Size, QImage::Format_ARGB32_Premultiplied };
+			image.fill(Qt::transparent);
+			{
+				QPainter painter(&image);
+				painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+				painter.scale(scale, scale);
+				painter.translate(-key.x * Tile_Size / scale, -key.y * Tile_Size / scale);
+				renderer.render(&painter, QRectF{ QPointF{ 0, 0 }, document_size });
+			}
+
+			std::unique_lock<std::mutex> lck(store->mtx);
+			if (!store->alive)
+				return;
+
+			if (store->generation == generation) {
+				auto& tile = store->tiles[key];
+				Account_Tile(*store, Tile_Bytes, tile.image.isNull() ? 0 : Tile_Bytes);
+				tile = { std::move(image), generation };
+				store->pending.erase(key);
+
+				// holding the lock guarantees the item is not being destroyed right now
+				QMetaObject::invokeMethod(item, [item]() { item->update(); }, Qt::QueuedConnection);
+			}
+		}
+
+		std::unique_lock<std::mutex> lck(store->mtx);
+		release_pending();
+	}
+}
+
+CSvg_Tile_Item::CSvg_Tile_Item(QGraphicsItem* parent) : QGraphicsObject(parent), mStore(std::make_shared<TTile_Store>()) {
+	// exposedRect is needed to paint just the visible tiles
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+	Live_Items().push_back(this);
+}
+
+CSvg_Tile_Item::~CSvg_Tile_Item() {
+	auto& items = Live_Items();
+	items.erase(std::remove(items.begin(), items.end(), this), items.end());
+
+	std::unique_lock<std::mutex> lck(mStore->mtx);
+	mStore->alive = false;
+	mStore->tiles.clear();
+	Account_Tile(*mStore, 0, mStore->bytes);
+}
+
+int CSvg_Tile_Item::Level_For_Scale(const qreal scale) {
+	if (scale <= 0.0)
+		return 0;
+
+	// round up, so the tile is always at least as sharp as the screen
+	const int level = static_cast<int>(std::ceil(std::log2(scale) - 1e-6));
+	return std::clamp(level, Min_Level, Max_Level);
+}
+
+QRectF CSvg_Tile_Item::Tile_Rect(const TTile_Key& key) {
+	const qreal extent = Tile_Size / std::ldexp(1.0, key.level);
+	return QRectF{ key.x * extent, key.y * extent, extent, extent };
+}
+
+void CSvg_Tile_Item::Set_Document(const QByteArray& svg) {
+	const QSizeF size = Parse_Document_Size(svg);
+	if (size != mDocument_Size) {
+		prepareGeometryChange();
+		mDocument_Size = size;
+	}
+
+	{
+		std::unique_lock<std::mutex> lck(mStore->mtx);
+		mStore->document = svg;
+		mStore->generation++;
+	}
+
+	update();
+}
+
+QRectF CSvg_Tile_Item::boundingRect() const {
+	return QRectF{ QPointF{ 0, 0 }, mDocument_Size };
+}
+
+void CSvg_Tile_Item::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) {
+	const QRectF exposed = option->exposedRect.intersected(boundingRect());
+	if (exposed.isEmpty())
+		return;
+
+	const int level = Level_For_Scale(option->levelOfDetailFromTransform(painter->worldTransform()));
+	mLast_Level = level;
+	mLast_Exposed = exposed;
+
+	painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+	const qreal extent = Tile_Size / std::ldexp(1.0, level);
+	const int x_first = static_cast<int>(std::floor(exposed.left() / extent));
+	const int x_last = static_cast<int>(std::ceil(exposed.right() / extent)) - 1;
+	const int y_first = static_cast<int>(std::floor(exposed.top() / extent));
+	const int y_last = static_cast<int>(std::ceil(exposed.bottom() / extent)) - 1;
+
+	std::vector<TTile_Key> missing;
+
+	{
+		std::unique_lock<std::mutex> lck(mStore->mtx);
+
+		for (int y = y_first; y <= y_last; y++) {
+			for (int x = x_first; x <= x_last; x++) {
+				const TTile_Key key{ level, x, y };
+				auto tile = mStore->tiles.find(key);
+
+				if (tile != mStore->tiles.end()) {
+					// even a tile of an older document is better than nothing until the new one is ready
+					painter->drawImage(Tile_Rect(key), tile->second.image);
+				}
+				else {
+					// cut the corresponding part out of a coarser tile
+					for (int coarser = level - 1; coarser >= std::max(level - Fallback_Levels, Min_Level); coarser--) {
+						const int factor = 1 << (level - coarser);
+						auto parent = mStore->tiles.find(TTile_Key{ coarser, x / factor, y / factor });
+						if (parent != mStore->tiles.end()) {
+							const qreal sub = static_cast<qreal>(Tile_Size) / factor;
+							painter->drawImage(Tile_Rect(key), parent->second.image, QRectF{ (x % factor) * sub, (y % factor) * sub, sub, sub });
+							break;
+						}
+					}
+				}
+
+				if (tile == mStore->tiles.end() || tile->second.generation != mStore->generation) {
+					auto pending = mStore->pending.find(key);
+					if (pending == mStore->pending.end() || pending->second != mStore->generation)
+						missing.push_back(key);
+				}
+			}
+		}
+	}
+
+	if (!missing.empty())
+		Request_Tiles(missing);
+}
+
+void CSvg_Tile_Item::Request_Tiles(const std::vector<TTile_Key>& keys) {
+	QByteArray document;
+	uint64_t generation;
+
+	{
+		std::unique_lock<std::mutex> lck(mStore->mtx);
+		if (mStore->document.isEmpty())
+			return;
+
+		document = mStore->document;
+		generation = mStore->generation;
+		for (const auto& key : keys)
+			mStore->pending[key] = generation;
+	}
+
+	Evict_Tiles();
+
+	auto& pool = Render_Pool();
+	const size_t job_count = std::max(static_cast<size_t>(1), std::min(pool.Thread_Count(), keys.size() / Min_Tiles_Per_Job));
+	const size_t per_job = (keys.size() + job_count - 1) / job_count;
+
+	for (size_t i = 0; i < keys.size(); i += per_job) {
+		std::vector<TTile_Key> chunk{ keys.begin() + i, keys.begin() + std::min(keys.size(), i + per_job) };
+		pool.Submit([store = mStore, item = this, document, size = mDocument_Size, generation, chunk = std::move(chunk)]() {
+			Render_Tiles(store, item, document, size, generation, chunk);
+		});
+	}
+}
+
+bool CSvg_Tile_Item::Is_Shown() const {
+	// a view in a hidden tab is not visible
+	if (!isVisible() || !scene())
+		return false;
+
+	const auto views = scene()->views();
+	return std::any_of(views.begin(), views.end(), [](const QGraphicsView* view) { return view->isVisible(); });
+}
+
+bool CSvg_Tile_Item::Is_Protected(const TTile_Key& key) const {
+	return key.level == mLast_Level && Tile_Rect(key).intersects(mLast_Exposed);
+}
+
+size_t CSvg_Tile_Item::Protected_Bytes() {
+	std::unique_lock<std::mutex> lck(mStore->mtx);
+
+	size_t bytes = 0;
+	for (const auto& tile : mStore->tiles) {
+		if (Is_Protected(tile.first))
+			bytes += Tile_Bytes;
+	}
+
+	return bytes;
+}
+
+void CSvg_Tile_Item::Trim_Tiles(const size_t share) {
+	std::unique_lock<std::mutex> lck(mStore->mtx);
+	if (mStore->bytes <= share)
+		return;
+
+	std::vector<std::map<TTile_Key, TTile>::iterator> candidates;
+	for (auto itr = mStore->tiles.begin(); itr != mStore->tiles.end(); itr++) {
+		// evicting a tile on screen would just make paint request it again, over and over
+		if (!Is_Protected(itr->first))
+			candidates.push_back(itr);
+	}
+
+	// stale tiles and tiles of levels far from the current zoom go first
+	std::sort(candidates.begin(), candidates.end(), [this](const auto& a, const auto& b) {
+		const bool a_stale = a->second.generation != mStore->generation;
+		const bool b_stale = b->second.generation != mStore->generation;
+		if (a_stale != b_stale)
+			return a_stale;
+		return std::abs(a->first.level - mLast_Level) > std::abs(b->first.level - mLast_Level);
+	});
+
+	for (size_t i = 0; i < candidates.size() && mStore->bytes > share; i++) {
+		Account_Tile(*mStore, 0, Tile_Bytes);
+		mStore->tiles.erase(candidates[i]);
+	}
+}
+
+void CSvg_Tile_Item::Evict_Tiles() {
+	if (Total_Tile_Bytes <= Tile_Memory_Budget)
+		return;
+
+	// tiles of items nobody looks at go first, all of them
+	std::vector<CSvg_Tile_Item*> shown;
+	for (CSvg_Tile_Item* item : Live_Items()) {
+		if (item->Is_Shown())
+			shown.push_back(item);
+		else if (Total_Tile_Bytes > Tile_Memory_Budget)
+			item->Trim_Tiles(0);
+	}
+
+	if (Total_Tile_Bytes <= Tile_Memory_Budget || shown.empty())
+		return;
+
+	// then every shown item is trimmed to its fair share, but never below the tiles covering its viewport
+	const size_t share = Tile_Memory_Budget / shown.size();
+	for (CSvg_Tile_Item* item : shown)
+		item->Trim_Tiles(std::max(share, item->Protected_Bytes()));
+}
@@ -0,0 +1,115 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <QtWidgets/QGraphicsObject>
+#include <QtCore/QByteArray>
+#include <QtGui/QImage>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/*
+ * Graphics item displaying an SVG document from a pyramid of raster tiles
+ * Tiles are rasterized by background workers at the zoom level the view currently uses; paint only blits
+ * ready tiles (falling back to scaled tiles of coarser levels), so zooming and panning never wait for the vector renderer
+ * All the items share a single memory budget for their tiles, so the memory does not grow with the number of tabs
+ */
+class CSvg_Tile_Item : public QGraphicsObject {
+	public:
+		// tile key - zoom level (scale = 2^level) and tile coordinates within that level
+		struct TTile_Key {
+			int level;
+			int x, y;
+
+			bool operator<(const TTile_Key& other) const {
+				return std::tie(level, x, y) < std::tie(other.level, other.x, other.y);
+			}
+		};
+
+		struct TTile {
+			QImage image;
+			// generation of the document the tile was rendered from
+			uint64_t generation = 0;
+		};
+
+		// state shared with render workers; outlives the item when a worker still holds it
+		struct TTile_Store {
+			std::mutex mtx;
+			bool alive = true;
+			uint64_t generation = 0;
+			QByteArray document;
+			std::map<TTile_Key, TTile> tiles;
+			// memory taken by the tiles, also accounted in the budget shared by all the items
+			size_t bytes = 0;
+			// tiles requested from workers, with generation they were requested for
+			std::map<TTile_Key, uint64_t> pending;
+		};
+
+	protected:
+		std::shared_ptr<TTile_Store> mStore;
+		QSizeF mDocument_Size;
+		// level and area most recently painted; the tiles showing that area are never evicted
+		int mLast_Level = 0;
+		QRectF mLast_Exposed;
+
+		static int Level_For_Scale(const qreal scale);
+		static QRectF Tile_Rect(const TTile_Key& key);
+
+		void Request_Tiles(const std::vector<TTile_Key>& keys);
+		// GUI thread only
+		bool Is_Shown() const;
+		bool Is_Protected(const TTile_Key& key) const;
+		size_t Protected_Bytes();
+		// evicts tiles not protected, until the item takes no more than given memory
+		void Trim_Tiles(const size_t share);
+		// brings all the items back within the shared budget; hidden items are drained first
+		static void Evict_Tiles();
+
+	public:
+		explicit CSvg_Tile_Item(QGraphicsItem* parent = nullptr);
+		virtual ~CSvg_Tile_Item();
+
+		// replaces the displayed document; tiles of the previous one are shown until the new ones are ready
+		void Set_Document(const QByteArray& svg);
+
+		QRectF boundingRect() const override;
+		void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+};
@@ -55,6 +55,7 @@
 
 #include <QtCore/QTimer>
 #include <QtCore/QEventLoop>
+#include <QtCore/QPointer>
 
 #include "simulation/abstract_simulation_tab.h"
 
@@ -68,6 +69,18 @@ constexpr bool Is_Visibility_Panel_Enabled = true;
 
 std::atomic<CSimulation_Window*> CSimulation_Window::mInstance = nullptr;
 
+// capacity of terminal filter event summary ring
+constexpr size_t Terminal_Events_Capacity = 4096;
+// interval in [ms] of draining terminal filter event summaries in GUI thread
+constexpr int Terminal_Events_Drain_Interval = 100;
+// minimum interval in [ms] between two repaints of solver progress
+constexpr int Solver_Progress_Frame_Interval = 16;
+
+CGUI_Terminal_Filter::CGUI_Terminal_Filter(CSPSC_Ring<TTerminal_Event_Summary>& events, CGUI_Filter_Subchain& gui_subchain)
+	: mEvents(events), mGUI_Subchain(gui_subchain) {
+	//
+}
+
 HRESULT IfaceCalling CGUI_Terminal_Filter::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description)
 {
 	return S_OK;
@@ -85,21 +98,50 @@ HRESULT IfaceCalling CGUI_Terminal_Filter::Execute(scgms::IDevice_Event* event)
 		return rc;
 	}
 
-	CSimulation_Window* simwin = CSimulation_Window::Get_Instance();
+	// publish only what GUI does not know yet; when the ring is full, the item is not marked as published,
+	// so it gets another chance with next event of the same signal/segment, and the executor is never blocked
+	std::unique_lock<std::mutex> lck(mProducer_Mtx);
 
-	if (raw_event->signal_id != Invalid_GUID) {
-		simwin->Add_Signal(raw_event->signal_id);
+	if (raw_event->signal_id != Invalid_GUID && mPublished_Signals.find(raw_event->signal_id) == mPublished_Signals.end()) {
+		if (mEvents.Push({ raw_event->event_code, raw_event->signal_id, raw_event->segment_id }))
+			mPublished_Signals.insert(raw_event->signal_id);
 	}
 
 	if (raw_event->event_code == scgms::NDevice_Event_Code::Time_Segment_Start) {
-		simwin->Start_Time_Segment(raw_event->segment_id);
+		if (mPublished_Segments.find(raw_event->segment_id) == mPublished_Segments.end()) {
+			if (mEvents.Push({ raw_event->event_code, Invalid_GUID, raw_event->segment_id }))
+				mPublished_Segments.insert(raw_event->segment_id);
+		}
 	}
-	else if (raw_event->event_code == scgms::NDevice_Event_Code::Shut_Down) {
-		simwin->Stop_Simulation();
+	else if (raw_event->event_code == scgms::NDevice_Event_Code::Time_Segment_Stop) {
+		if (mClosed_Segments.find(raw_event->segment_id) == mClosed_Segments.end())
+			mPending_Stops.insert(raw_event->segment_id);
 	}
 
+	// an unpublished stop would keep the segment's error metrics being recomputed for the rest of the run
+	while (!mPending_Stops.empty()) {
+		const uint64_t segment_id = *mPending_Stops.begin();
+		if (!mEvents.Push({ scgms::NDevice_Event_Code::Time_Segment_Stop, Invalid_GUID, segment_id }))
+			break;
+
+		mClosed_Segments.insert(segment_id);
+		mPending_Stops.erase(mPending_Stops.begin());
+	}
+
+	lck.unlock();
+
+	if (raw_event->event_code == scgms::NDevice_Event_Code::Shut_Down) {
+		CSimulation_Window* simwin = CSimulation_Window::Get_Instance();
+		if (simwin)
+			simwin->Stop_Simulation();
+	}
+
+	const double device_time = raw_event->device_time;
+
 	event->Release();
 
+	mGUI_Subchain.Notify_New_Data(device_time);
+
 	return S_OK;
 }
 
@@ -121,7 +163,7 @@ CSimulation_Window* CSimulation_Window::Show_Instance(refcnt::SReferenced<scgms:
 }
 
 CSimulation_Window::CSimulation_Window(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> configuration, QWidget *owner) : 
-	QMdiSubWindow{ owner }, mConfiguration(configuration), mTabWidget(nullptr) {
+	QMdiSubWindow{ owner }, mConfiguration(configuration), mTerminal_Events(Terminal_Events_Capacity), mTabWidget(nullptr) {
 	Setup_UI();
 
 	mStopButton->setEnabled(false);
@@ -229,6 +271,24 @@ void CSimulation_Window::Setup_UI() {
 		mDrawAtShutdownCheckBox = new QCheckBox(tr("Draw on shut-down only"));
 		miscLayout->addWidget(mDrawAtShutdownCheckBox);
 
+		QHBoxLayout* intervalLayout = new QHBoxLayout();
+		intervalLayout->addWidget(new QLabel(tr("Refresh interval [ms]")));
+		mUpdateIntervalSpinBox = new QSpinBox();
+		mUpdateIntervalSpinBox->setRange(static_cast<int>(GUI_Subchain_Min_Drawing_Update), static_cast<int>(GUI_Subchain_Max_Drawing_Update));
+		mUpdateIntervalSpinBox->setSingleStep(100);
+		mUpdateIntervalSpinBox->setValue(static_cast<int>(GUI_Subchain_Default_Drawing_Update));
+		intervalLayout->addWidget(mUpdateIntervalSpinBox);
+		miscLayout->addLayout(intervalLayout);
+
+		QHBoxLayout* budgetLayout = new QHBoxLayout();
+		budgetLayout->addWidget(new QLabel(tr("Refresh CPU budget [%]")));
+		mCPUBudgetSpinBox = new QSpinBox();
+		mCPUBudgetSpinBox->setRange(1, 100);
+		mCPUBudgetSpinBox->setValue(static_cast<int>(GUI_Subchain_Default_CPU_Budget));
+		mCPUBudgetSpinBox->setToolTip(tr("Refreshing slows down when it would take more of a single core than this"));
+		budgetLayout->addWidget(mCPUBudgetSpinBox);
+		miscLayout->addLayout(budgetLayout);
+
 		leftPanelLayout->addWidget(miscSettings, 0);
 	}
 
@@ -378,14 +438,16 @@ void CSimulation_Window::Setup_UI() {
 	connect(mSolveAndResetParamsButton, SIGNAL(clicked()), this, SLOT(On_Reset_And_Solve_Params()));
 	connect(mTabWidget, SIGNAL(currentChanged(int)), this, SLOT(On_Tab_Change(int)));
 	connect(mDrawAtShutdownCheckBox, SIGNAL(stateChanged(int)), this, SLOT(On_Draw_Shut_Down_State_Change(int)));
+	connect(mUpdateIntervalSpinBox, SIGNAL(valueChanged(int)), this, SLOT(On_Update_Interval_Change(int)));
+	connect(mCPUBudgetSpinBox, SIGNAL(valueChanged(int)), this, SLOT(On_CPU_Budget_Change(int)));
 
 	mTabWidget->tabBar()->setContextMenuPolicy(Qt::CustomContextMenu);
 	connect(mTabWidget->tabBar(), SIGNAL(customContextMenuRequested(const QPoint &)), SLOT(Show_Tab_Context_Menu(const QPoint &)));
 
 	// GUI asynchronous updaters
-	connect(this, SIGNAL(On_Start_Time_Segment(quint64)), this, SLOT(Slot_Start_Time_Segment(quint64)), Qt::QueuedConnection);
-	connect(this, SIGNAL(On_Add_Signal(QUuid)), this, SLOT(Slot_Add_Signal(QUuid)), Qt::QueuedConnection);
-	connect(this, SIGNAL(On_Update_Solver_Progress(QUuid)), this, SLOT(Slot_Update_Solver_Progress(QUuid)), Qt::QueuedConnection);
+	mTerminal_Events_Timer = new QTimer(this);
+	mTerminal_Events_Timer->setInterval(Terminal_Events_Drain_Interval);
+	connect(mTerminal_Events_Timer, SIGNAL(timeout()), this, SLOT(Slot_Drain_Terminal_Events()));
 	connect(this, SIGNAL(On_Shut_Down_Received()), this, SLOT(On_Stop()));
 }
 
@@ -424,11 +486,22 @@ void CSimulation_Window::Save_Tab_State(int index)
 	if (!widget)
 		return;
 
-	CAbstract_Simulation_Tab_Widget* cloned = widget->Clone();
-	if (!cloned)
-		return;
-
-	mTabWidget->addTab(cloned, mTabWidget->tabBar()->tabText(index) + dsSaved_State_Tab_Suffix);
+	// hidden drawings are rendered lazily, so make sure the saved state is the latest one; the tab is cloned once the updater
+	// gets to it, so the GUI does not wait for an update in progress
+	QPointer<CAbstract_Simulation_Tab_Widget> tab{ widget };
+	const QString title = mTabWidget->tabBar()->tabText(index) + dsSaved_State_Tab_Suffix;
+	mGUI_Filter_Subchain.Request_Render(Get_Drawing_Target(widget), [this, tab, title]() {
+		QMetaObject::invokeMethod(this, [this, tab, title]() {
+			if (!tab)
+				return;
+
+			CAbstract_Simulation_Tab_Widget* cloned = tab->Clone();
+			if (!cloned)
+				return;
+
+			mTabWidget->addTab(cloned, title);
+		}, Qt::QueuedConnection);
+	});
 }
 
 void CSimulation_Window::Update_Tab_View()
@@ -441,9 +514,47 @@ void CSimulation_Window::Update_Tab_View()
 	}
 }
 
+TDrawing_Target CSimulation_Window::Get_Drawing_Target(QWidget* tab) const
+{
+	TDrawing_Target target;
+
+	for (CDrawing_Tab_Widget* wg : mDrawingWidgets)
+	{
+		if (wg == tab)
+		{
+			target.kind = TDrawing_Target::NKind::Drawing;
+			target.type = wg->Get_Type();
+			return target;
+		}
+	}
+
+	for (size_t i = 0; i < mDrawing_v2_Widgets.size(); i++)
+	{
+		for (size_t j = 0; j < mDrawing_v2_Widgets[i].size(); j++)
+		{
+			if (mDrawing_v2_Widgets[i][j].first == tab)
+			{
+				target.kind = TDrawing_Target::NKind::Drawing_v2;
+				target.filter_index = i;
+				target.view_index = j;
+				return target;
+			}
+		}
+	}
+
+	// saved states and non-drawing tabs
+	return target;
+}
+
+void CSimulation_Window::Publish_Visible_Drawing()
+{
+	mGUI_Filter_Subchain.Set_Visible_Drawing(Get_Drawing_Target(mTabWidget->currentWidget()));
+}
+
 void CSimulation_Window::On_Tab_Change(int index)
 {
 	Update_Tab_View();
+	Publish_Visible_Drawing();
 }
 
 void CSimulation_Window::On_Draw_Shut_Down_State_Change(int state)
@@ -454,6 +565,16 @@ void CSimulation_Window::On_Draw_Shut_Down_State_Change(int state)
 		mGUI_Filter_Subchain.Set_Redraw_Mode(NRedraw_Mode::Shut_Down_Only);
 }
 
+void CSimulation_Window::On_Update_Interval_Change(int interval)
+{
+	mGUI_Filter_Subchain.Set_Update_Interval(static_cast<size_t>(interval));
+}
+
+void CSimulation_Window::On_CPU_Budget_Change(int percent)
+{
+	mGUI_Filter_Subchain.Set_CPU_Budget(static_cast<size_t>(percent));
+}
+
 void CSimulation_Window::resizeEvent(QResizeEvent* evt)
 {
 	QMdiSubWindow::resizeEvent(evt);
@@ -475,6 +596,8 @@ void CSimulation_Window::On_Start() {
 	}
 	mProgressBars.clear();
 	mBestMetricLabels.clear();
+	mSolverStatusLabels.clear();
+	mSolver_Progress.Clear();
 
 	QVBoxLayout* lay = dynamic_cast<QVBoxLayout*>(mProgressGroup->layout());
 	if (lay)
@@ -504,7 +627,8 @@ void CSimulation_Window::On_Start() {
 	if (lay)
 		lay->addStretch();
 
-	mTerminal_Filter = std::make_unique<CGUI_Terminal_Filter>();
+	mTerminal_Events.Clear();
+	mTerminal_Filter = std::make_unique<CGUI_Terminal_Filter>(mTerminal_Events, mGUI_Filter_Subchain);
 
 	// initialize and start filter holder, this will start filters
 	refcnt::Swstr_list error_description;
@@ -524,6 +648,8 @@ void CSimulation_Window::On_Start() {
 	mStopButton->setEnabled(true);
 	mStartButton->setEnabled(false);
 
+	mTerminal_Events_Timer->start();
+
 
 	// hide all signal solve actions
 	for (auto& action : mSignalSolveActions)
@@ -572,6 +698,9 @@ void CSimulation_Window::On_Start() {
 		// restore selected tab index
 		if (curIdx < mTabWidget->count())
 			mTabWidget->setCurrentIndex(curIdx);
+
+		// the index may not have changed, while the widget on it did
+		Publish_Visible_Drawing();
 	}
 }
 
@@ -607,6 +736,10 @@ void CSimulation_Window::On_Stop() {
 		mStopButton->setEnabled(false);
 	}
 
+	// executor is terminated, so pick up whatever the terminal filter managed to publish
+	mTerminal_Events_Timer->stop();
+	Slot_Drain_Terminal_Events();
+
 	mTerminal_Filter.reset();
 }
 
@@ -643,16 +776,8 @@ void CSimulation_Window::Update_Preferred_Drawing_Dimensions(size_t filterIdx, s
 	height = mTabWidget->currentWidget()->height() * 0.95;
 }
 
-void CSimulation_Window::Log_Callback(std::shared_ptr<refcnt::wstr_list> messages) {
-	refcnt::wstr_container **begin, **end;
-	if (messages) {
-		if (messages->get(&begin, &end) == S_OK) {
-			for (auto iter = begin; iter != end; iter++) {
-				mLogWidget->Log_Message(refcnt::WChar_Container_To_WString(*iter));
-			}
-		}
-	}
-
+void CSimulation_Window::Log_Callback(const QStringList& lines) {
+	mLogWidget->Log_Messages(lines);
 }
 
 void CSimulation_Window::Update_Solver_Progress(const GUID& solver, size_t progress, double bestMetric, scgms::TSolver_Status status)
@@ -661,24 +786,40 @@ void CSimulation_Window::Update_Solver_Progress(const GUID& solver, size_t progr
 	if (status == scgms::TSolver_Status::Disabled)
 		return;
 
-	mSolverProgress[solver] = { progress, bestMetric, status };
-	emit On_Update_Solver_Progress(GUID_To_QUuid(solver));
+	// unchanged progress is not republished, and any number of changes waits for a single flush
+	if (mSolver_Progress.Publish(solver, progress, bestMetric, status) && !mSolver_Progress_Pending.exchange(true))
+		QMetaObject::invokeMethod(this, "Slot_Update_Solver_Progress", Qt::QueuedConnection);
 }
 
-void CSimulation_Window::Slot_Update_Solver_Progress(QUuid solver)
+void CSimulation_Window::Slot_Update_Solver_Progress()
 {
-	const GUID solver_id = QUuid_To_GUID(solver);
+	// repaint at most once per frame; whatever gets published in the meantime is picked up by the deferred flush
+	const qint64 since_last_flush = mSolver_Progress_Last_Flush.isValid() ? mSolver_Progress_Last_Flush.elapsed() : Solver_Progress_Frame_Interval;
+	if (since_last_flush < Solver_Progress_Frame_Interval) {
+		QTimer::singleShot(Solver_Progress_Frame_Interval - static_cast<int>(since_last_flush), this, SLOT(Slot_Update_Solver_Progress()));
+		return;
+	}
 
-	auto itr = mProgressBars.find(solver_id);
+	// cleared before collecting, so that a record published during the collection schedules another flush
+	mSolver_Progress_Pending = false;
+	mSolver_Progress_Last_Flush.start();
 
-	const auto& solverProgress = mSolverProgress[solver_id];
+	for (const auto& record : mSolver_Progress.Collect(mSolver_Progress_Seen_Version))
+		Show_Solver_Progress(record);
+}
 
-	const size_t progress = solverProgress.progress;
-	const double bestMetric = solverProgress.bestMetric;
-	const scgms::TSolver_Status status = solverProgress.status;
+void CSimulation_Window::Show_Solver_Progress(const TSolver_Progress_Record& record)
+{
+	const GUID& solver_id = record.solver;
+
+	auto itr = mProgressBars.find(solver_id);
+
+	const size_t progress = record.progress;
+	const double bestMetric = record.best_metric;
+	const scgms::TSolver_Status status = record.status;
 
 	QString metricString = tr(dsBest_Metric_Label);
-	if (solverProgress.progress != Invalid_Value)
+	if (progress != Invalid_Value)
 		metricString = metricString.arg(bestMetric);
 	else
 		metricString = metricString.arg(dsBest_Metric_NotAvailable);
@@ -775,12 +916,32 @@ void CSimulation_Window::On_Select_Segments_None()
 		ctrl.second->Set_Checked(false);
 }
 
-void CSimulation_Window::Start_Time_Segment(uint64_t segmentId)
+void CSimulation_Window::Slot_Drain_Terminal_Events()
 {
-	emit On_Start_Time_Segment(segmentId);
+	// de-duplicate the batch first, so the widgets are touched just once per signal/segment
+	std::set<uint64_t> segment_ids, closed_segment_ids;
+	std::set<GUID> signal_ids;
+
+	mTerminal_Events.Drain([&segment_ids, &closed_segment_ids, &signal_ids](const TTerminal_Event_Summary& summary) {
+		if (summary.event_code == scgms::NDevice_Event_Code::Time_Segment_Start)
+			segment_ids.insert(summary.segment_id);
+		else if (summary.event_code == scgms::NDevice_Event_Code::Time_Segment_Stop)
+			closed_segment_ids.insert(summary.segment_id);
+		if (summary.signal_id != Invalid_GUID)
+			signal_ids.insert(summary.signal_id);
+	});
+
+	for (const auto segment_id : segment_ids)
+		Add_Time_Segment_Widget(segment_id);
+
+	for (const auto segment_id : closed_segment_ids)
+		mErrorsWidget->Close_Segment(segment_id);
+
+	for (const auto& signal_id : signal_ids)
+		Add_Signal_Widget(signal_id);
 }
 
-void CSimulation_Window::Slot_Start_Time_Segment(quint64 id)
+void CSimulation_Window::Add_Time_Segment_Widget(uint64_t id)
 {
 	auto itr = mSegmentWidgets.find(id);
 
@@ -789,6 +950,7 @@ void CSimulation_Window::Slot_Start_Time_Segment(quint64 id)
 		CTime_Segment_Group_Widget* grp = new CTime_Segment_Group_Widget(id);
 
 		mSegmentWidgets[id] = grp;
+		mErrorsWidget->Add_Segment(id);
 
 		QVBoxLayout* lay = dynamic_cast<QVBoxLayout*>(mSegmentsGroup->layout());
 		if (lay)
@@ -799,16 +961,8 @@ void CSimulation_Window::Slot_Start_Time_Segment(quint64 id)
 	}
 }
 
-void CSimulation_Window::Add_Signal(const GUID& signalId)
+void CSimulation_Window::Add_Signal_Widget(const GUID& signal_id)
 {
-	// possible narrowing conversion (fine, as QUuid internally matches GUID)
-	emit On_Add_Signal(GUID_To_QUuid(signalId));
-}
-
-void CSimulation_Window::Slot_Add_Signal(QUuid id)
-{
-	const GUID signal_id = QUuid_To_GUID(id);
-
 	// do not add special signal markers
 	if (signal_id == scgms::signal_All || signal_id == scgms::signal_Null)
 		return;
@@ -875,9 +1029,9 @@ void CSimulation_Window::Inject_Event(const scgms::NDevice_Event_Code &code, con
 	}
 }
 
-void CSimulation_Window::Update_Errors() {
+void CSimulation_Window::Update_Errors(const double device_time) {
 	if (mErrorsWidget)
-		mErrorsWidget->Refresh();
+		mErrorsWidget->Refresh(device_time);
 }
 
 void CSimulation_Window::Stop_Simulation() {
@@ -39,6 +39,8 @@
 #include <atomic>
 #include <vector>
 #include <memory>
+#include <set>
+#include <mutex>
 
 #include <QtCore/QSignalMapper>
 #include <QtWidgets/QMdiSubWindow>
@@ -48,6 +50,8 @@
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QSpinBox>
 #include <QtWidgets/QCheckBox>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
 
 #include <scgms/rtl/FilterLib.h>
 #include <scgms/rtl/UILib.h>
@@ -59,9 +63,20 @@
 #include "helpers/Time_Segment_Group_Widget.h"
 #include "helpers/Signal_Group_Widget.h"
 #include "helpers/gui_subchain.h"
+#include "helpers/solver_progress_channel.h"
+#include "../utils/spsc_ring.h"
 
 class CGUI_Terminal_Filter;
 
+/*
+ * Compact summary of an event passed from the terminal filter to the GUI thread
+ */
+struct TTerminal_Event_Summary {
+	scgms::NDevice_Event_Code event_code = scgms::NDevice_Event_Code::Nothing;
+	GUID signal_id = Invalid_GUID;
+	uint64_t segment_id = scgms::Invalid_Segment_Id;
+};
+
 /*
  * Simulation control and results window
  */
@@ -93,6 +108,10 @@ class CSimulation_Window : public QMdiSubWindow {
 		int mBase_Tab_Count = 0;
 
 		std::unique_ptr<CGUI_Terminal_Filter> mTerminal_Filter;
+		// event summaries produced by terminal filter, drained periodically by GUI thread
+		CSPSC_Ring<TTerminal_Event_Summary> mTerminal_Events;
+		// timer for draining terminal filter event summaries
+		QTimer* mTerminal_Events_Timer = nullptr;
 		
 	protected:					
 		// tab widget for filter outputs
@@ -115,16 +134,19 @@ class CSimulation_Window : public QMdiSubWindow {
 
 		// checkbox for drawing at the end of simulation
 		QCheckBox* mDrawAtShutdownCheckBox;
+		// GUI update interval in [ms] and the share of a core the updates may take
+		QSpinBox* mUpdateIntervalSpinBox;
+		QSpinBox* mCPUBudgetSpinBox;
 
-		typedef struct {
-			size_t progress;
-			double bestMetric;
-			scgms::TSolver_Status status;
-		} TProgress_Status_Internal;
+		// solver progress published by the updater thread; GUI shows only the records changed since the version it saw last
+		CSolver_Progress_Channel mSolver_Progress;
+		uint64_t mSolver_Progress_Seen_Version = 0;
+		// a flush of the channel is scheduled in the GUI thread
+		std::atomic<bool> mSolver_Progress_Pending{ false };
+		QElapsedTimer mSolver_Progress_Last_Flush;
 
 		std::map<GUID, QProgressBar*> mProgressBars;
 		std::map<GUID, QLabel*> mSolverStatusLabels;
-		std::map<GUID, TProgress_Status_Internal> mSolverProgress;
 		std::map<GUID, QLabel*> mBestMetricLabels;
 		std::map<uint64_t, CTime_Segment_Group_Widget*> mSegmentWidgets;
 		std::map<GUID, CSignal_Group_Widget*> mSignalWidgets;
@@ -138,14 +160,18 @@ class CSimulation_Window : public QMdiSubWindow {
 		void resizeEvent(QResizeEvent* evt) override;
 
 		void Update_Tab_View();
+		// tells the GUI subchain which drawing the given tab displays, if any
+		TDrawing_Target Get_Drawing_Target(QWidget* tab) const;
+		void Publish_Visible_Drawing();
 
 		void Close_Tab(int index);
 		void Save_Tab_State(int index);
 
+		void Add_Time_Segment_Widget(uint64_t segmentId);
+		void Add_Signal_Widget(const GUID& signalId);
+		void Show_Solver_Progress(const TSolver_Progress_Record& record);
+
 	signals:
-		void On_Start_Time_Segment(quint64 id);
-		void On_Add_Signal(QUuid id);
-		void On_Update_Solver_Progress(QUuid solver);
 		void On_Shut_Down_Received();
 
 	protected slots:
@@ -164,11 +190,12 @@ class CSimulation_Window : public QMdiSubWindow {
 
 		void Show_Tab_Context_Menu(const QPoint &point);
 
-		void Slot_Start_Time_Segment(quint64 id);
-		void Slot_Add_Signal(QUuid id);
-		void Slot_Update_Solver_Progress(QUuid solver);
+		void Slot_Drain_Terminal_Events();
+		void Slot_Update_Solver_Progress();
 
 		void On_Draw_Shut_Down_State_Change(int state);
+		void On_Update_Interval_Change(int interval);
+		void On_CPU_Budget_Change(int percent);
 
 	protected:
 		void Inject_Event(const scgms::NDevice_Event_Code &code, const GUID &signal_id, const wchar_t *info, const uint64_t segment_id = scgms::Invalid_Segment_Id);
@@ -188,14 +215,11 @@ class CSimulation_Window : public QMdiSubWindow {
 		void Drawing_v2_Callback(size_t filterIdx, size_t drawingIdx, const std::string& svg);
 		void Update_Preferred_Drawing_Dimensions(size_t filterIdx, size_t drawingIdx, int& width, int& height);
 
-		void Log_Callback(std::shared_ptr<refcnt::wstr_list> messages);
+		void Log_Callback(const QStringList& lines);
 		void Update_Solver_Progress(const GUID& solver, size_t progress, double bestMetric, scgms::TSolver_Status status);
-		void Update_Errors();
+		void Update_Errors(const double device_time);
 		void Update_Solver_Progress();
 
-		void Start_Time_Segment(uint64_t segmentId);
-		void Add_Signal(const GUID& signalId);		
-		
 		void Stop_Simulation();
 };
 
@@ -204,7 +228,24 @@ class CSimulation_Window : public QMdiSubWindow {
 
 class CGUI_Terminal_Filter : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced
 {
+	protected:
+		// ring to publish event summaries to
+		CSPSC_Ring<TTerminal_Event_Summary>& mEvents;
+		// subchain to wake up when new data passed through the chain
+		CGUI_Filter_Subchain& mGUI_Subchain;
+		// the ring takes a single producer, but events are executed both by the chain and by the GUI thread injecting
+		// its own ones (e.g.; solve or reset requests), so the producer side and the sets below are guarded by this
+		std::mutex mProducer_Mtx;
+		// signals and segments already published during this run
+		std::set<GUID> mPublished_Signals;
+		std::set<uint64_t> mPublished_Segments;
+		std::set<uint64_t> mClosed_Segments;
+		// stops that did not fit into the ring; no other stop of the segment comes, so they are retried with every event
+		std::set<uint64_t> mPending_Stops;
+
 	public:
+		CGUI_Terminal_Filter(CSPSC_Ring<TTerminal_Event_Summary>& events, CGUI_Filter_Subchain& gui_subchain);
+
 		HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description) override;
 		HRESULT IfaceCalling Execute(scgms::IDevice_Event* event) override;
 };
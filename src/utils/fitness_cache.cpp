@@ -0,0 +1,165 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "fitness_cache.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// quantization step, as a fraction of the range between the bounds of a parameter
+constexpr double Fitness_Cache_Resolution = 1e-7;
+
+namespace {
+	// FNV-1a, stable across runs and platforms
+	constexpr uint64_t FNV_Offset = 14695981039346656037ULL;
+	constexpr uint64_t FNV_Prime = 1099511628211ULL;
+
+	uint64_t Hash_Bytes(uint64_t hash, const void* data, const size_t size) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= FNV_Prime;
+		}
+
+		return hash;
+	}
+}
+
+size_t CFitness_Cache::TKey_Hash::operator()(const TKey& key) const {
+	const uint64_t hash = Hash_Bytes(key.problem_hash, key.quantized.data(), key.quantized.size() * sizeof(int64_t));
+	return static_cast<size_t>(hash);
+}
+
+CFitness_Cache::CFitness_Cache(const size_t capacity_bytes) : mCapacity(capacity_bytes) {
+	//
+}
+
+size_t CFitness_Cache::Entry_Bytes(const TKey& key) {
+	// node of the map with its links and the cached hash, bucket pointer and the queue pointer
+	constexpr size_t overhead = 4 * sizeof(void*);
+	return sizeof(TKey) + key.quantized.capacity() * sizeof(int64_t) + sizeof(solver::TFitness) + overhead;
+}
+
+uint64_t CFitness_Cache::Hash_Problem(const std::vector<std::wstring>& parameter_names) {
+	uint64_t hash = FNV_Offset;
+	for (const auto& name : parameter_names) {
+		hash = Hash_Bytes(hash, name.data(), name.size() * sizeof(wchar_t));
+		// separator, so that the names cannot run into each other
+		hash = Hash_Bytes(hash, "", 1);
+	}
+
+	return hash;
+}
+
+CFitness_Cache::TKey CFitness_Cache::Make_Key(const uint64_t problem_hash, const double* values, const double* lower_bound, const double* upper_bound, const size_t count) {
+	TKey key;
+	key.problem_hash = problem_hash;
+	key.quantized.resize(count);
+
+	for (size_t i = 0; i < count; i++) {
+		const double range = upper_bound[i] - lower_bound[i];
+		if (range > 0.0 && std::isfinite(range)) {
+			key.quantized[i] = static_cast<int64_t>(std::llround((values[i] - lower_bound[i]) / (range * Fitness_Cache_Resolution)));
+		}
+		else {
+			// fixed (or unbounded) parameter - only the very same value matches
+			std::memcpy(&key.quantized[i], &values[i], sizeof(double));
+		}
+	}
+
+	return key;
+}
+
+bool CFitness_Cache::Lookup(const TKey& key, solver::TFitness& fitness) {
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		auto itr = mEntries.find(key);
+		if (itr != mEntries.end()) {
+			fitness = itr->second;
+			lck.unlock();
+
+			mHits++;
+			return true;
+		}
+	}
+
+	mMisses++;
+	return false;
+}
+
+void CFitness_Cache::Store(const TKey& key, const solver::TFitness& fitness) {
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	const auto inserted = mEntries.emplace(key, fitness);
+	if (!inserted.second)
+		return;
+
+	mOrder.push_back(&inserted.first->first);
+	mSize += Entry_Bytes(inserted.first->first);
+
+	while (mSize > mCapacity && !mOrder.empty()) {
+		auto oldest = mEntries.find(*mOrder.front());
+		mOrder.pop_front();
+
+		mSize -= Entry_Bytes(oldest->first);
+		mEntries.erase(oldest);
+	}
+}
+
+void CFitness_Cache::Clear() {
+	std::unique_lock<std::mutex> lck(mMtx);
+	mEntries.clear();
+	mOrder.clear();
+	mSize = 0;
+
+	mHits = 0;
+	mMisses = 0;
+}
+
+size_t CFitness_Cache::Hits() const {
+	return mHits;
+}
+
+size_t CFitness_Cache::Misses() const {
+	return mMisses;
+}
+
+double CFitness_Cache::Hit_Rate() const {
+	const size_t hits = mHits;
+	const size_t total = hits + mMisses;
+	return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : std::numeric_limits<double>::quiet_NaN();
+}
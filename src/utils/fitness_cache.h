@@ -0,0 +1,101 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/SolverIface.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Memoized fitness of parameter vectors
+ * Vectors are quantized to a fraction of their bounds' range, so the near-identical ones share the fitness;
+ * the names of the optimized parameters are a part of the key, so one cache cannot mix up different problems
+ * The cache is bounded by the memory its entries take, as the keys grow with the number of parameters
+ */
+class CFitness_Cache {
+	public:
+		struct TKey {
+			uint64_t problem_hash = 0;
+			std::vector<int64_t> quantized;
+
+			bool operator==(const TKey& other) const {
+				return problem_hash == other.problem_hash && quantized == other.quantized;
+			}
+		};
+
+	protected:
+		struct TKey_Hash {
+			size_t operator()(const TKey& key) const;
+		};
+
+		// in bytes
+		const size_t mCapacity;
+		size_t mSize = 0;
+
+		mutable std::mutex mMtx;
+		std::unordered_map<TKey, solver::TFitness, TKey_Hash> mEntries;
+		// insertion order, the oldest entries are evicted first; the keys are owned by mEntries, whose nodes never move
+		std::deque<const TKey*> mOrder;
+
+		// memory taken by an entry, including the estimated overhead of the map and of the queue
+		static size_t Entry_Bytes(const TKey& key);
+
+		std::atomic<size_t> mHits{ 0 };
+		std::atomic<size_t> mMisses{ 0 };
+
+	public:
+		explicit CFitness_Cache(const size_t capacity_bytes = 128 << 20);
+
+		// identifies the problem by the names of the parameters being optimized
+		static uint64_t Hash_Problem(const std::vector<std::wstring>& parameter_names);
+		static TKey Make_Key(const uint64_t problem_hash, const double* values, const double* lower_bound, const double* upper_bound, const size_t count);
+
+		// counts a hit or a miss
+		bool Lookup(const TKey& key, solver::TFitness& fitness);
+		void Store(const TKey& key, const solver::TFitness& fitness);
+		void Clear();
+
+		size_t Hits() const;
+		size_t Misses() const;
+		// hits out of all the lookups, NaN when there was none
+		double Hit_Rate() const;
+};
@@ -0,0 +1,95 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <vector>
+
+/*
+ * Fixed-capacity history of samples; once full, every new sample overwrites the oldest one, so the memory
+ * does not grow no matter how many samples are pushed
+ * Not thread-safe, the owner guards it
+ */
+template <typename T>
+class CHistory_Ring {
+	protected:
+		std::vector<T> mSamples;
+		size_t mCapacity;
+		// index of the slot the next sample goes to; valid only once the ring is full
+		size_t mNext = 0;
+
+	public:
+		explicit CHistory_Ring(const size_t capacity) : mCapacity(capacity > 0 ? capacity : 1) {
+			//
+		}
+
+		void Push(const T& sample) {
+			if (mSamples.size() < mCapacity) {
+				mSamples.push_back(sample);
+				return;
+			}
+
+			mSamples[mNext] = sample;
+			mNext = (mNext + 1) % mCapacity;
+		}
+
+		size_t Size() const {
+			return mSamples.size();
+		}
+
+		size_t Capacity() const {
+			return mCapacity;
+		}
+
+		// i-th sample, oldest first
+		const T& operator[](const size_t i) const {
+			return mSamples.size() < mCapacity ? mSamples[i] : mSamples[(mNext + i) % mCapacity];
+		}
+
+		// samples, oldest first
+		std::vector<T> To_Vector() const {
+			std::vector<T> result;
+			result.reserve(mSamples.size());
+			for (size_t i = 0; i < mSamples.size(); i++)
+				result.push_back((*this)[i]);
+			return result;
+		}
+
+		void Clear() {
+			mSamples.clear();
+			mNext = 0;
+		}
+};
@@ -0,0 +1,184 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "log_spill_file.h"
+
+#include <QtCore/QDir>
+
+#include <algorithm>
+
+// how many segments are kept mapped at once
+constexpr size_t Max_Mapped_Segments = 8;
+
+CLog_Spill_File::~CLog_Spill_File() {
+	for (const auto& mapping : mMappings)
+		Unmap(mapping);
+}
+
+bool CLog_Spill_File::Open() {
+	if (mOpened)
+		return true;
+
+	const QString name_template = QDir::tempPath() + QStringLiteral("/scgms_log_XXXXXX");
+	mText_File.setFileTemplate(name_template + QStringLiteral(".txt"));
+	mIndex_File.setFileTemplate(name_template + QStringLiteral(".idx"));
+
+	mOpened = mText_File.open() && mIndex_File.open();
+	return mOpened;
+}
+
+bool CLog_Spill_File::Append_Segment(const QStringList& lines) {
+	if (lines.isEmpty())
+		return true;
+
+	if (!Open())
+		return false;
+
+	QByteArray text;
+	std::vector<uint32_t> starts;
+	starts.reserve(static_cast<size_t>(lines.size()) + 1);
+
+	for (const auto& line : lines) {
+		starts.push_back(static_cast<uint32_t>(text.size()));
+		text.append(line.toUtf8());
+		text.append('\n');
+	}
+	starts.push_back(static_cast<uint32_t>(text.size()));
+
+	TSegment segment;
+	segment.text_offset = mText_File.size();
+	segment.text_size = text.size();
+	segment.index_offset = mIndex_File.size();
+	segment.first_line = mLine_Count;
+	segment.line_count = static_cast<size_t>(lines.size());
+
+	const qint64 index_size = static_cast<qint64>(starts.size() * sizeof(uint32_t));
+
+	if (!mText_File.seek(segment.text_offset) || mText_File.write(text) != segment.text_size
+		|| !mIndex_File.seek(segment.index_offset) || mIndex_File.write(reinterpret_cast<const char*>(starts.data()), index_size) != index_size) {
+
+		// drop whatever got written, so the files stay consistent with the segment list
+		mText_File.resize(segment.text_offset);
+		mIndex_File.resize(segment.index_offset);
+		return false;
+	}
+
+	mText_File.flush();
+	mIndex_File.flush();
+
+	mSegments.push_back(segment);
+	mLine_Count += segment.line_count;
+
+	return true;
+}
+
+size_t CLog_Spill_File::Line_Count() const {
+	return mLine_Count;
+}
+
+const CLog_Spill_File::TMapping* CLog_Spill_File::Map_Segment(const size_t segment) const {
+	auto itr = std::find_if(mMappings.begin(), mMappings.end(), [segment](const TMapping& mapping) { return mapping.segment == segment; });
+	if (itr != mMappings.end()) {
+		std::rotate(itr, itr + 1, mMappings.end());
+		return &mMappings.back();
+	}
+
+	const TSegment& desc = mSegments[segment];
+
+	TMapping mapping;
+	mapping.segment = segment;
+	mapping.text = mText_File.map(desc.text_offset, desc.text_size);
+	mapping.index = mIndex_File.map(desc.index_offset, static_cast<qint64>((desc.line_count + 1) * sizeof(uint32_t)));
+
+	if (!mapping.text || !mapping.index) {
+		Unmap(mapping);
+		return nullptr;
+	}
+
+	if (mMappings.size() >= Max_Mapped_Segments) {
+		Unmap(mMappings.front());
+		mMappings.erase(mMappings.begin());
+	}
+
+	mMappings.push_back(mapping);
+	return &mMappings.back();
+}
+
+void CLog_Spill_File::Unmap(const TMapping& mapping) const {
+	if (mapping.text)
+		mText_File.unmap(const_cast<uchar*>(mapping.text));
+	if (mapping.index)
+		mIndex_File.unmap(const_cast<uchar*>(mapping.index));
+}
+
+QString CLog_Spill_File::Line(const size_t index) const {
+	if (index >= mLine_Count)
+		return QString();
+
+	const auto segment = std::upper_bound(mSegments.begin(), mSegments.end(), index, [](const size_t line, const TSegment& seg) {
+		return line < seg.first_line;
+	}) - 1;
+
+	const TMapping* mapping = Map_Segment(static_cast<size_t>(std::distance(mSegments.begin(), segment)));
+	if (!mapping)
+		return QString();
+
+	// index offsets are multiples of 4 and the map keeps their alignment
+	const uint32_t* starts = reinterpret_cast<const uint32_t*>(mapping->index);
+	const size_t local = index - segment->first_line;
+	const uint32_t begin = starts[local];
+	const uint32_t end = starts[local + 1] - 1;	// without the line terminator
+
+	return QString::fromUtf8(reinterpret_cast<const char*>(mapping->text) + begin, static_cast<int>(end - begin));
+}
+
+bool CLog_Spill_File::Write_To(QIODevice& target) const {
+	if (!mOpened)
+		return true;
+
+	constexpr qint64 Block_Size = 1 << 20;
+
+	if (!mText_File.seek(0))
+		return false;
+
+	while (!mText_File.atEnd()) {
+		const QByteArray block = mText_File.read(Block_Size);
+		if (block.isEmpty() || target.write(block) != block.size())
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,99 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <QtCore/QIODevice>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTemporaryFile>
+
+#include <vector>
+
+/*
+ * Append-only on-disk store of log lines, used to keep old lines of long simulations out of memory
+ * Lines are written in segments as UTF-8 text (one line per row, so the text file is a valid log as is) and
+ * an index of line starts; segments are memory-mapped on demand when a line of them is read back
+ */
+class CLog_Spill_File {
+	protected:
+		struct TSegment {
+			// position and size of the text of the segment in the text file
+			qint64 text_offset = 0;
+			qint64 text_size = 0;
+			// position of (line_count + 1) line starts, relative to text_offset, in the index file
+			qint64 index_offset = 0;
+			size_t first_line = 0;
+			size_t line_count = 0;
+		};
+
+		struct TMapping {
+			size_t segment = 0;
+			const uchar* text = nullptr;
+			const uchar* index = nullptr;
+		};
+
+		mutable QTemporaryFile mText_File;
+		mutable QTemporaryFile mIndex_File;
+		bool mOpened = false;
+
+		std::vector<TSegment> mSegments;
+		size_t mLine_Count = 0;
+
+		// recently read segments, most recently used last
+		mutable std::vector<TMapping> mMappings;
+
+		bool Open();
+		const TMapping* Map_Segment(const size_t segment) const;
+		void Unmap(const TMapping& mapping) const;
+
+	public:
+		CLog_Spill_File() = default;
+		~CLog_Spill_File();
+
+		CLog_Spill_File(const CLog_Spill_File&) = delete;
+		CLog_Spill_File& operator=(const CLog_Spill_File&) = delete;
+
+		// writes the lines as a new segment; returns false (and stores nothing) if the disk cannot be used
+		bool Append_Segment(const QStringList& lines);
+
+		size_t Line_Count() const;
+		// reads the line back, mapping its segment if needed
+		QString Line(const size_t index) const;
+
+		// copies all the stored lines to target, as they are
+		bool Write_To(QIODevice& target) const;
+};
@@ -0,0 +1,115 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <limits>
+
+/*
+ * Bounded single-producer single-consumer lock-free ring buffer
+ * Push is called from exactly one thread at a time (the producer), Drain from exactly one thread at a time (the consumer);
+ * when the ring is full, Push fails instead of blocking, so the producer is never stalled by a slow consumer
+ */
+template <typename T>
+class CSPSC_Ring {
+	protected:
+		std::vector<T> mSlots;
+		const size_t mMask;
+
+		// index of the next slot to be read; written only by consumer
+		alignas(64) std::atomic<size_t> mHead{ 0 };
+		// index of the next slot to be written; written only by producer
+		alignas(64) std::atomic<size_t> mTail{ 0 };
+
+		static size_t Round_Up_To_Power_Of_Two(size_t value) {
+			size_t result = 1;
+			while (result < value)
+				result <<= 1;
+			return result;
+		}
+
+	public:
+		explicit CSPSC_Ring(const size_t capacity) : mSlots(Round_Up_To_Power_Of_Two(capacity)), mMask(mSlots.size() - 1) {
+			//
+		}
+
+		CSPSC_Ring(const CSPSC_Ring&) = delete;
+		CSPSC_Ring& operator=(const CSPSC_Ring&) = delete;
+
+		// producer side; returns false if the ring is full and the item was not stored
+		bool Push(const T& item) {
+			const size_t tail = mTail.load(std::memory_order_relaxed);
+			if (tail - mHead.load(std::memory_order_acquire) > mMask)
+				return false;
+
+			mSlots[tail & mMask] = item;
+			mTail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// consumer side; calls consumer(const T&) for at most max_count items, returns number of items drained
+		template <typename TConsumer>
+		size_t Drain(TConsumer&& consumer, const size_t max_count = std::numeric_limits<size_t>::max()) {
+			size_t head = mHead.load(std::memory_order_relaxed);
+			const size_t tail = mTail.load(std::memory_order_acquire);
+
+			size_t count = 0;
+			while (head != tail && count < max_count) {
+				consumer(mSlots[head & mMask]);
+				head++;
+				count++;
+			}
+
+			mHead.store(head, std::memory_order_release);
+			return count;
+		}
+
+		bool Empty() const {
+			return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+		}
+
+		size_t Capacity() const {
+			return mSlots.size();
+		}
+
+		// may be called only when neither producer nor consumer is active
+		void Clear() {
+			mHead.store(0, std::memory_order_relaxed);
+			mTail.store(0, std::memory_order_relaxed);
+		}
+};
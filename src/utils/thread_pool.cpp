@@ -0,0 +1,147 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace {
+	// pool and queue index of the worker running on this thread; used to keep nested submissions local
+	thread_local const CThread_Pool* Current_Pool = nullptr;
+	thread_local size_t Current_Worker_Index = 0;
+}
+
+CThread_Pool::CThread_Pool(size_t thread_count) {
+	if (thread_count == 0)
+		thread_count = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1));
+
+	for (size_t i = 0; i < thread_count; i++)
+		mQueues.push_back(std::make_unique<TWorker_Queue>());
+
+	for (size_t i = 0; i < thread_count; i++)
+		mWorkers.emplace_back(&CThread_Pool::Worker, this, i);
+}
+
+CThread_Pool::~CThread_Pool() {
+	{
+		std::unique_lock<std::mutex> lck(mWake_Mtx);
+		mStop = true;
+	}
+	mWake_Cv.notify_all();
+
+	// workers finish all the pending tasks before they exit
+	for (auto& worker : mWorkers) {
+		if (worker.joinable())
+			worker.join();
+	}
+}
+
+size_t CThread_Pool::Thread_Count() const {
+	return mWorkers.size();
+}
+
+void CThread_Pool::Enqueue(std::function<void()>&& task) {
+	const size_t index = (Current_Pool == this) ? Current_Worker_Index : (mNext_Queue++ % mQueues.size());
+
+	{
+		// taking the lock guarantees the wake-up is not lost between the predicate check and the wait;
+		// counted before the push, so that a worker picking the task right away never sees the counter underflow
+		std::unique_lock<std::mutex> lck(mWake_Mtx);
+		mPending++;
+	}
+
+	{
+		std::unique_lock<std::mutex> lck(mQueues[index]->mtx);
+		mQueues[index]->tasks.push_back(std::move(task));
+	}
+
+	mWake_Cv.notify_one();
+}
+
+bool CThread_Pool::Pop_Task(const size_t worker_index, std::function<void()>& task) {
+	// own queue first, newest task - its data are most likely still in cache
+	{
+		auto& own = *mQueues[worker_index];
+		std::unique_lock<std::mutex> lck(own.mtx);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	// steal the oldest task of someone else
+	for (size_t i = 1; i < mQueues.size(); i++) {
+		auto& victim = *mQueues[(worker_index + i) % mQueues.size()];
+		std::unique_lock<std::mutex> lck(victim.mtx, std::try_to_lock);
+		if (lck.owns_lock() && !victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CThread_Pool::Worker(const size_t worker_index) {
+	Current_Pool = this;
+	Current_Worker_Index = worker_index;
+
+	while (true) {
+		std::function<void()> task;
+		if (Pop_Task(worker_index, task)) {
+			mPending--;
+			task();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lck(mWake_Mtx);
+		if (mStop && mPending == 0)
+			break;
+
+		mWake_Cv.wait(lck, [this]() { return mStop || mPending > 0; });
+		if (mStop && mPending == 0)
+			break;
+	}
+
+	Current_Pool = nullptr;
+}
+
+CThread_Pool& Get_Shared_Thread_Pool() {
+	static CThread_Pool pool;
+	return pool;
+}
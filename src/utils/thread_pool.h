@@ -0,0 +1,101 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Work-stealing thread pool
+ * Every worker owns a task queue; a worker pops its own queue from the back and, when it is empty,
+ * steals from the front of other workers' queues, so the cores stay busy even when the task lengths differ a lot
+ */
+class CThread_Pool {
+	protected:
+		struct TWorker_Queue {
+			std::mutex mtx;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		std::vector<std::unique_ptr<TWorker_Queue>> mQueues;
+		std::vector<std::thread> mWorkers;
+
+		// sleeping workers wait here for a new task or for the pool shutdown
+		std::mutex mWake_Mtx;
+		std::condition_variable mWake_Cv;
+		bool mStop = false;
+
+		// number of tasks submitted, but not yet picked by any worker
+		std::atomic<size_t> mPending{ 0 };
+		// round-robin queue index for tasks submitted from outside of the pool
+		std::atomic<size_t> mNext_Queue{ 0 };
+
+		void Enqueue(std::function<void()>&& task);
+		bool Pop_Task(const size_t worker_index, std::function<void()>& task);
+		void Worker(const size_t worker_index);
+
+	public:
+		// thread_count of zero sizes the pool to the number of hardware threads
+		explicit CThread_Pool(size_t thread_count = 0);
+		virtual ~CThread_Pool();
+
+		CThread_Pool(const CThread_Pool&) = delete;
+		CThread_Pool& operator=(const CThread_Pool&) = delete;
+
+		size_t Thread_Count() const;
+
+		template <typename F>
+		auto Submit(F&& fnc) -> std::future<decltype(fnc())> {
+			using TResult = decltype(fnc());
+
+			auto task = std::make_shared<std::packaged_task<TResult()>>(std::forward<F>(fnc));
+			auto result = task->get_future();
+			Enqueue([task]() { (*task)(); });
+
+			return result;
+		}
+};
+
+// process-wide pool for short CPU-bound tasks; never block its workers on other tasks of the same pool
+CThread_Pool& Get_Shared_Thread_Pool();